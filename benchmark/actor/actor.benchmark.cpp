@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/thread_pool.hpp>
+
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class Receiver {
+public:
+    Receiver(ActorRef<Receiver>) {
+    }
+
+    void receive(int) {
+        ++received;
+    }
+
+    void receiveString(std::string value) {
+        received += value.size();
+    }
+
+    void flush(std::promise<void> promise) {
+        promise.set_value();
+    }
+
+    std::size_t received = 0;
+};
+
+class Player {
+public:
+    Player(ActorRef<Player>) {
+    }
+
+    void setPartner(ActorRef<Player> partner_, std::promise<void> done_) {
+        partner = std::make_unique<ActorRef<Player>>(std::move(partner_));
+        done = std::move(done_);
+    }
+
+    void ball(int remaining) {
+        if (remaining == 0) {
+            done.set_value();
+        } else {
+            partner->invoke(&Player::ball, remaining - 1);
+        }
+    }
+
+private:
+    std::unique_ptr<ActorRef<Player>> partner;
+    std::promise<void> done;
+};
+
+void flush(Actor<Receiver>& actor) {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    actor.invoke(&Receiver::flush, std::move(promise));
+    future.wait();
+}
+
+} // end namespace
+
+// One producer thread sending small messages to a single actor, like a stream of
+// `setPlacementConfig` messages to a tile worker.
+static void Actor_SingleProducer(::benchmark::State& state) {
+    const int messages = 10000;
+    ThreadPool pool(1);
+    Actor<Receiver> receiver(pool);
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < messages; ++i) {
+            receiver.invoke(&Receiver::receive, i);
+        }
+        flush(receiver);
+    }
+
+    state.SetItemsProcessed(state.iterations() * messages);
+}
+
+// Several producer threads sending to a single actor; exercises contention on push.
+static void Actor_MultipleProducers(::benchmark::State& state) {
+    const int producers = state.range_x();
+    const int messages = 10000;
+    ThreadPool pool(1);
+    Actor<Receiver> receiver(pool);
+
+    while (state.KeepRunning()) {
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < messages; ++i) {
+                    receiver.invoke(&Receiver::receive, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        flush(receiver);
+    }
+
+    state.SetItemsProcessed(state.iterations() * producers * messages);
+}
+
+// Messages carrying heap-allocated arguments, like `setData` / `setLayers`.
+static void Actor_LargeMessages(::benchmark::State& state) {
+    const int messages = 10000;
+    const std::string payload(256, 'x');
+    ThreadPool pool(1);
+    Actor<Receiver> receiver(pool);
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < messages; ++i) {
+            receiver.invoke(&Receiver::receiveString, payload);
+        }
+        flush(receiver);
+    }
+
+    state.SetItemsProcessed(state.iterations() * messages);
+}
+
+// Two actors bouncing a message back and forth; measures end-to-end message latency.
+static void Actor_PingPong(::benchmark::State& state) {
+    const int bounces = 10000;
+    ThreadPool pool(2);
+    Actor<Player> ping(pool);
+    Actor<Player> pong(pool);
+
+    while (state.KeepRunning()) {
+        std::promise<void> pingDone;
+        std::promise<void> pongDone;
+        std::future<void> pingFuture = pingDone.get_future();
+        std::future<void> pongFuture = pongDone.get_future();
+
+        ping.invoke(&Player::setPartner, pong.self(), std::move(pingDone));
+        pong.invoke(&Player::setPartner, ping.self(), std::move(pongDone));
+        ping.invoke(&Player::ball, bounces);
+
+        // Whichever player receives the final bounce fulfils its promise.
+        if (bounces % 2 == 0) {
+            pingFuture.wait();
+        } else {
+            pongFuture.wait();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * bounces);
+}
+
+BENCHMARK(Actor_SingleProducer)->UseRealTime();
+BENCHMARK(Actor_MultipleProducers)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(Actor_LargeMessages)->UseRealTime();
+BENCHMARK(Actor_PingPong)->UseRealTime();
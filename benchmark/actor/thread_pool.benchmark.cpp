@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/thread_pool.hpp>
+#include <mbgl/actor/work_stealing_thread_pool.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Signals a promise once a fixed number of work items have been processed.
+class Countdown {
+public:
+    Countdown(int64_t count) : remaining(count) {}
+
+    void decrement() {
+        if (--remaining == 0) {
+            promise.set_value();
+        }
+    }
+
+    void wait() {
+        promise.get_future().wait();
+    }
+
+private:
+    std::atomic<int64_t> remaining;
+    std::promise<void> promise;
+};
+
+class Counter {
+public:
+    Counter(ActorRef<Counter>, Countdown& countdown_)
+        : countdown(countdown_) {
+    }
+
+    void receive(int) {
+        countdown.decrement();
+    }
+
+private:
+    Countdown& countdown;
+};
+
+class Parser {
+public:
+    Parser(ActorRef<Parser>, Countdown& countdown_)
+        : countdown(countdown_) {
+    }
+
+    void parse(std::shared_ptr<const std::string> data) {
+        // Layer names of the mapbox-streets-v7 + mapbox-terrain-v2 fixture tiles.
+        static const char* layerNames[] = {
+            "contour", "landuse", "barrier_line", "building", "landuse_overlay", "road",
+            "place_label", "rail_station_label", "poi_label", "road_label"
+        };
+
+        VectorTileData tile(std::move(data));
+        std::size_t vertices = 0;
+        for (const auto& name : layerNames) {
+            if (auto layer = tile.getLayer(name)) {
+                for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                    auto feature = layer->getFeature(i);
+                    ::benchmark::DoNotOptimize(feature->getProperties());
+                    for (const auto& ring : feature->getGeometries()) {
+                        vertices += ring.size();
+                    }
+                }
+            }
+        }
+        ::benchmark::DoNotOptimize(vertices);
+        countdown.decrement();
+    }
+
+private:
+    Countdown& countdown;
+};
+
+} // end namespace
+
+// Sends many small messages to a set of actors; measures raw scheduling overhead.
+template <class Pool>
+static void Actor_MailboxThroughput(::benchmark::State& state) {
+    const std::size_t actorCount = 64;
+    const int messagesPerActor = 256;
+
+    Pool pool(state.range_x());
+
+    while (state.KeepRunning()) {
+        Countdown countdown(actorCount * messagesPerActor);
+
+        std::vector<std::unique_ptr<Actor<Counter>>> actors;
+        for (std::size_t i = 0; i < actorCount; ++i) {
+            actors.emplace_back(std::make_unique<Actor<Counter>>(pool, std::ref(countdown)));
+        }
+
+        for (int i = 0; i < messagesPerActor; ++i) {
+            for (auto& actor : actors) {
+                actor->invoke(&Counter::receive, i);
+            }
+        }
+
+        countdown.wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * actorCount * messagesPerActor);
+}
+
+// Parses a batch of vector tiles, one actor per tile, as a geometry tile worker would;
+// the reported time is the latency until the whole batch has been parsed.
+template <class Pool>
+static void Actor_TileParseLatency(::benchmark::State& state) {
+    const std::size_t tileCount = 64;
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+
+    Pool pool(state.range_x());
+
+    while (state.KeepRunning()) {
+        Countdown countdown(tileCount);
+
+        std::vector<std::unique_ptr<Actor<Parser>>> actors;
+        for (std::size_t i = 0; i < tileCount; ++i) {
+            actors.emplace_back(std::make_unique<Actor<Parser>>(pool, std::ref(countdown)));
+        }
+
+        for (std::size_t i = 0; i < tileCount; ++i) {
+            actors[i]->invoke(&Parser::parse, tiles[i % tiles.size()]);
+        }
+
+        countdown.wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * tileCount);
+}
+
+#define THREAD_COUNTS ->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime()
+
+BENCHMARK_TEMPLATE(Actor_MailboxThroughput, ThreadPool) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(Actor_MailboxThroughput, WorkStealingThreadPool) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(Actor_TileParseLatency, ThreadPool) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(Actor_TileParseLatency, WorkStealingThreadPool) THREAD_COUNTS;
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+// Renders the 4 × 4 block of 256 pixel z16 tiles of Manhattan in metatiles of the argument
+// size; a size of 1 renders every tile separately.
+static void API_renderStillTiles(::benchmark::State& state) {
+    const auto size = uint16_t(state.range_x());
+    const uint8_t z = 16;
+    const uint32_t x = 19296;
+    const uint32_t y = 24636;
+    const uint16_t block = 4;
+
+    util::RunLoop loop;
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+
+    DefaultFileSource fileSource("benchmark/fixtures/api/cache.db", ".");
+    fileSource.setAccessToken("foobar");
+
+    auto display = std::make_shared<HeadlessDisplay>();
+    HeadlessView view(display, 1, size * 256, size * 256);
+    Map map(view, fileSource, MapMode::Still);
+    map.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+
+    auto render = [&] (uint32_t tileX, uint32_t tileY) {
+        map.renderStillTiles(z, tileX, tileY, size, 256, [&](std::exception_ptr error, std::vector<PremultipliedImage> tiles) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            ::benchmark::DoNotOptimize(tiles);
+            loop.stop();
+        });
+        loop.run();
+    };
+
+    auto renderBlock = [&] {
+        for (uint32_t row = 0; row < block; row += size) {
+            for (uint32_t column = 0; column < block; column += size) {
+                render(x + column, y + row);
+            }
+        }
+    };
+
+    // Loads the tiles once beforehand, so that all arguments measure rendering alone.
+    renderBlock();
+
+    int64_t tiles = 0;
+    while (state.KeepRunning()) {
+        renderBlock();
+        tiles += block * block;
+    }
+
+    state.SetItemsProcessed(tiles);
+}
+
+BENCHMARK(API_renderStillTiles)->Arg(1)->Arg(2)->Arg(4);
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/render_pool.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <sys/resource.h>
+
+using namespace mbgl;
+
+namespace {
+
+// The peak resident set size of the process, in kilobytes.
+long peakMemoryUsage() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+} // end namespace
+
+// Renders batches of still images of Manhattan with a pool of the argument number of maps.
+// The label shows the peak memory usage of the process so far divided by the number of maps.
+static void API_renderPoolStill(::benchmark::State& state) {
+    const auto size = std::size_t(state.range_x());
+
+    util::RunLoop loop;
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+
+    DefaultFileSource fileSource("benchmark/fixtures/api/cache.db", ".");
+    fileSource.setAccessToken("foobar");
+
+    auto display = std::make_shared<HeadlessDisplay>();
+    RenderPool pool(fileSource, size, [display] {
+        return std::make_unique<HeadlessView>(display, 1, 512, 512);
+    });
+    pool.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+
+    const std::size_t batch = 16;
+    int64_t renders = 0;
+
+    while (state.KeepRunning()) {
+        std::size_t remaining = batch;
+        for (std::size_t i = 0; i < batch; i++) {
+            CameraOptions camera;
+            camera.center = LatLng { 40.726989 + 0.001 * (i / 4), -73.992857 + 0.001 * (i % 4) };
+            camera.zoom = 15;
+            pool.renderStill(camera, [&](std::exception_ptr error, PremultipliedImage&&) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            });
+        }
+
+        loop.run();
+        renders += batch;
+    }
+
+    state.SetItemsProcessed(renders);
+    state.SetLabel(util::toString(peakMemoryUsage() / int64_t(size)) + " kB RSS per map");
+}
+
+BENCHMARK(API_renderPoolStill)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
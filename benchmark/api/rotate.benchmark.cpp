@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class RotateBenchmark {
+public:
+    RotateBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        map.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+        map.setLatLngZoom({ 40.726989, -73.992857 }, 15); // Manhattan
+
+        auto decoded = decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png"));
+        auto image = std::make_unique<SpriteImage>(std::move(decoded), 1.0);
+        map.addImage("test-icon", std::move(image));
+
+        view.resize(1000, 1000);
+
+        mbgl::benchmark::render(map);
+    }
+
+    util::RunLoop loop;
+    std::shared_ptr<HeadlessDisplay> display{ std::make_shared<HeadlessDisplay>() };
+    HeadlessView view{ display, 1 };
+    DefaultFileSource fileSource{ "benchmark/fixtures/api/cache.db", "." };
+    Map map{ view, fileSource, MapMode::Still };
+};
+
+} // end namespace
+
+// Renders a frame for every degree of a full turn, so that every frame needs a new placement.
+static void API_renderRotation(::benchmark::State& state) {
+    RotateBenchmark bench;
+    double bearing = 0;
+
+    while (state.KeepRunning()) {
+        bearing = bearing >= 359 ? 0 : bearing + 1;
+        bench.map.setBearing(bearing);
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+// Rotates back and forth between a few bearings, as a user adjusting the bearing would.
+// Tiles reuse their earlier placements for these instead of placing symbols again.
+static void API_renderRotationBackAndForth(::benchmark::State& state) {
+    RotateBenchmark bench;
+    const double bearings[] = { 0, 10, 20, 10 };
+    std::size_t frame = 0;
+
+    while (state.KeepRunning()) {
+        bench.map.setBearing(bearings[frame++ % 4]);
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+BENCHMARK(API_renderRotation);
+BENCHMARK(API_renderRotationBackAndForth);
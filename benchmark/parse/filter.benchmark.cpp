@@ -2,6 +2,7 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -9,6 +10,9 @@
 
 #include <rapidjson/document.h>
 
+#include <utility>
+#include <vector>
+
 using namespace mbgl;
 
 style::Filter parse(const char* expression) {
@@ -37,5 +41,72 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+static void Parse_EvaluateCompiledFilter(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(R"FILTER(["==", "foo", "bar"])FILTER"));
+    const PropertyMap properties = { { "foo", std::string("bar") } };
+
+    while (state.KeepRunning()) {
+        filter(FeatureType::Unknown, {}, [&] (const std::string& key) -> optional<Value> {
+            auto it = properties.find(key);
+            if (it == properties.end())
+                return {};
+            return it->second;
+        });
+    }
+}
+
+// A filter typical of a road layer in a streets style, evaluated against a set of features
+// with differing properties and geometry types.
+static const char* roadFilter = R"FILTER(["all",
+    ["==", "$type", "LineString"],
+    ["!in", "structure", "bridge", "tunnel"],
+    ["in", "class", "motorway", "trunk", "primary", "secondary", "tertiary"],
+    [">=", "rank", 2],
+    ["<", "rank", 8]
+])FILTER";
+
+static const std::vector<std::pair<FeatureType, PropertyMap>>& roadFeatures() {
+    static const std::vector<std::pair<FeatureType, PropertyMap>> features = {
+        { FeatureType::LineString, { { "class", std::string("primary") }, { "rank", int64_t(4) } } },
+        { FeatureType::LineString, { { "class", std::string("street") }, { "rank", int64_t(9) } } },
+        { FeatureType::LineString, { { "class", std::string("motorway") }, { "structure", std::string("bridge") } } },
+        { FeatureType::LineString, { { "class", std::string("tertiary") }, { "rank", uint64_t(2) }, { "oneway", true } } },
+        { FeatureType::Polygon, { { "class", std::string("primary") }, { "rank", double(3) } } },
+        { FeatureType::LineString, { { "class", std::string("trunk") }, { "rank", int64_t(1) } } },
+    };
+    return features;
+}
+
+template <class Evaluator>
+static void evaluateRoadFilter(benchmark::State& state, const Evaluator& filter) {
+    const auto& features = roadFeatures();
+    std::size_t matches = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            matches += filter(feature.first, {}, [&] (const std::string& key) -> optional<Value> {
+                auto it = feature.second.find(key);
+                if (it == feature.second.end())
+                    return {};
+                return it->second;
+            });
+        }
+    }
+
+    benchmark::DoNotOptimize(matches);
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+static void Parse_EvaluateRoadFilter(benchmark::State& state) {
+    evaluateRoadFilter(state, parse(roadFilter));
+}
+
+static void Parse_EvaluateCompiledRoadFilter(benchmark::State& state) {
+    evaluateRoadFilter(state, style::CompiledFilter(parse(roadFilter)));
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateCompiledFilter);
+BENCHMARK(Parse_EvaluateRoadFilter);
+BENCHMARK(Parse_EvaluateCompiledRoadFilter);
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/tile_layer_filter.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+
+namespace {
+
+// Layers of the mapbox-streets-v7 fixture tiles with filters typical of a streets style.
+const struct {
+    const char* layer;
+    const char* filter;
+} layerFilters[] = {
+    { "road", R"(["all", ["==", "$type", "LineString"], ["in", "class", "motorway", "trunk", "primary"]])" },
+    { "road", R"(["all", ["!=", "structure", "tunnel"], ["==", "class", "street"]])" },
+    { "landuse", R"(["==", "class", "park"])" },
+    { "building", R"(["!=", "underground", "true"])" },
+    { "poi_label", R"(["all", ["<=", "scalerank", 2], ["has", "name"]])" },
+};
+
+style::Filter parseFilter(const char* expression) {
+    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
+    doc.Parse<0>(expression);
+    return *style::conversion::convert<style::Filter>(doc);
+}
+
+} // end namespace
+
+// Decodes the properties of every feature of every layer, as querying rendered features does.
+static void Parse_VectorTileProperties(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    std::size_t features = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& tile : tiles) {
+            VectorTileData data(tile);
+            for (const auto& layerFilter : layerFilters) {
+                if (auto layer = data.getLayer(layerFilter.layer)) {
+                    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                        ::benchmark::DoNotOptimize(layer->getFeature(i)->getProperties());
+                        features++;
+                    }
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(features);
+}
+
+// Filters every feature by looking up its properties by name, one feature at a time.
+static void Parse_VectorTileFilterEvaluator(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    std::size_t features = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& tile : tiles) {
+            VectorTileData data(tile);
+            for (const auto& layerFilter : layerFilters) {
+                const style::Filter filter = parseFilter(layerFilter.filter);
+                if (auto layer = data.getLayer(layerFilter.layer)) {
+                    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                        auto feature = layer->getFeature(i);
+                        ::benchmark::DoNotOptimize(filter(feature->getType(), feature->getID(), [&] (const std::string& key) {
+                            return feature->getValue(key);
+                        }));
+                        features++;
+                    }
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(features);
+}
+
+// Filters every feature through the layer's property columns.
+static void Parse_VectorTileLayerFilter(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    std::size_t features = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& tile : tiles) {
+            VectorTileData data(tile);
+            for (const auto& layerFilter : layerFilters) {
+                const style::Filter filter = parseFilter(layerFilter.filter);
+                if (auto layer = data.getLayer(layerFilter.layer)) {
+                    style::TileLayerFilter tileLayerFilter(filter, *layer);
+                    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                        auto feature = layer->getFeature(i);
+                        ::benchmark::DoNotOptimize(tileLayerFilter(i, *feature));
+                        features++;
+                    }
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(features);
+}
+
+BENCHMARK(Parse_VectorTileProperties);
+BENCHMARK(Parse_VectorTileFilterEvaluator);
+BENCHMARK(Parse_VectorTileLayerFilter);
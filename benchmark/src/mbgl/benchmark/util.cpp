@@ -1,9 +1,12 @@
 #include <mbgl/benchmark/util.hpp>
 
 #include <mbgl/map/map.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <sqlite3.hpp>
+
 namespace mbgl {
 namespace benchmark {
 
@@ -18,5 +21,20 @@ void render(Map& map) {
     }
 }
 
+const std::vector<std::shared_ptr<const std::string>>& fixtureTiles() {
+    static const auto tiles = [] {
+        std::vector<std::shared_ptr<const std::string>> result;
+        mapbox::sqlite::Database db("benchmark/fixtures/api/cache.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = db.prepare("SELECT data, compressed FROM tiles");
+        while (stmt.run()) {
+            const std::string data = stmt.get<std::string>(0);
+            result.push_back(std::make_shared<std::string>(
+                stmt.get<int>(1) ? util::decompress(data) : data));
+        }
+        return result;
+    }();
+    return tiles;
+}
+
 } // namespace benchmark
 } // namespace mbgl
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace mbgl {
 
 class Map;
@@ -8,5 +12,8 @@ namespace benchmark {
 
 void render(Map&);
 
+// The decompressed vector tiles of the benchmark/fixtures/api offline cache.
+const std::vector<std::shared_ptr<const std::string>>& fixtureTiles();
+
 } // namespace benchmark
 } // namespace mbgl
@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/string.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string databasePath = "benchmark/fixtures/api/offline.db";
+
+void deleteDatabase() {
+    for (const char* suffix : { "", "-journal", "-wal", "-shm" }) {
+        try {
+            util::deleteFile(databasePath + suffix);
+        } catch (util::IOException&) {
+        }
+    }
+}
+
+// Stores a synthetic region of `state.range_x()` tiles, with the data of the fixture tiles,
+// committing `state.range_y()` tiles per transaction.
+void putRegionTiles(::benchmark::State& state, bool writeAheadLogging) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    const auto tileCount = state.range_x();
+    std::size_t written = 0;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        deleteDatabase();
+        auto db = std::make_unique<OfflineDatabase>(databasePath);
+        db->setWriteBatching(state.range_y(), Seconds(1));
+        db->setWriteAheadLogging(writeAheadLogging);
+        OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::world(), 0, 17, 1.0 };
+        OfflineRegion region = db->createRegion(definition, OfflineRegionMetadata());
+        state.ResumeTiming();
+
+        for (int i = 0; i < tileCount; i++) {
+            Response response;
+            response.data = tiles[i % tiles.size()];
+            db->putRegionResource(region.getID(),
+                Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, i % 1024, i / 1024, 17, Tileset::Scheme::XYZ),
+                response);
+        }
+        db->commitWrites();
+
+        written += tileCount;
+
+        state.PauseTiming();
+        db.reset();
+        state.ResumeTiming();
+    }
+
+    deleteDatabase();
+    state.SetItemsProcessed(written);
+}
+
+} // end namespace
+
+// Stores fixture tiles as ambient cache entries in a cache of 4 MB, which fills up quickly.
+// With `state.range_x()` set, the cache is evicted from incrementally after every 16 puts, as
+// the file source does when it is idle, rather than only by puts that would exceed it. The
+// label is the longest time a single put spent evicting.
+static void Storage_AmbientCachePuts(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    const bool incremental = state.range_x();
+
+    deleteDatabase();
+    OfflineDatabase db(databasePath, 4 * 1024 * 1024);
+    db.setIncrementalEviction(incremental);
+    db.setWriteAheadLogging(true);
+
+    std::size_t written = 0;
+    while (state.KeepRunning()) {
+        Response response;
+        response.data = tiles[written % tiles.size()];
+        db.put(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, written % 1024, written / 1024, 17, Tileset::Scheme::XYZ),
+               response);
+
+        if (++written % 16 == 0 && incremental) {
+            state.PauseTiming();
+            while (db.evictIncrementally(Milliseconds(10))) {
+            }
+            state.ResumeTiming();
+        }
+    }
+
+    const OfflineEvictionStats stats = db.getEvictionStats();
+    state.SetLabel("max put eviction " +
+        util::toString(std::chrono::duration<double, std::milli>(stats.maxPutEvictionTime).count()) + " ms");
+    state.SetItemsProcessed(written);
+    deleteDatabase();
+}
+
+// Looks up the fixture tiles, cached as ambient tiles. Each hit writes its access time at
+// once or, with `state.range_x()` set, the access times are kept in memory for up to five
+// seconds and written together.
+static void Storage_CachedTileReads(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+
+    deleteDatabase();
+    OfflineDatabase db(databasePath);
+
+    std::vector<Resource> resources;
+    for (uint32_t i = 0; i < tiles.size(); i++) {
+        resources.push_back(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, i, 0, 17, Tileset::Scheme::XYZ));
+        Response response;
+        response.data = tiles[i];
+        db.put(resources.back(), response);
+    }
+
+    db.setAccessBatching(state.range_x() ? Seconds(5) : Duration::zero());
+
+    std::size_t reads = 0;
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(db.get(resources[reads++ % resources.size()]));
+    }
+
+    db.flushAccesses();
+    state.SetItemsProcessed(reads);
+    deleteDatabase();
+}
+
+static void Storage_OfflineRegionWrites(::benchmark::State& state) {
+    putRegionTiles(state, false);
+}
+
+static void Storage_OfflineRegionWritesWAL(::benchmark::State& state) {
+    putRegionTiles(state, true);
+}
+
+// Items per second are tiles stored per second. Writing one tile per transaction syncs the
+// disk for every tile, so it is measured on a smaller region.
+#define WRITE_BATCHES ->ArgPair(1000, 1)->ArgPair(100000, 256)->ArgPair(100000, 4096)->UseRealTime()
+
+BENCHMARK(Storage_OfflineRegionWrites) WRITE_BATCHES;
+BENCHMARK(Storage_OfflineRegionWritesWAL) WRITE_BATCHES;
+BENCHMARK(Storage_AmbientCachePuts)->Arg(0)->Arg(1);
+BENCHMARK(Storage_CachedTileReads)->Arg(0)->Arg(1)->UseRealTime();
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Candidate regions of about 20 by 20 km around the world, for zoom levels 0 to 14.
+std::vector<OfflineTilePyramidRegionDefinition> candidateRegions() {
+    std::vector<OfflineTilePyramidRegionDefinition> regions;
+    for (int lat = -60; lat < 60; lat += 10) {
+        for (int lng = -180; lng < 180; lng += 10) {
+            regions.emplace_back("mapbox://styles/mapbox/streets-v9",
+                                 LatLngBounds::hull({ lat + 0.0, lng + 0.0 }, { lat + 0.2, lng + 0.2 }),
+                                 0, 14, 1.0);
+        }
+    }
+    return regions;
+}
+
+} // end namespace
+
+// The argument is whether regions are sized with OfflineRegionSizeEstimator rather than
+// by enumerating their tiles.
+static void Storage_OfflineRegionSizing(::benchmark::State& state) {
+    const bool estimate = state.range_x();
+
+    const auto regions = candidateRegions();
+    const OfflineRegionSizeEstimator estimator({ { 0, 50000 }, { 8, 30000 }, { 14, 20000 } });
+    std::size_t sized = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& region : regions) {
+            if (estimate) {
+                auto result = estimator.estimate(region, SourceType::Vector, 512, { 0, 22 });
+                ::benchmark::DoNotOptimize(result);
+            } else {
+                auto count = region.tileCover(SourceType::Vector, 512, { 0, 22 }).size();
+                ::benchmark::DoNotOptimize(count);
+            }
+            sized++;
+        }
+    }
+
+    state.SetItemsProcessed(sized);
+}
+
+BENCHMARK(Storage_OfflineRegionSizing)->Arg(0)->Arg(1);
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace mbgl;
+
+namespace {
+
+// A local HTTP server that answers every request with a small body after a delay, like a
+// busy tile server. Each connection is served on a thread of its own.
+class MockHTTPServer {
+public:
+    explicit MockHTTPServer(Duration delay_) : delay(delay_) {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+
+        socklen_t length = sizeof(address);
+        if (listener == -1 ||
+            bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+            listen(listener, 128) == -1 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == -1) {
+            throw std::runtime_error("failed to start the mock HTTP server");
+        }
+        port = ntohs(address.sin_port);
+
+        std::thread([this] {
+            int connection;
+            while ((connection = accept(listener, nullptr, nullptr)) != -1) {
+                std::thread(&MockHTTPServer::serve, this, connection).detach();
+            }
+        }).detach();
+    }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + util::toString(port) + path;
+    }
+
+private:
+    void serve(int connection) const {
+        static const std::string response =
+            "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: 4\r\n\r\ntile";
+
+        std::string received;
+        char buffer[4096];
+        ssize_t size;
+        while ((size = recv(connection, buffer, sizeof(buffer), 0)) > 0) {
+            received.append(buffer, size);
+
+            std::size_t end;
+            while ((end = received.find("\r\n\r\n")) != std::string::npos) {
+                received.erase(0, end + 4);
+                std::this_thread::sleep_for(delay);
+                if (send(connection, response.data(), response.size(), 0) == -1) {
+                    break;
+                }
+            }
+        }
+        close(connection);
+    }
+
+    const Duration delay;
+    int listener;
+    uint16_t port;
+};
+
+MockHTTPServer& server() {
+    static MockHTTPServer* instance = new MockHTTPServer(Milliseconds(10));
+    return *instance;
+}
+
+} // end namespace
+
+// The time until the response to a glyphs request arrives, when it is made after the argument
+// number of low priority tile requests, such as those of an offline download, are waiting for
+// the network.
+static void Storage_QueuedRequestLatency(::benchmark::State& state) {
+    const int64_t queued = state.range_x();
+
+    util::RunLoop loop;
+    OnlineFileSource fs;
+    uint64_t batch = 0;
+
+    while (state.KeepRunning()) {
+        const std::string prefix = "/" + util::toString(batch++) + "/";
+
+        std::vector<std::unique_ptr<AsyncRequest>> requests;
+        for (int64_t i = 0; i < queued; i++) {
+            Resource tile { Resource::Tile, server().url(prefix + "tiles/" + util::toString(i)) };
+            tile.priority = Resource::Priority::Low;
+            requests.push_back(fs.request(tile, [] (Response) {}));
+        }
+
+        std::unique_ptr<AsyncRequest> glyphs =
+            fs.request({ Resource::Glyphs, server().url(prefix + "glyphs") }, [&] (Response) {
+                loop.stop();
+            });
+
+        loop.run();
+
+        state.PauseTiming();
+        requests.clear();
+        glyphs.reset();
+        state.ResumeTiming();
+    }
+}
+
+BENCHMARK(Storage_QueuedRequestLatency)->Arg(0)->Arg(100)->Arg(1000)->UseRealTime();
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string archivePath = "benchmark/fixtures/api/tiles.archive";
+const std::string databasePath = "benchmark/fixtures/api/tiles.db";
+const std::string urlTemplate = "http://example.com/{z}/{x}/{y}.pbf";
+
+// The fixture tiles, stored as the tiles of one zoom level.
+constexpr uint8_t zoom = 10;
+
+Resource tileResource(uint32_t i) {
+    return Resource::tile(urlTemplate, 1.0, i % 1024, i / 1024, zoom, Tileset::Scheme::XYZ);
+}
+
+} // end namespace
+
+static void Storage_TileArchiveGet(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+
+    std::vector<TileArchive::Tile> archiveTiles;
+    for (uint32_t i = 0; i < tiles.size(); i++) {
+        archiveTiles.push_back({ zoom, i % 1024, i / 1024, *tiles[i] });
+    }
+    TileArchive::write(archivePath, std::move(archiveTiles));
+
+    std::size_t read = 0;
+    {
+        TileArchive archive(archivePath);
+        while (state.KeepRunning()) {
+            for (uint32_t i = 0; i < tiles.size(); i++) {
+                auto data = archive.get(zoom, i % 1024, i / 1024);
+                auto response = std::make_shared<std::string>(data->data, data->size);
+                ::benchmark::DoNotOptimize(response);
+                read++;
+            }
+        }
+    }
+
+    util::deleteFile(archivePath);
+    state.SetItemsProcessed(read);
+}
+
+static void Storage_OfflineDatabaseGet(::benchmark::State& state) {
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+
+    std::size_t read = 0;
+    {
+        OfflineDatabase db(databasePath);
+        for (uint32_t i = 0; i < tiles.size(); i++) {
+            Response response;
+            response.data = tiles[i];
+            db.put(tileResource(i), response);
+        }
+
+        while (state.KeepRunning()) {
+            for (uint32_t i = 0; i < tiles.size(); i++) {
+                ::benchmark::DoNotOptimize(db.get(tileResource(i)));
+                read++;
+            }
+        }
+    }
+
+    util::deleteFile(databasePath);
+    state.SetItemsProcessed(read);
+}
+
+// Items per second are tiles read per second, from the page cache once warm.
+BENCHMARK(Storage_TileArchiveGet);
+BENCHMARK(Storage_OfflineDatabaseGet);
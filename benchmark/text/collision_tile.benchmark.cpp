@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+const char* labelLayers[] = { "place_label", "poi_label", "road_label", "water_label" };
+
+// Collision features for the labeled features of the fixture tiles, with boxes about the size
+// of their names set in a 12px font.
+std::vector<CollisionFeature> collisionFeatures() {
+    std::vector<CollisionFeature> result;
+
+    for (const auto& tile : mbgl::benchmark::fixtureTiles()) {
+        VectorTileData data(tile);
+        for (const auto& layerName : labelLayers) {
+            auto layer = data.getLayer(layerName);
+            if (!layer) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                auto name = feature->getValue("name");
+                if (!name || !name->is<std::string>()) {
+                    continue;
+                }
+
+                const GeometryCollection geometries = feature->getGeometries();
+                if (geometries.empty() || geometries.front().empty()) {
+                    continue;
+                }
+
+                const GeometryCoordinates& line = geometries.front();
+                const bool isLine = feature->getType() == FeatureType::LineString && line.size() > 1;
+                const float halfWidth = name->get<std::string>().size() * 3.0f;
+
+                result.emplace_back(line, Anchor(line[0].x, line[0].y, 0, 0.5f, 0),
+                                    -6.0f, 6.0f, -halfWidth, halfWidth, 1.0f, 2.0f,
+                                    isLine ? style::SymbolPlacementType::Line : style::SymbolPlacementType::Point,
+                                    IndexedSubfeature { i, layerName, layerName, result.size() },
+                                    !isLine);
+            }
+        }
+    }
+
+    return result;
+}
+
+} // end namespace
+
+// Places all labels of the fixture tiles, as a layout or a placement at a new angle does.
+static void Text_CollisionTilePlacement(::benchmark::State& state) {
+    std::vector<CollisionFeature> features = collisionFeatures();
+    std::size_t placed = 0;
+    float angle = 0;
+
+    while (state.KeepRunning()) {
+        CollisionTile collisionTile(PlacementConfig(angle, 0.5f));
+
+        for (auto& feature : features) {
+            const float scale = collisionTile.placeFeature(feature, false, false);
+            collisionTile.insertFeature(feature, scale, false);
+        }
+
+        placed += features.size();
+        angle += M_PI / 90;
+    }
+
+    state.SetItemsProcessed(placed);
+}
+
+BENCHMARK(Text_CollisionTilePlacement);
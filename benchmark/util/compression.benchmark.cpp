@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+enum Mode {
+    Zlib,
+    Zstd,
+    ZstdDictionary,
+};
+
+util::Codec modeCodec(Mode mode) {
+    return mode == Zlib ? util::Codec::Zlib : util::Codec::Zstd;
+}
+
+// A dictionary trained on the fixture tiles themselves, as `OfflineDatabase::trainTileDictionary`
+// trains on the stored tiles.
+const util::CompressionDictionary* modeDictionary(Mode mode) {
+    if (mode != ZstdDictionary) {
+        return nullptr;
+    }
+
+    static const auto dictionary = [] {
+        std::vector<std::string> samples;
+        for (const auto& tile : mbgl::benchmark::fixtureTiles()) {
+            samples.push_back(*tile);
+        }
+        return std::make_unique<util::CompressionDictionary>(
+            util::CompressionDictionary::train(samples, 112640));
+    }();
+    return dictionary.get();
+}
+
+// Labels the result with the total compressed size relative to the raw fixture tiles.
+void setRatioLabel(::benchmark::State& state, std::size_t raw, std::size_t compressed) {
+    state.SetLabel("ratio " + util::toString(double(compressed) / raw));
+}
+
+} // end namespace
+
+static void Util_CompressTiles(::benchmark::State& state) {
+    const Mode mode = Mode(state.range_x());
+
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    const util::Codec codec = modeCodec(mode);
+    const util::CompressionDictionary* dictionary = modeDictionary(mode);
+    std::size_t raw = 0;
+    std::size_t compressed = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& tile : tiles) {
+            compressed += util::compress(*tile, codec, dictionary).size();
+            raw += tile->size();
+        }
+    }
+
+    state.SetBytesProcessed(raw);
+    setRatioLabel(state, raw, compressed);
+}
+
+static void Util_DecompressTiles(::benchmark::State& state) {
+    const Mode mode = Mode(state.range_x());
+
+    const auto& tiles = mbgl::benchmark::fixtureTiles();
+    const util::Codec codec = modeCodec(mode);
+    const util::CompressionDictionary* dictionary = modeDictionary(mode);
+
+    std::vector<std::string> compressedTiles;
+    for (const auto& tile : tiles) {
+        compressedTiles.push_back(util::compress(*tile, codec, dictionary));
+    }
+
+    std::size_t raw = 0;
+
+    while (state.KeepRunning()) {
+        for (const auto& compressed : compressedTiles) {
+            raw += util::decompress(compressed, codec, dictionary).size();
+        }
+    }
+
+    state.SetBytesProcessed(raw);
+}
+
+// Bytes per second are raw tile bytes. The argument is the codec: zlib, zstd, or zstd with a
+// trained dictionary.
+#if MBGL_USE_ZSTD
+#define CODECS ->Arg(Zlib)->Arg(Zstd)->Arg(ZstdDictionary)
+#else
+#define CODECS ->Arg(Zlib)
+#endif
+
+BENCHMARK(Util_CompressTiles) CODECS;
+BENCHMARK(Util_DecompressTiles) CODECS;
@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/image_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/premultiply.hpp>
+
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+const char* fixtures[] = {
+    "benchmark/fixtures/image/tile.png",
+    "benchmark/fixtures/image/tile.jpeg",
+    "benchmark/fixtures/image/tile.webp",
+    "benchmark/fixtures/image/sprite@2x.png",
+};
+
+} // end namespace
+
+// Decodes a 256 × 256 raster tile in each format, or a sprite sheet.
+static void Image_decode(::benchmark::State& state) {
+    const std::string path = fixtures[state.range_x()];
+    const std::string data = util::read_file(path);
+    int64_t pixels = 0;
+
+    while (state.KeepRunning()) {
+        PremultipliedImage image = decodeImage(data);
+        pixels += int64_t(image.width) * image.height;
+    }
+
+    state.SetLabel(path.substr(path.rfind('/') + 1));
+    state.SetItemsProcessed(pixels);
+}
+
+// Like Image_decode, but returns each image to a pool, as raster tiles do once uploaded, so
+// that every decode after the first reuses the same buffer.
+static void Image_decodePooled(::benchmark::State& state) {
+    const std::string path = fixtures[state.range_x()];
+    const std::string data = util::read_file(path);
+    util::ImagePool pool(1024 * 1024 * 4);
+    int64_t pixels = 0;
+
+    while (state.KeepRunning()) {
+        PremultipliedImage image = decodeImage(data, pool);
+        pixels += int64_t(image.width) * image.height;
+        pool.release(std::move(image));
+    }
+
+    state.SetLabel(path.substr(path.rfind('/') + 1));
+    state.SetItemsProcessed(pixels);
+}
+
+// Encodes a still render, taking the raster tile as its pixels.
+static void Image_encodePNG(::benchmark::State& state) {
+    const PremultipliedImage image = decodeImage(util::read_file(fixtures[0]));
+
+    int64_t pixels = 0;
+
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(encodePNG(image));
+        pixels += int64_t(image.width) * image.height;
+    }
+
+    state.SetItemsProcessed(pixels);
+}
+
+static void Image_premultiply(::benchmark::State& state) {
+    PremultipliedImage image = decodeImage(util::read_file(fixtures[3]));
+    const std::size_t pixels = std::size_t(image.width) * image.height;
+
+    int64_t processed = 0;
+
+    while (state.KeepRunning()) {
+        util::premultiply(image.data.get(), pixels);
+        processed += pixels;
+    }
+
+    state.SetItemsProcessed(processed);
+}
+
+static void Image_unpremultiply(::benchmark::State& state) {
+    PremultipliedImage image = decodeImage(util::read_file(fixtures[3]));
+    const std::size_t pixels = std::size_t(image.width) * image.height;
+
+    int64_t processed = 0;
+
+    while (state.KeepRunning()) {
+        util::unpremultiply(image.data.get(), pixels);
+        processed += pixels;
+    }
+
+    state.SetItemsProcessed(processed);
+}
+
+#if !defined(__ANDROID__) && !defined(__APPLE__)
+BENCHMARK(Image_decode)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+BENCHMARK(Image_decodePooled)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+#else
+BENCHMARK(Image_decode)->Arg(0)->Arg(1)->Arg(3);
+BENCHMARK(Image_decodePooled)->Arg(0)->Arg(1)->Arg(3);
+#endif
+BENCHMARK(Image_encodePNG);
+BENCHMARK(Image_premultiply);
+BENCHMARK(Image_unpremultiply);
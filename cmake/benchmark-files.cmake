@@ -1,14 +1,22 @@
 # Do not edit. Regenerate this with ./scripts/generate-benchmark-files.sh
 
 set(MBGL_BENCHMARK_FILES
+    # actor
+    benchmark/actor/actor.benchmark.cpp
+    benchmark/actor/thread_pool.benchmark.cpp
+
     # api
+    benchmark/api/metatile.benchmark.cpp
     benchmark/api/query.benchmark.cpp
+    benchmark/api/render_pool.benchmark.cpp
+    benchmark/api/rotate.benchmark.cpp
 
     # include/mbgl
     benchmark/include/mbgl/benchmark.hpp
 
     # parse
     benchmark/parse/filter.benchmark.cpp
+    benchmark/parse/vector_tile.benchmark.cpp
 
     # src
     benchmark/src/main.cpp
@@ -17,4 +25,17 @@ set(MBGL_BENCHMARK_FILES
     benchmark/src/mbgl/benchmark/benchmark.cpp
     benchmark/src/mbgl/benchmark/util.cpp
     benchmark/src/mbgl/benchmark/util.hpp
+
+    # storage
+    benchmark/storage/offline_database.benchmark.cpp
+    benchmark/storage/offline_region.benchmark.cpp
+    benchmark/storage/online_file_source.benchmark.cpp
+    benchmark/storage/tile_archive.benchmark.cpp
+
+    # text
+    benchmark/text/collision_tile.benchmark.cpp
+
+    # util
+    benchmark/util/compression.benchmark.cpp
+    benchmark/util/image.benchmark.cpp
 )
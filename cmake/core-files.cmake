@@ -7,9 +7,14 @@ set(MBGL_CORE_FILES
     src/mbgl/actor/mailbox.cpp
     src/mbgl/actor/mailbox.hpp
     src/mbgl/actor/message.hpp
+    src/mbgl/actor/message_pool.cpp
+    src/mbgl/actor/message_pool.hpp
     src/mbgl/actor/scheduler.hpp
     src/mbgl/actor/thread_pool.cpp
     src/mbgl/actor/thread_pool.hpp
+    src/mbgl/actor/work_stealing_deque.hpp
+    src/mbgl/actor/work_stealing_thread_pool.cpp
+    src/mbgl/actor/work_stealing_thread_pool.hpp
 
     # algorithm
     src/mbgl/algorithm/covered_by_children.hpp
@@ -97,10 +102,12 @@ set(MBGL_CORE_FILES
     include/mbgl/map/camera.hpp
     include/mbgl/map/map.hpp
     include/mbgl/map/mode.hpp
+    include/mbgl/map/render_pool.hpp
     include/mbgl/map/update.hpp
     include/mbgl/map/view.hpp
     src/mbgl/map/change.hpp
     src/mbgl/map/map.cpp
+    src/mbgl/map/render_pool.cpp
     src/mbgl/map/transform.cpp
     src/mbgl/map/transform.hpp
     src/mbgl/map/transform_state.cpp
@@ -231,6 +238,7 @@ set(MBGL_CORE_FILES
     src/mbgl/storage/network_status.cpp
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/response.cpp
+    src/mbgl/storage/tile_archive_file_source.hpp
 
     # style
     include/mbgl/style/conversion.hpp
@@ -248,6 +256,8 @@ set(MBGL_CORE_FILES
     src/mbgl/style/cascade_parameters.hpp
     src/mbgl/style/class_dictionary.cpp
     src/mbgl/style/class_dictionary.hpp
+    src/mbgl/style/compiled_filter.cpp
+    src/mbgl/style/compiled_filter.hpp
     src/mbgl/style/layer.cpp
     src/mbgl/style/layer_impl.cpp
     src/mbgl/style/layer_impl.hpp
@@ -269,6 +279,8 @@ set(MBGL_CORE_FILES
     src/mbgl/style/source_observer.hpp
     src/mbgl/style/style.cpp
     src/mbgl/style/style.hpp
+    src/mbgl/style/tile_layer_filter.cpp
+    src/mbgl/style/tile_layer_filter.hpp
     src/mbgl/style/tile_source_impl.cpp
     src/mbgl/style/tile_source_impl.hpp
     src/mbgl/style/types.cpp
@@ -349,6 +361,8 @@ set(MBGL_CORE_FILES
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.cpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -393,6 +407,7 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_observer.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
+    src/mbgl/tile/vector_tile_data.hpp
 
     # util
     include/mbgl/util/async_request.hpp
@@ -447,6 +462,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/http_header.hpp
     src/mbgl/util/http_timeout.cpp
     src/mbgl/util/http_timeout.hpp
+    src/mbgl/util/image_pool.cpp
+    src/mbgl/util/image_pool.hpp
     src/mbgl/util/interpolate.hpp
     src/mbgl/util/intersection_tests.cpp
     src/mbgl/util/intersection_tests.hpp
@@ -48,5 +48,11 @@ target_add_mason_package(mbgl-core PRIVATE protozero)
 
 mbgl_platform_core()
 
+if(WITH_ZSTD)
+    target_link_libraries(mbgl-core
+        PUBLIC -lzstd
+    )
+endif(WITH_ZSTD)
+
 create_source_groups(mbgl-core)
 target_append_xcconfig(mbgl-core)
@@ -4,6 +4,8 @@ set(MBGL_TEST_FILES
     # actor
     test/actor/actor.test.cpp
     test/actor/actor_ref.test.cpp
+    test/actor/thread_pool.test.cpp
+    test/actor/work_stealing_thread_pool.test.cpp
 
     # algorithm
     test/algorithm/covered_by_children.test.cpp
@@ -17,12 +19,14 @@ set(MBGL_TEST_FILES
     test/api/custom_layer.test.cpp
     test/api/query.test.cpp
     test/api/render_missing.test.cpp
+    test/api/render_pool.test.cpp
     test/api/repeated_render.test.cpp
 
     # geometry
     test/geometry/binpack.test.cpp
 
     # gl
+    test/gl/headless_view.test.cpp
     test/gl/object.test.cpp
 
     # include/mbgl
@@ -69,6 +73,10 @@ set(MBGL_TEST_FILES
     test/storage/offline_download.test.cpp
     test/storage/online_file_source.test.cpp
     test/storage/resource.test.cpp
+    test/storage/tile_archive.test.cpp
+
+    # style
+    test/style/compiled_filter.test.cpp
 
     # style/conversion
     test/style/conversion/geojson_options.test.cpp
@@ -80,23 +88,30 @@ set(MBGL_TEST_FILES
     test/style/style.test.cpp
     test/style/style_layer.test.cpp
     test/style/style_parser.test.cpp
+    test/style/tile_layer_filter.test.cpp
     test/style/tile_source.test.cpp
 
     # text
+    test/text/collision_grid.test.cpp
     test/text/glyph_atlas.test.cpp
+    test/text/placement_config.test.cpp
     test/text/quads.test.cpp
 
     # tile
     test/tile/geometry_tile_data.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_id.test.cpp
     test/tile/vector_tile.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/compression.test.cpp
     test/util/geo.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
+    test/util/image_pool.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
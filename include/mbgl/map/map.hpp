@@ -16,10 +16,12 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 namespace mbgl {
 
 class FileSource;
+class Scheduler;
 class View;
 class SpriteImage;
 struct CameraOptions;
@@ -37,6 +39,14 @@ public:
                  GLContextMode contextMode = GLContextMode::Unique,
                  ConstrainMode constrainMode = ConstrainMode::HeightOnly,
                  ViewportMode viewportMode = ViewportMode::Default);
+
+    // Processes tiles on the given scheduler, which may be shared with other maps and must
+    // outlive the map, rather than on worker threads of its own.
+    Map(View&, FileSource&, Scheduler& workerScheduler,
+        MapMode mapMode = MapMode::Continuous,
+        GLContextMode contextMode = GLContextMode::Unique,
+        ConstrainMode constrainMode = ConstrainMode::HeightOnly,
+        ViewportMode viewportMode = ViewportMode::Default);
     ~Map();
 
     // Register a callback that will get called (on the render thread) when all resources have
@@ -44,6 +54,14 @@ public:
     using StillImageCallback = std::function<void (std::exception_ptr, PremultipliedImage&&)>;
     void renderStill(StillImageCallback callback);
 
+    // Renders a metatile: the size × size block of tiles of tileSize pixels whose top left tile
+    // is z/x/y, as one still image split into one image per tile, ordered by row. The style is
+    // laid out, uploaded and placed once for the whole block rather than once per tile, so labels
+    // continue across the tile edges inside it. Moves the camera to the block, which must lie
+    // within the world; the view must be size × tileSize pixels square.
+    using StillTilesCallback = std::function<void (std::exception_ptr, std::vector<PremultipliedImage>)>;
+    void renderStillTiles(uint8_t z, uint32_t x, uint32_t y, uint16_t size, uint16_t tileSize, StillTilesCallback);
+
     // Main render function.
     void render();
 
@@ -179,6 +197,14 @@ public:
 
     // Memory
     void setSourceTileCacheSize(size_t);
+
+    // Limits the approximate memory held by tiles cached for reuse, across all sources of
+    // the style. 0 means no limit, which is the default.
+    void setTileCacheMemoryBudget(size_t bytes);
+
+    // Approximate memory held by cached tiles, in bytes, keyed by source ID.
+    std::unordered_map<std::string, size_t> getTileCacheMemoryUsage() const;
+
     void onLowMemory();
 
     // Debug
@@ -189,6 +215,11 @@ public:
     bool isFullyLoaded() const;
     void dumpDebugLogs() const;
 
+    // Time from the most recent style load, renderStill() request, or camera change that
+    // needed new tiles, to the first frame rendered after it with all tiles fully loaded.
+    // Empty until such a frame has been rendered.
+    optional<Duration> getTimeToFirstFullFrame() const;
+
 private:
     class Impl;
     const std::unique_ptr<Impl> impl;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class FileSource;
+class View;
+
+/*
+   Renders still images with a pool of maps in MapMode::Still, for services that render many
+   images. The maps share a file source, one set of worker threads, and the style, which is
+   loaded once for all of them rather than once per map.
+
+   Renders are served in the order they are requested, each by the first idle map, and they
+   overlap: while some maps wait for their tiles, others load and draw theirs. The maps live
+   on the thread that created the pool, whose RunLoop must be running for renders to complete.
+*/
+class RenderPool : private util::noncopyable {
+public:
+    // Creates the view of each map. The views of a pool typically share a HeadlessDisplay.
+    using ViewFactory = std::function<std::unique_ptr<View> ()>;
+
+    RenderPool(FileSource&, std::size_t size, ViewFactory, std::size_t workerThreads = 4);
+    ~RenderPool();
+
+    // Renders requested before the style has loaded wait for it. Renders fail if the style
+    // can't be loaded, until another style is set. Renders in progress finish with the style
+    // they were requested under.
+    void setStyleURL(const std::string&);
+    void setStyleJSON(const std::string&);
+
+    // The callback is called on the thread that created the pool.
+    void renderStill(const CameraOptions&, Map::StillImageCallback);
+
+    std::size_t size() const;
+
+    // The number of renders that wait for a map.
+    std::size_t pendingRenders() const;
+
+private:
+    class Impl;
+    const std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -54,6 +54,12 @@ public:
     // doesn't support reading from the framebuffer, return a null pointer.
     virtual PremultipliedImage readStillImage(std::array<uint16_t, 2> size = {{ 0, 0 }});
 
+    // Reads the pixel data from the current framebuffer like readStillImage(), but may finish
+    // after returning, for example while the next image renders. Callbacks are called in order,
+    // on the thread that requested them. By default, the pixel data is read synchronously.
+    using StillImageCallback = std::function<void (PremultipliedImage&&)>;
+    virtual void readStillImageAsync(StillImageCallback);
+
     // Notifies a watcher of map x/y/scale/rotation changes.
     virtual void notifyMapChange(MapChange change);
 
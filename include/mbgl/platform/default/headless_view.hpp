@@ -24,12 +24,18 @@ typedef XID GLXPbuffer;
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/types.hpp>
 #include <mbgl/gl/extension.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+namespace util {
+class Timer;
+} // namespace util
+
 class HeadlessDisplay;
 
 class HeadlessView : public View {
@@ -49,6 +55,20 @@ public:
 
     PremultipliedImage readStillImage(std::array<uint16_t, 2> size = {{ 0, 0 }}) override;
 
+    // Reads the image into one of a ring of pixel buffer objects and delivers it once the GPU
+    // has transferred it, so that the next image renders meanwhile. Falls back to readStillImage()
+    // without support for pixel buffer objects and fences, or with no readback buffers.
+    void readStillImageAsync(StillImageCallback) override;
+
+    // Sets the number of images that can be in transfer at once; 0 reads all images
+    // synchronously. Defaults to 2. Transfers beyond the limit wait for the oldest one.
+    void setReadbackBuffers(std::size_t);
+
+    // Returns an image read by this view once it's no longer needed, so that its buffer can be
+    // reused for a later image of the same size instead of allocating a new one. Keeps as many
+    // buffers as there are readback buffers, and at least one.
+    void recycle(PremultipliedImage&&);
+
     void resize(uint16_t width, uint16_t height);
     void setMapChangeCallback(std::function<void(MapChange)>&& cb) { mapChangeCallback = std::move(cb); }
 
@@ -62,6 +82,13 @@ private:
     void activateContext();
     void deactivateContext();
 
+    struct Readback;
+    PremultipliedImage allocateImage(uint16_t width, uint16_t height);
+    bool supportsAsyncReadback();
+    void finishReadbacks(bool wait);
+    void finishReadback(Readback&);
+    void destroyReadbacks();
+
     std::shared_ptr<HeadlessDisplay> display;
     const float pixelRatio;
     std::array<uint16_t, 2> dimensions;
@@ -94,6 +121,14 @@ private:
     gl::FramebufferID fbo = 0;
     gl::RenderbufferID fboDepthStencil = 0;
     gl::RenderbufferID fboColor = 0;
+
+    // Used in turn, starting at nextReadback, which is the oldest transfer if any is pending.
+    std::vector<std::unique_ptr<Readback>> readbacks;
+    std::size_t readbackBuffers = 2;
+    std::size_t nextReadback = 0;
+    optional<bool> asyncReadbackSupported;
+    std::unique_ptr<util::Timer> readbackTimer;
+    std::vector<PremultipliedImage> imagePool;
 };
 
 } // namespace mbgl
@@ -2,8 +2,12 @@
 
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/chrono.hpp>
 
+#include <atomic>
+#include <functional>
 #include <vector>
 
 namespace mbgl {
@@ -12,6 +16,8 @@ namespace util {
 template <typename T> class Thread;
 } // namespace util
 
+class TileArchiveFileSource;
+
 class DefaultFileSource : public FileSource {
 public:
     /*
@@ -20,10 +26,16 @@ public:
      * There is no size limit for offline resources. If a user never creates any offline
      * regions, we want the database to remain fairly small (order tens or low hundreds
      * of megabytes).
+     *
+     * With a nonzero readerCount, resources are looked up in the database on that many
+     * threads with read-only connections, so that cache hits don't wait for writes such
+     * as those of offline downloads. Readers are best combined with write-ahead logging
+     * (see setOfflineWriteAheadLogging), with which commits don't block them either.
      */
     DefaultFileSource(const std::string& cachePath,
                       const std::string& assetRoot,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      std::size_t readerCount = 0);
     ~DefaultFileSource() override;
 
     bool supportsOptionalRequests() const override {
@@ -38,6 +50,9 @@ public:
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
+    // Affects requests that go online; see OnlineFileSource.
+    void setPriority(AsyncRequest&, Resource::Priority) override;
+
     /*
      * Retrieve all regions in the offline database.
      *
@@ -95,7 +110,9 @@ public:
      * necessary as a result.
      *
      * Eviction works by removing the least-recently requested resources not also required
-     * by other regions, until the database shrinks below a certain size.
+     * by other regions, until the database shrinks below a certain size. It happens in the
+     * background, in short slices once the database has been idle for a moment, which is
+     * also when the space freed is returned to the file system.
      *
      * Note that this method takes ownership of the input, reflecting the fact that once
      * region deletion is initiated, it is not legal to perform further actions with the
@@ -107,21 +124,95 @@ public:
      */
     void deleteOfflineRegion(OfflineRegion&&, std::function<void (std::exception_ptr)>);
 
+    /*
+     * Create an estimator of the size of offline regions from the average sizes of the
+     * tiles stored in the database so far. Estimating needs no further database queries,
+     * so the estimator can size many candidate regions quickly, on any thread.
+     */
+    OfflineRegionSizeEstimator getOfflineRegionSizeEstimator() const;
+
     /*
      * Changing or bypassing this limit without permission from Mapbox is prohibited
      * by the Mapbox Terms of Service.
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Download the resources of offline regions with at most `maxRequests` requests in
+     * progress per region, and at most `maxRequestsPerHost` of them to any one host, so that
+     * a slow host doesn't hold up the others. Both default to the maximum number of
+     * concurrent HTTP requests.
+     */
+    void setOfflineDownloadConcurrency(std::size_t maxRequests, std::size_t maxRequestsPerHost) const;
+
+    /*
+     * Commit the resources of downloading offline regions to the database in transactions
+     * of up to `maxWrites` resources, each committed at most `maxDelay` after it began,
+     * rather than one at a time. Resources not yet committed are lost if the process exits
+     * abnormally, and are downloaded again when the download resumes. A `maxWrites` of 1,
+     * the default, disables batching.
+     */
+    void setOfflineWriteBatching(std::size_t maxWrites, Duration maxDelay) const;
+
+    /*
+     * Use a write-ahead log for the offline database, which makes writes cheaper at the
+     * risk of losing the most recent ones on power failure. Off by default; the setting is
+     * stored in the database.
+     */
+    void setOfflineWriteAheadLogging(bool) const;
+
+    /*
+     * Cache hits record when each resource was last used, for least-recently used eviction.
+     * These times are kept in memory and written together once the oldest is `maxDelay` old,
+     * 5 seconds by default, so that lookups don't each have to write to the database. A
+     * `maxDelay` of zero writes each as it happens.
+     */
+    void setOfflineAccessBatching(Duration maxDelay) const;
+
+    /*
+     * Retrieve counters of the eviction of ambient cache entries, including the time puts
+     * spent evicting before they could write, for diagnostics.
+     */
+    OfflineEvictionStats getOfflineEvictionStats() const;
+
+    /*
+     * Retrieve counters of the network requests made, and of the requests that shared the
+     * network request of an identical one in progress, such as requests for the same tile
+     * from several maps, for diagnostics.
+     */
+    OnlineFileSource::RequestStats getOnlineRequestStats() const;
+
+    /*
+     * Serve the tiles of the tileset with the given URL template from a memory-mapped tile
+     * archive, ahead of the offline database and the network. Tiles missing from the archive
+     * are requested as usual. Archives can be written from MBTiles files with
+     * TileArchive::importMBTiles. Throws if the archive can't be opened.
+     */
+    void addTileArchive(const std::string& urlTemplate, const std::string& path);
+
+    /*
+     * Observe how long each request waited to be looked up in the database, for
+     * diagnostics. The observer is called on the database threads.
+     */
+    using QueueWaitObserver = std::function<void (const Resource&, Duration)>;
+    void setQueueWaitObserver(QueueWaitObserver);
+
     // For testing only.
     void put(const Resource&, const Response&);
 
     class Impl;
+    class Reader;
 
 private:
+    // Looks the resource up in the offline database, and requests it online if needed.
+    std::unique_ptr<AsyncRequest> requestCached(const Resource&, Callback);
+
     const std::unique_ptr<util::Thread<Impl>> thread;
+    std::vector<std::unique_ptr<util::Thread<Reader>>> readers;
+    std::atomic<std::size_t> nextReader { 0 };
     const std::unique_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<TileArchiveFileSource> tileArchiveFileSource;
 };
 
 } // namespace mbgl
@@ -24,6 +24,11 @@ public:
     // not be executed.
     virtual std::unique_ptr<AsyncRequest> request(const Resource&, Callback) = 0;
 
+    // Changes the priority of a request returned by `request`, as when a tile becomes more or
+    // less needed. File sources that make waiting requests in order of priority move the
+    // request accordingly; others ignore the change.
+    virtual void setPriority(AsyncRequest&, Resource::Priority) {}
+
     // When a file source supports optional requests, it must return true.
     // Optional requests are requests that aren't as urgent, but could be useful, e.g.
     // to cover part of the map while loading. The FileSource should only do cheap actions to
@@ -3,12 +3,14 @@
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/range.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/storage/response.hpp>
 
 #include <string>
 #include <vector>
 #include <functional>
+#include <map>
 
 namespace mbgl {
 
@@ -32,6 +34,9 @@ public:
     /* Private */
     std::vector<CanonicalTileID> tileCover(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
 
+    // The size of `tileCover`, computed in time proportional to the number of zoom levels.
+    uint64_t tileCount(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+
     const std::string styleURL;
     const LatLngBounds bounds;
     const double minZoom;
@@ -39,6 +44,35 @@ public:
     const float pixelRatio;
 };
 
+/*
+ * Estimates the number of tiles of a tile pyramid region and the space they take up,
+ * without enumerating the tiles, so that many candidate regions can be sized quickly.
+ *
+ * Sizes are estimated from the average size of a tile at each zoom level, such as those
+ * of the tiles already stored in the offline database. Zoom levels without an average use
+ * that of the nearest zoom level with one; with no averages at all, sizes are zero.
+ */
+class OfflineRegionSizeEstimator {
+public:
+    explicit OfflineRegionSizeEstimator(std::map<uint8_t, uint64_t> averageTileSizes);
+
+    struct Estimate {
+        uint64_t tileCount = 0;
+        uint64_t size = 0;
+    };
+
+    // The tile count is exact; see OfflineTilePyramidRegionDefinition::tileCount.
+    Estimate estimate(const OfflineTilePyramidRegionDefinition&,
+                      SourceType,
+                      uint16_t tileSize,
+                      const Range<uint8_t>& zoomRange) const;
+
+private:
+    uint64_t averageTileSize(uint8_t z) const;
+
+    std::map<uint8_t, uint64_t> averageTileSizes;
+};
+
 /*
  * For the present, a tile pyramid is the only type of offline region. In the future,
  * other definition types will be available and this will be a variant type.
@@ -208,4 +242,25 @@ private:
     const OfflineRegionMetadata metadata;
 };
 
+/*
+ * Counters of the eviction of ambient cache entries from the offline database, for
+ * diagnostics. Eviction happens either synchronously, before a put that would exceed the
+ * maximum cache size, or incrementally, in short slices while the database is idle.
+ */
+class OfflineEvictionStats {
+public:
+    // Puts that had to evict entries before writing, and the total and longest time
+    // they spent doing so.
+    uint64_t evictingPuts = 0;
+    Duration putEvictionTime = Duration::zero();
+    Duration maxPutEvictionTime = Duration::zero();
+
+    // Time spent evicting and vacuuming in idle slices.
+    Duration incrementalEvictionTime = Duration::zero();
+
+    // Entries evicted, and the size of their data, by either kind of eviction.
+    uint64_t evictedEntries = 0;
+    uint64_t evictedBytes = 0;
+};
+
 } // namespace mbgl
@@ -17,6 +17,16 @@ public:
     std::string getAccessToken() const { return accessToken; }
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void setPriority(AsyncRequest&, Resource::Priority) override;
+
+    // Requests for a resource that is already being requested wait for the response of the
+    // request in progress instead of making a network request of their own.
+    struct RequestStats {
+        uint64_t networkRequests = 0;
+        uint64_t coalescedRequests = 0;
+    };
+
+    RequestStats getRequestStats() const;
 
 private:
     friend class OnlineFileRequest;
@@ -34,6 +34,18 @@ public:
         Required = true,
     };
 
+    // How urgently the resource is needed, from most to least urgent. Requests wait for the
+    // network until more urgent requests don't; see OnlineFileSource.
+    enum class Priority : uint8_t {
+        Regular,
+        // Tiles that stand in for the ideal tiles of the viewport while those load.
+        Fallback,
+        // Tiles that aren't needed for rendering at the moment.
+        Prefetch,
+        // Requests in the background, such as those of offline downloads.
+        Low,
+    };
+
     Resource(Kind kind_, std::string url_, optional<TileData> tileData_ = {}, Necessity necessity_ = Required)
         : kind(kind_),
           necessity(necessity_),
@@ -58,6 +70,7 @@ public:
 
     Kind kind;
     Necessity necessity;
+    Priority priority = Priority::Regular;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -113,5 +113,62 @@ public:
     bool operator()(FeatureType type, optional<FeatureIdentifier> id, PropertyAccessor accessor) const;
 };
 
+inline bool operator==(const NullFilter&, const NullFilter&) {
+    return true;
+}
+
+inline bool operator==(const EqualsFilter& lhs, const EqualsFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const NotEqualsFilter& lhs, const NotEqualsFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const LessThanFilter& lhs, const LessThanFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const LessThanEqualsFilter& lhs, const LessThanEqualsFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const GreaterThanFilter& lhs, const GreaterThanFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const GreaterThanEqualsFilter& lhs, const GreaterThanEqualsFilter& rhs) {
+    return lhs.key == rhs.key && lhs.value == rhs.value;
+}
+
+inline bool operator==(const InFilter& lhs, const InFilter& rhs) {
+    return lhs.key == rhs.key && lhs.values == rhs.values;
+}
+
+inline bool operator==(const NotInFilter& lhs, const NotInFilter& rhs) {
+    return lhs.key == rhs.key && lhs.values == rhs.values;
+}
+
+inline bool operator==(const HasFilter& lhs, const HasFilter& rhs) {
+    return lhs.key == rhs.key;
+}
+
+inline bool operator==(const NotHasFilter& lhs, const NotHasFilter& rhs) {
+    return lhs.key == rhs.key;
+}
+
+// Compound filters are equal if their child filters are.
+inline bool operator==(const AnyFilter& lhs, const AnyFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
+inline bool operator==(const AllFilter& lhs, const AllFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
+inline bool operator==(const NoneFilter& lhs, const NoneFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
 } // namespace style
 } // namespace mbgl
@@ -4,6 +4,8 @@
 #include <mbgl/util/tileset.hpp>
 #include <mbgl/util/variant.hpp>
 
+#include <cstddef>
+
 namespace mbgl {
 namespace style {
 
@@ -11,9 +13,29 @@ class RasterSource : public Source {
 public:
     RasterSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize);
 
+    // Uploads tiles without transparent pixels as 16 bit RGB565 textures, which take half the
+    // memory of RGBA textures at the cost of color depth. Applies to tiles loaded afterwards.
+    // Disabled by default.
+    void setPackOpaqueTiles(bool);
+    bool getPackOpaqueTiles() const;
+
+    // Approximate memory held by the tiles of the source, in bytes. Tiles in the tile cache
+    // are reported by Map::getTileCacheMemoryUsage() instead.
+    struct MemoryUsage {
+        // Decoded tiles waiting to be uploaded.
+        std::size_t images = 0;
+        // Uploaded tiles.
+        std::size_t textures = 0;
+        // Idle decoding buffers kept for reuse by the next tiles.
+        std::size_t pooled = 0;
+    };
+
+    MemoryUsage getMemoryUsage() const;
+
     // Private implementation
 
     class Impl;
+    Impl* const impl;
 };
 
 template <>
@@ -1,12 +1,55 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
-        
+
+// zlib, at the default compression level. Decompression also accepts gzip data.
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
-    
+
+// The values are stored in databases; don't renumber them.
+enum class Codec : uint8_t {
+    None = 0,
+    Zlib = 1,
+    Zstd = 2,
+};
+
+// Zstd is only available when built with MBGL_USE_ZSTD.
+bool isSupported(Codec);
+
+// A dictionary of content common to the data to be compressed, such as the layer and
+// property names of vector tiles, which makes small inputs compress much better. Data
+// compressed with a dictionary must be decompressed with the same dictionary. Only
+// Codec::Zstd makes use of dictionaries.
+class CompressionDictionary {
+public:
+    explicit CompressionDictionary(std::string data);
+    ~CompressionDictionary();
+
+    const std::string& getData() const { return data; }
+
+    // Builds a dictionary of at most `maxSize` bytes from typical inputs. Returns an empty
+    // string if zstd isn't supported or if the samples are too few to train on.
+    static std::string train(const std::vector<std::string>& samples, std::size_t maxSize);
+
+private:
+    friend std::string compress(const std::string&, Codec, const CompressionDictionary*);
+    friend std::string decompress(const std::string&, Codec, const CompressionDictionary*);
+
+    class Impl;
+    const std::string data;
+    const std::unique_ptr<Impl> impl;
+};
+
+// Compression contexts are kept per thread and reused across calls. Both throw
+// std::runtime_error if the codec isn't supported or the data is corrupt.
+std::string compress(const std::string& raw, Codec, const CompressionDictionary* = nullptr);
+std::string decompress(const std::string& raw, Codec, const CompressionDictionary* = nullptr);
+
 } // namespace util
 } // namespace mbgl
@@ -1,4 +1,5 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_pool.hpp>
 
 #import <ImageIO/ImageIO.h>
 
@@ -65,7 +66,10 @@ std::string encodePNG(const PremultipliedImage& src) {
     return result;
 }
 
-PremultipliedImage decodeImage(const std::string &source_data) {
+namespace {
+
+// Allocates the decoded image from the pool, if any.
+PremultipliedImage decode(const std::string &source_data, util::ImagePool *pool) {
     CFDataRef data = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, reinterpret_cast<const unsigned char *>(source_data.data()), source_data.size(), kCFAllocatorNull);
     if (!data) {
         throw std::runtime_error("CFDataCreateWithBytesNoCopy failed");
@@ -92,8 +96,9 @@ PremultipliedImage decodeImage(const std::string &source_data) {
         throw std::runtime_error("CGColorSpaceCreateDeviceRGB failed");
     }
 
-    PremultipliedImage result{ static_cast<uint16_t>(CGImageGetWidth(image)),
-                               static_cast<uint16_t>(CGImageGetHeight(image)) };
+    const uint16_t width = static_cast<uint16_t>(CGImageGetWidth(image));
+    const uint16_t height = static_cast<uint16_t>(CGImageGetHeight(image));
+    PremultipliedImage result = pool ? pool->acquire(width, height) : PremultipliedImage{ width, height };
 
     CGContextRef context = CGBitmapContextCreate(result.data.get(), result.width, result.height, 8, result.stride(),
         color_space, kCGImageAlphaPremultipliedLast);
@@ -119,4 +124,14 @@ PremultipliedImage decodeImage(const std::string &source_data) {
     return result;
 }
 
+} // namespace
+
+PremultipliedImage decodeImage(const std::string &source_data) {
+    return decode(source_data, nullptr);
+}
+
+PremultipliedImage decodeImage(const std::string &source_data, util::ImagePool &pool) {
+    return decode(source_data, &pool);
+}
+
 }
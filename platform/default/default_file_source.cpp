@@ -1,13 +1,18 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
 
 #include <mbgl/platform/platform.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/work_request.hpp>
 
 #include <cassert>
@@ -24,10 +29,84 @@ bool isAssetURL(const std::string& url) {
 
 namespace mbgl {
 
+namespace {
+
+// Whether the resource is looked up in the database before it is requested.
+bool needsLookup(const Resource& resource) {
+    const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
+    return !hasPrior || resource.necessity == Resource::Optional;
+}
+
+// For optional resources, turns a missing response into a "not found" one.
+optional<Response> lookupResult(const Resource& resource, optional<Response> offlineResponse) {
+    if (resource.necessity == Resource::Optional && !offlineResponse) {
+        // Ensure there's always a response that we can send, so the caller knows that
+        // there's no optional data available in the cache.
+        offlineResponse.emplace();
+        offlineResponse->noContent = true;
+        offlineResponse->error = std::make_unique<Response::Error>(
+            Response::Error::Reason::NotFound, "Not found in offline database");
+    }
+
+    return offlineResponse;
+}
+
+// Revalidates the cached response, if any, when the resource is requested online.
+Resource revalidationOf(const Resource& resource, const optional<Response>& offlineResponse) {
+    Resource revalidation = resource;
+    if (offlineResponse) {
+        revalidation.priorModified = offlineResponse->modified;
+        revalidation.priorExpires = offlineResponse->expires;
+        revalidation.priorEtag = offlineResponse->etag;
+    }
+    return revalidation;
+}
+
+} // namespace
+
+// Looks up resources through a read-only connection to the database, so that cache hits
+// don't wait for writes on the database thread.
+class DefaultFileSource::Reader {
+public:
+    Reader(std::string path_)
+        : path(std::move(path_)) {
+    }
+
+    void setQueueWaitObserver(QueueWaitObserver observer) {
+        queueWaitObserver = std::move(observer);
+    }
+
+    void lookup(Resource resource, TimePoint queued, std::function<void (optional<Response>)> callback) {
+        if (queueWaitObserver) {
+            queueWaitObserver(resource, Clock::now() - queued);
+        }
+
+        optional<Response> offlineResponse;
+        try {
+            if (!database) {
+                database = std::make_unique<OfflineDatabase>(path, OfflineDatabase::ReadOnly());
+            }
+            offlineResponse = database->get(resource);
+        } catch (...) {
+            Log::Error(Event::Database, "Unable to read offline database: %s", util::toString(std::current_exception()).c_str());
+            database.reset();
+        }
+
+        callback(lookupResult(resource, std::move(offlineResponse)));
+    }
+
+private:
+    const std::string path;
+    std::unique_ptr<OfflineDatabase> database;
+    QueueWaitObserver queueWaitObserver;
+};
+
 class DefaultFileSource::Impl {
 public:
     Impl(const std::string& cachePath, uint64_t maximumCacheSize)
         : offlineDatabase(cachePath, maximumCacheSize) {
+        offlineDatabase.setIncrementalEviction(true);
+        offlineDatabase.setAccessBatching(Seconds(5));
     }
     
     void setAPIBaseURL(const std::string& url) {
@@ -86,6 +165,7 @@ public:
         try {
             downloads.erase(region.getID());
             offlineDatabase.deleteRegion(std::move(region));
+            scheduleEviction();
             callback({});
         } catch (...) {
             callback(std::current_exception());
@@ -100,73 +180,170 @@ public:
         getDownload(regionID).setState(state);
     }
 
-    void request(AsyncRequest* req, Resource resource, Callback callback) {
-        Resource revalidation = resource;
-
-        const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
-        if (!hasPrior || resource.necessity == Resource::Optional) {
-            auto offlineResponse = offlineDatabase.get(resource);
-
-            if (resource.necessity == Resource::Optional && !offlineResponse) {
-                // Ensure there's always a response that we can send, so the caller knows that
-                // there's no optional data available in the cache.
-                offlineResponse.emplace();
-                offlineResponse->noContent = true;
-                offlineResponse->error = std::make_unique<Response::Error>(
-                    Response::Error::Reason::NotFound, "Not found in offline database");
-            }
+    void request(AsyncRequest* req, Resource resource, TimePoint queued, Callback callback) {
+        if (queueWaitObserver) {
+            queueWaitObserver(resource, Clock::now() - queued);
+        }
 
+        optional<Response> offlineResponse;
+        if (needsLookup(resource)) {
+            offlineResponse = lookupResult(resource, offlineDatabase.get(resource));
+            scheduleAccessFlush();
             if (offlineResponse) {
-                revalidation.priorModified = offlineResponse->modified;
-                revalidation.priorExpires = offlineResponse->expires;
-                revalidation.priorEtag = offlineResponse->etag;
                 callback(*offlineResponse);
             }
         }
 
-        if (resource.necessity == Resource::Required) {
+        requestOnline(req, revalidationOf(resource, offlineResponse), callback);
+    }
+
+    // Requests the resource online, once it has been looked up in the database.
+    void requestOnline(AsyncRequest* req, Resource revalidation, Callback callback) {
+        if (revalidation.necessity == Resource::Required) {
             tasks[req] = onlineFileSource.request(revalidation, [=] (Response onlineResponse) {
                 this->offlineDatabase.put(revalidation, onlineResponse);
+                this->scheduleEviction();
                 callback(onlineResponse);
             });
         }
     }
 
+    void markAccessed(const Resource& resource) {
+        try {
+            offlineDatabase.markAccessed(resource);
+            scheduleAccessFlush();
+        } catch (...) {
+            Log::Error(Event::Database, "Unable to update offline database: %s", util::toString(std::current_exception()).c_str());
+        }
+    }
+
+    void setQueueWaitObserver(QueueWaitObserver observer) {
+        queueWaitObserver = std::move(observer);
+    }
+
     void cancel(AsyncRequest* req) {
         tasks.erase(req);
     }
 
+    // The request is only used to look up its online request, which it may have outlived.
+    void setPriority(AsyncRequest* req, Resource::Priority priority) {
+        auto it = tasks.find(req);
+        if (it != tasks.end()) {
+            onlineFileSource.setPriority(*it->second, priority);
+        }
+    }
+
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
         offlineDatabase.setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setOfflineDownloadConcurrency(std::size_t maxRequests, std::size_t maxRequestsPerHost) {
+        downloadConcurrency = std::make_pair(maxRequests, maxRequestsPerHost);
+        for (auto& download : downloads) {
+            download.second->setConcurrency(maxRequests, maxRequestsPerHost);
+        }
+    }
+
+    void setOfflineWriteBatching(std::size_t maxWrites, Duration maxDelay) {
+        offlineDatabase.setWriteBatching(maxWrites, maxDelay);
+    }
+
+    void setOfflineAccessBatching(Duration maxDelay) {
+        offlineDatabase.setAccessBatching(maxDelay);
+        scheduleAccessFlush();
+    }
+
+    void setOfflineWriteAheadLogging(bool enabled) {
+        offlineDatabase.setWriteAheadLogging(enabled);
+    }
+
+    OfflineEvictionStats getOfflineEvictionStats() const {
+        return offlineDatabase.getEvictionStats();
+    }
+
+    OnlineFileSource::RequestStats getOnlineRequestStats() const {
+        return onlineFileSource.getRequestStats();
+    }
+
+    OfflineRegionSizeEstimator getOfflineRegionSizeEstimator() {
+        return OfflineRegionSizeEstimator(offlineDatabase.getAverageTileSizes());
+    }
+
     void put(const Resource& resource, const Response& response) {
         offlineDatabase.put(resource, response);
+        scheduleEviction();
     }
 
 private:
+    // Writes the access times of lookups once the database has been idle for as long as they
+    // may be kept; while it is busy, they are written as they become that old.
+    void scheduleAccessFlush() {
+        if (!offlineDatabase.hasUnflushedAccesses()) {
+            return;
+        }
+        accessFlushTimer.start(offlineDatabase.getAccessBatchDelay(), Duration::zero(), [this] {
+            try {
+                offlineDatabase.flushAccesses();
+            } catch (...) {
+                Log::Error(Event::Database, "Unable to update offline database: %s", util::toString(std::current_exception()).c_str());
+            }
+        });
+    }
+
+    // Evicts from the cache in short slices once the database has been idle for a while,
+    // so that puts rarely have to, and restarts the wait with every write.
+    void scheduleEviction() {
+        evictionTimer.start(Milliseconds(100), Milliseconds(10), [this] {
+            bool more = false;
+            try {
+                more = offlineDatabase.evictIncrementally(Milliseconds(10));
+            } catch (...) {
+                Log::Error(Event::Database, "Unable to evict from offline database: %s", util::toString(std::current_exception()).c_str());
+            }
+            if (!more) {
+                evictionTimer.stop();
+            }
+        });
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
             return *it->second;
         }
-        return *downloads.emplace(regionID,
-            std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, onlineFileSource)).first->second;
+        auto download = std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, onlineFileSource);
+        if (downloadConcurrency) {
+            download->setConcurrency(downloadConcurrency->first, downloadConcurrency->second);
+        }
+        return *downloads.emplace(regionID, std::move(download)).first->second;
     }
 
     OfflineDatabase offlineDatabase;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    optional<std::pair<std::size_t, std::size_t>> downloadConcurrency;
+    QueueWaitObserver queueWaitObserver;
+    util::Timer evictionTimer;
+    util::Timer accessFlushTimer;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      const std::string& assetRoot,
-                                     uint64_t maximumCacheSize)
+                                     uint64_t maximumCacheSize,
+                                     std::size_t readerCount)
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"DefaultFileSource", util::ThreadPriority::Low},
             cachePath, maximumCacheSize)),
       assetFileSource(std::make_unique<AssetFileSource>(assetRoot)),
-      localFileSource(std::make_unique<LocalFileSource>()) {
+      localFileSource(std::make_unique<LocalFileSource>()),
+      tileArchiveFileSource(std::make_unique<TileArchiveFileSource>()) {
+    // An in-memory database can't be shared between connections.
+    if (cachePath != ":memory:") {
+        for (std::size_t i = 0; i < readerCount; i++) {
+            readers.push_back(std::make_unique<util::Thread<Reader>>(
+                util::ThreadContext{"OfflineDatabaseReader"}, cachePath));
+        }
+    }
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -188,11 +365,63 @@ std::string DefaultFileSource::getAccessToken() const {
 }
 
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
+    // Holds the request to the tile archive, and then the one that replaces it if the tile
+    // isn't in the archive.
+    class TileArchiveRequest : public AsyncRequest {
+    public:
+        std::unique_ptr<AsyncRequest> request;
+    };
+
+    if (isAssetURL(resource.url)) {
+        return assetFileSource->request(resource, callback);
+    } else if (LocalFileSource::acceptsURL(resource.url)) {
+        return localFileSource->request(resource, callback);
+    } else if (tileArchiveFileSource->accepts(resource)) {
+        auto req = std::make_unique<TileArchiveRequest>();
+        req->request = tileArchiveFileSource->request(resource, [this, resource, callback, archiveRequest = req.get()] (Response response) {
+            if (response.error && response.error->reason == Response::Error::Reason::NotFound) {
+                archiveRequest->request = requestCached(resource, callback);
+            } else {
+                callback(response);
+            }
+        });
+        return std::move(req);
+    } else {
+        return requestCached(resource, callback);
+    }
+}
+
+std::unique_ptr<AsyncRequest> DefaultFileSource::requestCached(const Resource& resource, Callback callback) {
     class DefaultFileRequest : public AsyncRequest {
     public:
         DefaultFileRequest(Resource resource_, FileSource::Callback callback_, util::Thread<DefaultFileSource::Impl>& thread_)
             : thread(thread_),
-              workRequest(thread.invokeWithCallback(&DefaultFileSource::Impl::request, this, resource_, callback_)) {
+              workRequest(thread.invokeWithCallback(&DefaultFileSource::Impl::request, this, resource_, Clock::now(), callback_)) {
+        }
+
+        // Looks the resource up on a reader thread, and then requests it online on the
+        // database thread if needed.
+        DefaultFileRequest(Resource resource_, FileSource::Callback callback_, util::Thread<DefaultFileSource::Impl>& thread_,
+                           util::Thread<DefaultFileSource::Reader>& reader)
+            : thread(thread_),
+              workRequest(reader.invokeWithCallback(&DefaultFileSource::Reader::lookup, resource_, Clock::now(),
+                                                    [this, resource_, callback_] (optional<Response> offlineResponse) {
+                  if (offlineResponse && !offlineResponse->error) {
+                      thread.invoke(&DefaultFileSource::Impl::markAccessed, resource_);
+                  }
+
+                  // The callback may destroy this request, so the online request is started
+                  // first, and the request isn't used afterwards. Optional resources are
+                  // never requested online.
+                  if (resource_.necessity == Resource::Required) {
+                      workRequest = thread.invokeWithCallback(&DefaultFileSource::Impl::requestOnline, this,
+                                                              revalidationOf(resource_, offlineResponse), callback_);
+                  }
+
+                  if (offlineResponse) {
+                      callback_(*offlineResponse);
+                  }
+              })) {
         }
 
         ~DefaultFileRequest() override {
@@ -203,15 +432,18 @@ std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resourc
         std::unique_ptr<AsyncRequest> workRequest;
     };
 
-    if (isAssetURL(resource.url)) {
-        return assetFileSource->request(resource, callback);
-    } else if (LocalFileSource::acceptsURL(resource.url)) {
-        return localFileSource->request(resource, callback);
+    if (!readers.empty() && needsLookup(resource)) {
+        auto& reader = *readers[nextReader++ % readers.size()];
+        return std::make_unique<DefaultFileRequest>(resource, callback, *thread, reader);
     } else {
         return std::make_unique<DefaultFileRequest>(resource, callback, *thread);
     }
 }
 
+void DefaultFileSource::setPriority(AsyncRequest& req, Resource::Priority priority) {
+    thread->invoke(&Impl::setPriority, &req, priority);
+}
+
 void DefaultFileSource::listOfflineRegions(std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
     thread->invoke(&Impl::listRegions, callback);
 }
@@ -248,6 +480,45 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     thread->invokeSync(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setOfflineDownloadConcurrency(std::size_t maxRequests, std::size_t maxRequestsPerHost) const {
+    thread->invokeSync(&Impl::setOfflineDownloadConcurrency, maxRequests, maxRequestsPerHost);
+}
+
+void DefaultFileSource::setOfflineWriteBatching(std::size_t maxWrites, Duration maxDelay) const {
+    thread->invokeSync(&Impl::setOfflineWriteBatching, maxWrites, maxDelay);
+}
+
+OfflineEvictionStats DefaultFileSource::getOfflineEvictionStats() const {
+    return thread->invokeSync(&Impl::getOfflineEvictionStats);
+}
+
+OnlineFileSource::RequestStats DefaultFileSource::getOnlineRequestStats() const {
+    return thread->invokeSync(&Impl::getOnlineRequestStats);
+}
+
+OfflineRegionSizeEstimator DefaultFileSource::getOfflineRegionSizeEstimator() const {
+    return thread->invokeSync(&Impl::getOfflineRegionSizeEstimator);
+}
+
+void DefaultFileSource::setOfflineAccessBatching(Duration maxDelay) const {
+    thread->invokeSync(&Impl::setOfflineAccessBatching, maxDelay);
+}
+
+void DefaultFileSource::setOfflineWriteAheadLogging(bool enabled) const {
+    thread->invokeSync(&Impl::setOfflineWriteAheadLogging, enabled);
+}
+
+void DefaultFileSource::addTileArchive(const std::string& urlTemplate, const std::string& path) {
+    tileArchiveFileSource->addArchive(urlTemplate, path);
+}
+
+void DefaultFileSource::setQueueWaitObserver(QueueWaitObserver observer) {
+    thread->invokeSync(&Impl::setQueueWaitObserver, observer);
+    for (auto& reader : readers) {
+        reader->invokeSync(&Reader::setQueueWaitObserver, observer);
+    }
+}
+
 // For testing only:
 
 void DefaultFileSource::put(const Resource& resource, const Response& response) {
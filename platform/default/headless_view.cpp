@@ -1,11 +1,71 @@
 #include <mbgl/platform/default/headless_view.hpp>
 #include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/util/timer.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <string>
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER              0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ                    0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT                   0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED               0x911A
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED            0x911C
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED                    0x911D
+#endif
 
 namespace mbgl {
 
+namespace {
+
+// GLsync, which OpenGL ES 2 headers don't declare.
+using Sync = void*;
+
+gl::ExtensionFunction<Sync (GLenum condition, GLbitfield flags)>
+    FenceSync({ { "GL_ARB_sync", "glFenceSync" },
+                { "GL_APPLE_sync", "glFenceSyncAPPLE" } });
+
+gl::ExtensionFunction<GLenum (Sync sync, GLbitfield flags, uint64_t timeout)>
+    ClientWaitSync({ { "GL_ARB_sync", "glClientWaitSync" },
+                     { "GL_APPLE_sync", "glClientWaitSyncAPPLE" } });
+
+gl::ExtensionFunction<void (Sync sync)>
+    DeleteSync({ { "GL_ARB_sync", "glDeleteSync" },
+                 { "GL_APPLE_sync", "glDeleteSyncAPPLE" } });
+
+gl::ExtensionFunction<void* (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)>
+    MapBufferRange({ { "GL_ARB_map_buffer_range", "glMapBufferRange" },
+                     { "GL_EXT_map_buffer_range", "glMapBufferRangeEXT" } });
+
+gl::ExtensionFunction<GLboolean (GLenum target)>
+    UnmapBuffer({ { "GL_ARB_map_buffer_range", "glUnmapBuffer" },
+                  { "GL_OES_mapbuffer", "glUnmapBufferOES" } });
+
+} // namespace
+
+struct HeadlessView::Readback {
+    gl::BufferID buffer = 0;
+    std::size_t bufferSize = 0;
+    Sync fence = nullptr;
+    std::array<uint16_t, 2> size = {{ 0, 0 }};
+    StillImageCallback callback;
+};
+
 HeadlessView::HeadlessView(float pixelRatio_, uint16_t width, uint16_t height)
     : display(std::make_shared<HeadlessDisplay>())
     , pixelRatio(pixelRatio_)
@@ -25,6 +85,7 @@ HeadlessView::HeadlessView(std::shared_ptr<HeadlessDisplay> display_,
 
 HeadlessView::~HeadlessView() {
     activate();
+    destroyReadbacks();
     clearBuffers();
     deactivate();
 
@@ -48,7 +109,7 @@ PremultipliedImage HeadlessView::readStillImage(std::array<uint16_t, 2> size) {
         size[1] = dimensions[1] * pixelRatio;
     }
 
-    PremultipliedImage image { size[0], size[1] };
+    PremultipliedImage image = allocateImage(size[0], size[1]);
     MBGL_CHECK_ERROR(glReadPixels(0, 0, size[0], size[1], GL_RGBA, GL_UNSIGNED_BYTE, image.data.get()));
 
     const auto stride = image.stride();
@@ -63,6 +124,170 @@ PremultipliedImage HeadlessView::readStillImage(std::array<uint16_t, 2> size) {
     return image;
 }
 
+void HeadlessView::readStillImageAsync(StillImageCallback callback) {
+    assert(active);
+
+    if (!readbackBuffers || !supportsAsyncReadback()) {
+        finishReadbacks(true);
+        callback(readStillImage());
+        return;
+    }
+
+    if (readbacks.size() != readbackBuffers) {
+        finishReadbacks(true);
+        destroyReadbacks();
+        for (std::size_t i = 0; i < readbackBuffers; i++) {
+            readbacks.push_back(std::make_unique<Readback>());
+        }
+        nextReadback = 0;
+    }
+
+    // All buffers are in use: wait for the oldest transfer.
+    Readback& readback = *readbacks[nextReadback];
+    if (readback.callback) {
+        finishReadback(readback);
+    }
+
+    readback.size = getFramebufferSize();
+    const std::size_t size = std::size_t(readback.size[0]) * readback.size[1] * 4;
+
+    if (!readback.buffer) {
+        MBGL_CHECK_ERROR(glGenBuffers(1, &readback.buffer));
+    }
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer));
+    if (readback.bufferSize != size) {
+        MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+        readback.bufferSize = size;
+    }
+
+    // Returns at once; the GPU copies the framebuffer into the buffer in the background.
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, readback.size[0], readback.size[1], GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    readback.fence = MBGL_CHECK_ERROR(FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    MBGL_CHECK_ERROR(glFlush());
+    readback.callback = std::move(callback);
+
+    nextReadback = (nextReadback + 1) % readbacks.size();
+
+    if (!readbackTimer) {
+        readbackTimer = std::make_unique<util::Timer>();
+    }
+    readbackTimer->start(Milliseconds(1), Milliseconds(1), [this] {
+        activate();
+        finishReadbacks(false);
+        deactivate();
+    });
+}
+
+void HeadlessView::setReadbackBuffers(std::size_t count) {
+    readbackBuffers = count;
+}
+
+void HeadlessView::recycle(PremultipliedImage&& image) {
+    // Keep as many buffers as there can be images in transfer, and one for synchronous reads.
+    if (image.data && imagePool.size() < std::max<std::size_t>(readbackBuffers, 1)) {
+        imagePool.push_back(std::move(image));
+    }
+}
+
+PremultipliedImage HeadlessView::allocateImage(uint16_t width, uint16_t height) {
+    for (auto it = imagePool.begin(); it != imagePool.end(); ++it) {
+        if (it->width == width && it->height == height) {
+            PremultipliedImage image = std::move(*it);
+            imagePool.erase(it);
+            return image;
+        }
+    }
+    return { width, height };
+}
+
+bool HeadlessView::supportsAsyncReadback() {
+    if (!asyncReadbackSupported) {
+        const char* extensions = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_EXTENSIONS)));
+        const std::string extensionsString = extensions ? extensions : "";
+        const bool pixelBufferObjects =
+            extensionsString.find("GL_ARB_pixel_buffer_object") != std::string::npos ||
+            extensionsString.find("GL_NV_pixel_buffer_object") != std::string::npos;
+        asyncReadbackSupported = pixelBufferObjects && FenceSync && ClientWaitSync && DeleteSync &&
+                                 MapBufferRange && UnmapBuffer;
+    }
+    return *asyncReadbackSupported;
+}
+
+// Finishes pending transfers in the order they were started. Unless waiting, stops at the
+// first one the GPU hasn't completed yet.
+void HeadlessView::finishReadbacks(bool wait) {
+    for (std::size_t i = 0; i < readbacks.size(); i++) {
+        Readback& readback = *readbacks[(nextReadback + i) % readbacks.size()];
+        if (!readback.callback) {
+            continue;
+        }
+        if (!wait) {
+            const GLenum status = MBGL_CHECK_ERROR(ClientWaitSync(readback.fence, 0, 0));
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED && status != GL_WAIT_FAILED) {
+                return;
+            }
+        }
+        finishReadback(readback);
+    }
+
+    if (readbackTimer) {
+        readbackTimer->stop();
+    }
+}
+
+void HeadlessView::finishReadback(Readback& readback) {
+    assert(active);
+
+    const uint16_t width = readback.size[0];
+    const uint16_t height = readback.size[1];
+
+    PremultipliedImage image = allocateImage(width, height);
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer));
+    const auto* pixels = reinterpret_cast<const uint8_t*>(
+        MBGL_CHECK_ERROR(MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, image.size(), GL_MAP_READ_BIT)));
+
+    // The only copy of the pixels, which also flips them from bottom-up to top-down rows.
+    const std::size_t stride = image.stride();
+    if (pixels) {
+        for (std::size_t row = 0; row < height; row++) {
+            std::memcpy(image.data.get() + row * stride, pixels + (height - 1 - row) * stride, stride);
+        }
+        MBGL_CHECK_ERROR(UnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    MBGL_CHECK_ERROR(DeleteSync(readback.fence));
+    readback.fence = nullptr;
+
+    if (!pixels) {
+        // The buffer couldn't be mapped. Read the framebuffer directly instead, which holds the
+        // image unless another one was drawn since.
+        recycle(std::move(image));
+        image = readStillImage(readback.size);
+    }
+
+    // Release the buffer before the callback, which may start another transfer.
+    StillImageCallback callback = std::move(readback.callback);
+    readback.callback = nullptr;
+    callback(std::move(image));
+}
+
+// Abandons pending transfers, like a map abandons a render in progress when destroyed.
+void HeadlessView::destroyReadbacks() {
+    for (auto& readback : readbacks) {
+        if (readback->fence) {
+            MBGL_CHECK_ERROR(DeleteSync(readback->fence));
+        }
+        if (readback->buffer) {
+            MBGL_CHECK_ERROR(glDeleteBuffers(1, &readback->buffer));
+        }
+    }
+    readbacks.clear();
+}
+
 float HeadlessView::getPixelRatio() const {
     return pixelRatio;
 }
@@ -1,6 +1,7 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/image_pool.hpp>
 
 #include <png.h>
 
@@ -25,11 +26,6 @@ const static bool png_version_check __attribute__((unused)) = []() {
 namespace mbgl {
 
 std::string encodePNG(const PremultipliedImage& pre) {
-    PremultipliedImage copy { pre.width, pre.height };
-    std::copy(pre.data.get(), pre.data.get() + pre.size(), copy.data.get());
-
-    UnassociatedImage src = util::unpremultiply(std::move(copy));
-
     png_voidp error_ptr = nullptr;
     png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, error_ptr, nullptr, nullptr);
     if (!png_ptr) {
@@ -42,7 +38,7 @@ std::string encodePNG(const PremultipliedImage& pre) {
         throw std::runtime_error("couldn't create info_ptr");
     }
 
-    png_set_IHDR(png_ptr, info_ptr, src.width, src.height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
+    png_set_IHDR(png_ptr, info_ptr, pre.width, pre.height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
                  PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 
     jmp_buf *jmp_context = (jmp_buf *)png_get_error_ptr(png_ptr);
@@ -57,31 +53,35 @@ std::string encodePNG(const PremultipliedImage& pre) {
         out->append(reinterpret_cast<char *>(data), length);
     }, nullptr);
 
-    struct ptrs {
-        ptrs(size_t count) : rows(new png_bytep[count]) {}
-        ~ptrs() { delete[] rows; }
-        png_bytep *rows = nullptr;
-    } pointers(src.height);
+    png_write_info(png_ptr, info_ptr);
 
-    for (size_t i = 0; i < src.height; i++) {
-        pointers.rows[i] = src.data.get() + src.stride() * i;
+    // Unpremultiplies one row at a time into a single row buffer, rather than copying the
+    // whole image first.
+    const size_t stride = pre.stride();
+    const std::unique_ptr<uint8_t[]> row(new uint8_t[stride]);
+    for (size_t i = 0; i < pre.height; i++) {
+        std::copy(pre.data.get() + stride * i, pre.data.get() + stride * (i + 1), row.get());
+        util::unpremultiply(row.get(), pre.width);
+        png_write_row(png_ptr, row.get());
     }
 
-    png_set_rows(png_ptr, info_ptr, pointers.rows);
-    png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, nullptr);
+    png_write_end(png_ptr, info_ptr);
     png_destroy_write_struct(&png_ptr, &info_ptr);
 
     return result;
 }
 
 #if !defined(__ANDROID__) && !defined(__APPLE__)
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+PremultipliedImage decodeWebP(const uint8_t*, size_t, util::ImagePool*);
 #endif // !defined(__ANDROID__) && !defined(__APPLE__)
 
-PremultipliedImage decodePNG(const uint8_t*, size_t);
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+PremultipliedImage decodePNG(const uint8_t*, size_t, util::ImagePool*);
+PremultipliedImage decodeJPEG(const uint8_t*, size_t, util::ImagePool*);
 
-PremultipliedImage decodeImage(const std::string& string) {
+namespace {
+
+// Allocates the decoded image from the pool, if any.
+PremultipliedImage decode(const std::string& string, util::ImagePool* pool) {
     const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
@@ -90,7 +90,7 @@ PremultipliedImage decodeImage(const std::string& string) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         uint32_t webp_magic = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
         if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
-            return decodeWebP(data, size);
+            return decodeWebP(data, size, pool);
         }
     }
 #endif // !defined(__ANDROID__) && !defined(__APPLE__)
@@ -98,18 +98,28 @@ PremultipliedImage decodeImage(const std::string& string) {
     if (size >= 4) {
         uint32_t magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         if (magic == 0x89504E47U) {
-            return decodePNG(data, size);
+            return decodePNG(data, size, pool);
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, pool);
         }
     }
 
     throw std::runtime_error("unsupported image type");
 }
 
+} // namespace
+
+PremultipliedImage decodeImage(const std::string& string) {
+    return decode(string, nullptr);
+}
+
+PremultipliedImage decodeImage(const std::string& string, util::ImagePool& pool) {
+    return decode(string, &pool);
+}
+
 } // namespace mbgl
@@ -7,6 +7,7 @@
 #include <rapidjson/writer.h>
 
 #include <cmath>
+#include <iterator>
 
 namespace mbgl {
 
@@ -43,6 +44,58 @@ std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(Sourc
     return result;
 }
 
+uint64_t OfflineTilePyramidRegionDefinition::tileCount(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    double minZ = std::max<double>(util::coveringZoomLevel(minZoom, type, tileSize), zoomRange.min);
+    double maxZ = std::min<double>(util::coveringZoomLevel(maxZoom, type, tileSize), zoomRange.max);
+
+    assert(minZ >= 0);
+    assert(maxZ >= 0);
+    assert(minZ < std::numeric_limits<uint8_t>::max());
+    assert(maxZ < std::numeric_limits<uint8_t>::max());
+
+    uint64_t result = 0;
+
+    for (uint8_t z = minZ; z <= maxZ; z++) {
+        result += util::tileCount(bounds, z);
+    }
+
+    return result;
+}
+
+OfflineRegionSizeEstimator::OfflineRegionSizeEstimator(std::map<uint8_t, uint64_t> averageTileSizes_)
+    : averageTileSizes(std::move(averageTileSizes_)) {
+}
+
+OfflineRegionSizeEstimator::Estimate OfflineRegionSizeEstimator::estimate(
+    const OfflineTilePyramidRegionDefinition& definition, SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    Estimate result;
+
+    for (unsigned z = zoomRange.min; z <= zoomRange.max; z++) {
+        const uint64_t count = definition.tileCount(type, tileSize, { uint8_t(z), uint8_t(z) });
+        result.tileCount += count;
+        result.size += count * averageTileSize(z);
+    }
+
+    return result;
+}
+
+uint64_t OfflineRegionSizeEstimator::averageTileSize(uint8_t z) const {
+    if (averageTileSizes.empty()) {
+        return 0;
+    }
+
+    auto above = averageTileSizes.lower_bound(z);
+    if (above == averageTileSizes.end()) {
+        return std::prev(above)->second;
+    }
+    if (above->first == z || above == averageTileSizes.begin()) {
+        return above->second;
+    }
+
+    auto below = std::prev(above);
+    return z - below->first <= above->first - z ? below->second : above->second;
+}
+
 OfflineRegionDefinition decodeOfflineRegionDefinition(const std::string& region) {
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
     doc.Parse<0>(region.c_str());
@@ -9,8 +9,19 @@
 #include "sqlite3.hpp"
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <tuple>
+
 namespace mbgl {
 
+namespace {
+
+// An estimate of the space an entry takes besides its data: the other columns, the row
+// header, and the index entries.
+const uint64_t entryOverhead = 128;
+
+} // namespace
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
@@ -18,14 +29,24 @@ OfflineDatabase::Statement::~Statement() {
 
 OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
     : path(std::move(path_)),
+      readOnly(false),
       maximumCacheSize(maximumCacheSize_) {
     ensureSchema();
 }
 
+OfflineDatabase::OfflineDatabase(std::string path_, ReadOnly)
+    : path(std::move(path_)),
+      readOnly(true),
+      maximumCacheSize(0) {
+    connect(mapbox::sqlite::ReadOnly);
+}
+
 OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
+        flushAccesses();
+        commitWrites();
         statements.clear();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
@@ -50,7 +71,9 @@ void OfflineDatabase::ensureSchema() {
             case 2: migrateToVersion3(); // fall through
             case 3: // no-op and fall through
             case 4: migrateToVersion5(); // fall through
-            case 5: return;
+            case 5: migrateToVersion6(); // fall through
+            case 6: migrateToVersion7(); // fall through
+            case 7: return;
             default: throw std::runtime_error("unknown schema version");
             }
 
@@ -84,7 +107,7 @@ void OfflineDatabase::ensureSchema() {
         db->exec("PRAGMA journal_mode = DELETE");
         db->exec("PRAGMA synchronous = FULL");
         db->exec(schema);
-        db->exec("PRAGMA user_version = 5");
+        db->exec("PRAGMA user_version = 7");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
@@ -127,6 +150,30 @@ void OfflineDatabase::migrateToVersion5() {
     db->exec("PRAGMA user_version = 5");
 }
 
+void OfflineDatabase::migrateToVersion6() {
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("CREATE TABLE dictionaries ("
+             "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+             "  data BLOB NOT NULL"
+             ")");
+    db->exec("PRAGMA user_version = 6");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("CREATE TABLE region_tile_progress ("
+             "  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,"
+             "  url_template TEXT NOT NULL,"
+             "  tile_count INTEGER NOT NULL,"
+             "  completed BLOB NOT NULL,"
+             "  completed_size INTEGER NOT NULL,"
+             "  UNIQUE (region_id, url_template)"
+             ")");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
     auto it = statements.find(sql);
 
@@ -144,13 +191,98 @@ optional<Response> OfflineDatabase::get(const Resource& resource) {
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
-        assert(resource.tileData);
-        return getTile(*resource.tileData);
+        return getTile(resource);
     } else {
         return getResource(resource);
     }
 }
 
+void OfflineDatabase::markAccessed(const Resource& resource) {
+    if (maxAccessDelay == Duration::zero()) {
+        updateAccessed(resource, util::now());
+        return;
+    }
+
+    if (accesses.empty()) {
+        accessesStart = Clock::now();
+    }
+
+    // Only the latest access of a resource matters.
+    auto it = accesses.find(resource.url);
+    if (it != accesses.end()) {
+        it->second.second = util::now();
+    } else {
+        accesses.emplace(resource.url, std::make_pair(resource, util::now()));
+    }
+
+    if (Clock::now() - accessesStart >= maxAccessDelay) {
+        flushAccesses();
+    }
+}
+
+void OfflineDatabase::flushAccesses() {
+    if (accesses.empty()) {
+        return;
+    }
+
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+
+    for (const auto& access : accesses) {
+        updateAccessed(access.second.first, access.second.second);
+    }
+
+    if (transaction) {
+        transaction->commit();
+    }
+
+    accesses.clear();
+}
+
+void OfflineDatabase::setAccessBatching(Duration maxDelay) {
+    maxAccessDelay = maxDelay;
+
+    if (!accesses.empty() && Clock::now() - accessesStart >= maxAccessDelay) {
+        flushAccesses();
+    }
+}
+
+void OfflineDatabase::updateAccessed(const Resource& resource, Timestamp accessed) {
+    if (resource.kind == Resource::Kind::Tile) {
+        // clang-format off
+        Statement accessedStmt = getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 ");
+        // clang-format on
+
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+        accessedStmt->bind(1, accessed);
+        accessedStmt->bind(2, tile.urlTemplate);
+        accessedStmt->bind(3, tile.pixelRatio);
+        accessedStmt->bind(4, tile.x);
+        accessedStmt->bind(5, tile.y);
+        accessedStmt->bind(6, tile.z);
+        accessedStmt->run();
+    } else {
+        // clang-format off
+        Statement accessedStmt = getStatement(
+            "UPDATE resources SET accessed = ?1 WHERE url = ?2");
+        // clang-format on
+
+        accessedStmt->bind(1, accessed);
+        accessedStmt->bind(2, resource.url);
+        accessedStmt->run();
+    }
+}
+
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) {
     return putInternal(resource, response, true);
 }
@@ -160,19 +292,40 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         return { false, 0 };
     }
 
+    // The put marks the resource as accessed itself.
+    accesses.erase(resource.url);
+
     std::string compressedData;
-    bool compressed = false;
+    int64_t compressed = 0;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
+        std::tie(compressedData, compressed) = compressData(*response.data, resource.kind == Resource::Kind::Tile);
         size = compressed ? compressedData.size() : response.data->size();
     }
 
-    if (evict_ && !evict(size)) {
-        Log::Debug(Event::Database, "Unable to make space for entry");
-        return { false, 0 };
+    if (evict_) {
+        const uint64_t evictedEntries = evictionStats.evictedEntries;
+        const TimePoint start = Clock::now();
+        const bool evicted = evict(size);
+
+        if (evictionStats.evictedEntries != evictedEntries) {
+            const Duration elapsed = Clock::now() - start;
+            evictionStats.evictingPuts++;
+            evictionStats.putEvictionTime += elapsed;
+            evictionStats.maxPutEvictionTime = std::max(evictionStats.maxPutEvictionTime, elapsed);
+        }
+
+        if (!evicted) {
+            Log::Debug(Event::Database, "Unable to make space for entry");
+            return { false, 0 };
+        }
+    }
+
+    // Revalidations leave the stored data as it is.
+    optional<uint64_t> previousSize;
+    if (storedSize && !response.notModified) {
+        previousSize = getEntrySize(resource);
     }
 
     bool inserted;
@@ -188,19 +341,58 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
                 compressed);
     }
 
+    if (storedSize && !response.notModified) {
+        if (previousSize) {
+            *storedSize = *storedSize + size - *previousSize;
+        } else {
+            *storedSize += size + entryOverhead;
+        }
+    }
+
     return { inserted, size };
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE resources SET accessed = ?1 WHERE url = ?2");
-    // clang-format on
+optional<uint64_t> OfflineDatabase::getEntrySize(const Resource& resource) {
+    if (resource.kind == Resource::Kind::Tile) {
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT IFNULL(LENGTH(data), 0) "
+            "FROM tiles "
+            "WHERE url_template = ?1 "
+            "  AND pixel_ratio  = ?2 "
+            "  AND x            = ?3 "
+            "  AND y            = ?4 "
+            "  AND z            = ?5 ");
+        // clang-format on
+
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+        stmt->bind(1, tile.urlTemplate);
+        stmt->bind(2, tile.pixelRatio);
+        stmt->bind(3, tile.x);
+        stmt->bind(4, tile.y);
+        stmt->bind(5, tile.z);
+
+        if (!stmt->run()) {
+            return {};
+        }
+        return uint64_t(stmt->get<int64_t>(0));
+    } else {
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT IFNULL(LENGTH(data), 0) FROM resources WHERE url = ?");
+        // clang-format on
 
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, resource.url);
-    accessedStmt->run();
+        stmt->bind(1, resource.url);
 
+        if (!stmt->run()) {
+            return {};
+        }
+        return uint64_t(stmt->get<int64_t>(0));
+    }
+}
+
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
     // clang-format off
     Statement stmt = getStatement(
         //        0      1        2       3        4
@@ -215,6 +407,10 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
         return {};
     }
 
+    if (!readOnly) {
+        markAccessed(resource);
+    }
+
     Response response;
     uint64_t size = 0;
 
@@ -225,8 +421,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+    } else if (int64_t compressed = stmt->get<int64_t>(4)) {
+        optional<std::string> decompressed = decompressData(*data, compressed);
+        if (!decompressed) {
+            return {};
+        }
+        response.data = std::make_shared<std::string>(std::move(*decompressed));
         size = data->length();
     } else {
         response.data = std::make_shared<std::string>(*data);
@@ -239,7 +439,7 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  int64_t compressed) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -259,8 +459,11 @@ bool OfflineDatabase::putResource(const Resource& resource,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment. A batch of writes already holds that lock.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -292,7 +495,9 @@ bool OfflineDatabase::putResource(const Resource& resource,
 
     update->run();
     if (db->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
@@ -318,30 +523,16 @@ bool OfflineDatabase::putResource(const Resource& resource,
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // clang-format off
-    Statement accessedStmt = getStatement(
-        "UPDATE tiles "
-        "SET accessed       = ?1 "
-        "WHERE url_template = ?2 "
-        "  AND pixel_ratio  = ?3 "
-        "  AND x            = ?4 "
-        "  AND y            = ?5 "
-        "  AND z            = ?6 ");
-    // clang-format on
-
-    accessedStmt->bind(1, util::now());
-    accessedStmt->bind(2, tile.urlTemplate);
-    accessedStmt->bind(3, tile.pixelRatio);
-    accessedStmt->bind(4, tile.x);
-    accessedStmt->bind(5, tile.y);
-    accessedStmt->bind(6, tile.z);
-    accessedStmt->run();
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource& resource) {
+    assert(resource.tileData);
+    const Resource::TileData& tile = *resource.tileData;
 
     // clang-format off
     Statement stmt = getStatement(
@@ -365,6 +556,10 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         return {};
     }
 
+    if (!readOnly) {
+        markAccessed(resource);
+    }
+
     Response response;
     uint64_t size = 0;
 
@@ -375,8 +570,12 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = stmt->get<optional<std::string>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+    } else if (int64_t compressed = stmt->get<int64_t>(4)) {
+        optional<std::string> decompressed = decompressData(*data, compressed);
+        if (!decompressed) {
+            return {};
+        }
+        response.data = std::make_shared<std::string>(std::move(*decompressed));
         size = data->length();
     } else {
         response.data = std::make_shared<std::string>(*data);
@@ -389,7 +588,7 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              int64_t compressed) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -417,8 +616,11 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment. A batch of writes already holds that lock.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -456,7 +658,9 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     update->run();
     if (db->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
@@ -485,7 +689,9 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
@@ -537,6 +743,8 @@ OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, co
 }
 
 void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
+    commitWrites();
+
     // clang-format off
     Statement stmt = getStatement(
         "DELETE FROM regions WHERE id = ?");
@@ -545,8 +753,14 @@ void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
     stmt->bind(1, region.getID());
     stmt->run();
 
-    evict(0);
-    db->exec("PRAGMA incremental_vacuum");
+    // Entries used only by this region are now part of the ambient cache.
+    if (incrementalEviction) {
+        vacuumPending = true;
+    } else {
+        evict(0);
+        db->exec("PRAGMA incremental_vacuum");
+        vacuumPending = false;
+    }
 
     // Ensure that the cached offlineTileCount value is recalculated.
     offlineMapboxTileCount = {};
@@ -563,6 +777,11 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64
 }
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    if (maxBatchWrites > 1 && !batch) {
+        batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+        batchStart = Clock::now();
+    }
+
     uint64_t size = putInternal(resource, response, false).second;
     bool previouslyUnused = markUsed(regionID, resource);
 
@@ -573,9 +792,179 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& re
         *offlineMapboxTileCount += 1;
     }
 
+    if (batch && (++batchWrites >= maxBatchWrites || Clock::now() - batchStart >= maxBatchDelay)) {
+        commitWrites();
+    }
+
     return size;
 }
 
+void OfflineDatabase::setWriteBatching(std::size_t maxWrites, Duration maxDelay) {
+    maxBatchWrites = std::max<std::size_t>(maxWrites, 1);
+    maxBatchDelay = maxDelay;
+
+    if (batch && batchWrites >= maxBatchWrites) {
+        commitWrites();
+    }
+}
+
+void OfflineDatabase::commitWrites() {
+    if (!batch) {
+        return;
+    }
+
+    // If the commit fails, the transaction is rolled back as it is destroyed.
+    std::unique_ptr<mapbox::sqlite::Transaction> transaction = std::move(batch);
+    batchWrites = 0;
+    transaction->commit();
+}
+
+void OfflineDatabase::setWriteAheadLogging(bool enabled) {
+    // The journal mode can't be changed within a transaction.
+    commitWrites();
+
+    if (enabled) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    } else {
+        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA synchronous = FULL");
+    }
+}
+
+void OfflineDatabase::setCompression(util::Codec codec_) {
+    if (!util::isSupported(codec_)) {
+        Log::Warning(Event::Database, "Unsupported compression codec %d", int(codec_));
+        return;
+    }
+
+    codec = codec_;
+    tileDictionary = {};
+
+    if (codec == util::Codec::Zstd) {
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT MAX(id) FROM dictionaries");
+        // clang-format on
+
+        stmt->run();
+        tileDictionary = stmt->get<optional<int64_t>>(0);
+    }
+}
+
+bool OfflineDatabase::trainTileDictionary(std::size_t sampleCount, std::size_t maxSize) {
+    if (!util::isSupported(util::Codec::Zstd)) {
+        return false;
+    }
+
+    flushAccesses();
+
+    std::vector<std::string> samples;
+    {
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT data, compressed "
+            "FROM tiles "
+            "WHERE data IS NOT NULL "
+            "ORDER BY accessed DESC "
+            "LIMIT ?1 ");
+        // clang-format on
+
+        stmt->bind(1, int64_t(sampleCount));
+        while (stmt->run()) {
+            std::string data = stmt->get<std::string>(0);
+            if (int64_t compressed = stmt->get<int64_t>(1)) {
+                if (optional<std::string> decompressed = decompressData(data, compressed)) {
+                    samples.push_back(std::move(*decompressed));
+                }
+            } else {
+                samples.push_back(std::move(data));
+            }
+        }
+    }
+
+    std::string dictionary = util::CompressionDictionary::train(samples, maxSize);
+    if (dictionary.empty()) {
+        return false;
+    }
+
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT INTO dictionaries (data) VALUES (?1)");
+    // clang-format on
+
+    insert->bindBlob(1, dictionary.data(), dictionary.size(), false);
+    insert->run();
+
+    const int64_t id = db->lastInsertRowid();
+    dictionaries.emplace(id, std::make_shared<util::CompressionDictionary>(std::move(dictionary)));
+
+    if (codec == util::Codec::Zstd) {
+        tileDictionary = id;
+    }
+
+    return true;
+}
+
+std::pair<std::string, int64_t> OfflineDatabase::compressData(const std::string& data, bool tile) {
+    if (codec == util::Codec::None) {
+        return { std::string(), 0 };
+    }
+
+    int64_t compressed = int64_t(codec);
+    std::shared_ptr<const util::CompressionDictionary> dictionary;
+
+    if (tile && tileDictionary) {
+        dictionary = getDictionary(*tileDictionary);
+        compressed |= *tileDictionary << 8;
+    }
+
+    std::string result = util::compress(data, codec, dictionary.get());
+    if (result.size() >= data.size()) {
+        return { std::string(), 0 };
+    }
+
+    return { std::move(result), compressed };
+}
+
+optional<std::string> OfflineDatabase::decompressData(const std::string& data, int64_t compressed) {
+    const auto codec_ = util::Codec(compressed & 0xFF);
+    const int64_t dictionaryID = compressed >> 8;
+
+    std::shared_ptr<const util::CompressionDictionary> dictionary;
+    if (dictionaryID) {
+        dictionary = getDictionary(dictionaryID);
+    }
+
+    if (!util::isSupported(codec_) || (dictionaryID && !dictionary)) {
+        Log::Warning(Event::Database, "Unable to decompress data stored with codec %d", int(compressed));
+        return {};
+    }
+
+    return util::decompress(data, codec_, dictionary.get());
+}
+
+std::shared_ptr<const util::CompressionDictionary> OfflineDatabase::getDictionary(int64_t id) {
+    auto it = dictionaries.find(id);
+    if (it != dictionaries.end()) {
+        return it->second;
+    }
+
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT data FROM dictionaries WHERE id = ?1");
+    // clang-format on
+
+    stmt->bind(1, id);
+    if (!stmt->run()) {
+        return nullptr;
+    }
+
+    auto dictionary = std::make_shared<util::CompressionDictionary>(stmt->get<std::string>(0));
+    dictionaries.emplace(id, dictionary);
+    return dictionary;
+}
+
 bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         // clang-format off
@@ -655,6 +1044,44 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
     }
 }
 
+optional<OfflineDatabase::TileProgress> OfflineDatabase::getRegionTileProgress(int64_t regionID, const std::string& urlTemplate) {
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT tile_count, completed, completed_size "
+        "FROM region_tile_progress "
+        "WHERE region_id = ?1 "
+        "  AND url_template = ?2 ");
+    // clang-format on
+
+    stmt->bind(1, regionID);
+    stmt->bind(2, urlTemplate);
+
+    if (!stmt->run()) {
+        return {};
+    }
+
+    TileProgress progress;
+    progress.tileCount = stmt->get<int64_t>(0);
+    progress.completed = stmt->get<std::vector<uint8_t>>(1);
+    progress.completedSize = stmt->get<int64_t>(2);
+    return progress;
+}
+
+void OfflineDatabase::putRegionTileProgress(int64_t regionID, const std::string& urlTemplate, const TileProgress& progress) {
+    // clang-format off
+    Statement stmt = getStatement(
+        "INSERT OR REPLACE INTO region_tile_progress (region_id, url_template, tile_count, completed, completed_size) "
+        "VALUES                                      (?1,        ?2,           ?3,         ?4,        ?5) ");
+    // clang-format on
+
+    stmt->bind(1, regionID);
+    stmt->bind(2, urlTemplate);
+    stmt->bind(3, int64_t(progress.tileCount));
+    stmt->bindBlob(4, progress.completed);
+    stmt->bind(5, int64_t(progress.completedSize));
+    stmt->run();
+}
+
 OfflineRegionDefinition OfflineDatabase::getRegionDefinition(int64_t regionID) {
     // clang-format off
     Statement stmt = getStatement(
@@ -707,6 +1134,22 @@ std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_
     return { stmt->get<int64_t>(0), stmt->get<int64_t>(1) };
 }
 
+std::map<uint8_t, uint64_t> OfflineDatabase::getAverageTileSizes() {
+    // Tiles without data count as empty, as they do toward the completed size of a region.
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT z, IFNULL(SUM(LENGTH(data)), 0) / COUNT(*) "
+        "FROM tiles "
+        "GROUP BY z");
+    // clang-format on
+
+    std::map<uint8_t, uint64_t> result;
+    while (stmt->run()) {
+        result.emplace(stmt->get<int>(0), stmt->get<int64_t>(1));
+    }
+    return result;
+}
+
 template <class T>
 T OfflineDatabase::getPragma(const char * sql) {
     Statement stmt = getStatement(sql);
@@ -714,61 +1157,55 @@ T OfflineDatabase::getPragma(const char * sql) {
     return stmt->get<T>(0);
 }
 
-// Remove least-recently used resources and tiles until the used database size,
-// as calculated by multiplying the number of in-use pages by the page size, is
-// less than the maximum cache size. Returns false if this condition cannot be
-// satisfied.
-//
-// SQLite database never shrinks in size unless we call VACCUM. We here
-// are monitoring the soft limit (i.e. number of free pages in the file)
-// and as it approaches to the hard limit (i.e. the actual file size) we
-// delete an arbitrary number of old cache entries. The free pages approach saves
-// us from calling VACCUM or keeping a running total, which can be costly.
-bool OfflineDatabase::evict(uint64_t neededFreeSize) {
-    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+uint64_t OfflineDatabase::getStoredSize() {
+    if (storedSize) {
+        return *storedSize;
+    }
 
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT "
+        "  (SELECT COUNT(*) * ?1 + IFNULL(SUM(LENGTH(data)), 0) FROM resources) + "
+        "  (SELECT COUNT(*) * ?1 + IFNULL(SUM(LENGTH(data)), 0) FROM tiles) ");
+    // clang-format on
 
-    // The addition of pageSize is a fudge factor to account for non `data` column
-    // size, and because pages can get fragmented on the database.
-    while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        Statement stmt1 = getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") ");
-        // clang-format on
-        stmt1->bind(1, 50);
-        stmt1->run();
-        uint64_t changes1 = db->changes();
+    stmt->bind(1, int64_t(entryOverhead));
+    stmt->run();
 
-        // clang-format off
-        Statement stmt2 = getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") ");
-        // clang-format on
-        stmt2->bind(1, 50);
-        stmt2->run();
-        uint64_t changes2 = db->changes();
+    storedSize = stmt->get<int64_t>(0);
+    return *storedSize;
+}
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
+// Like getStoredSize(), but only of the entries that no region uses. It is measured rather
+// than kept up to date, which takes a scan of both tables.
+uint64_t OfflineDatabase::getAmbientSize() {
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT "
+        "  (SELECT COUNT(*) * ?1 + IFNULL(SUM(LENGTH(data)), 0) FROM resources "
+        "   LEFT JOIN region_resources ON resource_id = resources.id "
+        "   WHERE resource_id IS NULL) + "
+        "  (SELECT COUNT(*) * ?1 + IFNULL(SUM(LENGTH(data)), 0) FROM tiles "
+        "   LEFT JOIN region_tiles ON tile_id = tiles.id "
+        "   WHERE tile_id IS NULL) ");
+    // clang-format on
 
-        if (changes1 == 0 && changes2 == 0) {
+    stmt->bind(1, int64_t(entryOverhead));
+    stmt->run();
+    return stmt->get<int64_t>(0);
+}
+
+// Remove least-recently used resources and tiles until the stored size is less than the
+// maximum cache size. Returns false if this condition cannot be satisfied.
+//
+// The stored size is a running total rather than a count of the pages in use, which would
+// take two pragma queries for every chunk of entries evicted. It counts the stored data of
+// all entries, including those of offline regions, plus an estimate of the space taken by
+// the other columns and the indices; the extra overhead of one entry leaves room for the
+// fragmentation of pages.
+bool OfflineDatabase::evict(uint64_t neededFreeSize) {
+    while (getStoredSize() + neededFreeSize + entryOverhead > maximumCacheSize) {
+        if (evictChunk(50) == 0) {
             return false;
         }
     }
@@ -776,6 +1213,124 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     return true;
 }
 
+bool OfflineDatabase::evictIncrementally(Duration budget) {
+    const TimePoint start = Clock::now();
+    const TimePoint deadline = start + budget;
+
+    // Evicting below the maximum leaves room for puts that don't have to evict.
+    const uint64_t target = maximumCacheSize - maximumCacheSize / 8;
+
+    // Entries of regions can't be evicted, so the target applies to the ambient cache alone.
+    // Otherwise large regions would have every idle pass empty the ambient cache.
+    uint64_t ambientSize = getStoredSize() > target ? getAmbientSize() : 0;
+
+    bool evicting = ambientSize > target;
+    while (Clock::now() < deadline) {
+        // Small chunks keep each transaction, and the time readers wait for it, short.
+        if (evicting && ambientSize > target) {
+            const uint64_t before = getStoredSize();
+            if (evictChunk(16) != 0) {
+                ambientSize -= std::min(ambientSize, before - getStoredSize());
+                continue;
+            }
+        }
+        evicting = false;
+
+        if (!vacuumPending || getPragma<int64_t>("PRAGMA freelist_count") == 0) {
+            vacuumPending = false;
+            break;
+        }
+        db->exec("PRAGMA incremental_vacuum(64)");
+    }
+
+    evictionStats.incrementalEvictionTime += Clock::now() - start;
+    return evicting || vacuumPending;
+}
+
+uint64_t OfflineDatabase::evictChunk(int64_t limit) {
+    // Eviction relies on up to date access times.
+    flushAccesses();
+
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+
+    // Selecting the entries before deleting them tells how much data they held.
+    // clang-format off
+    Statement resources = getStatement(
+        "SELECT id, IFNULL(LENGTH(data), 0) FROM resources "
+        "LEFT JOIN region_resources "
+        "ON resource_id = resources.id "
+        "WHERE resource_id IS NULL "
+        "ORDER BY accessed ASC LIMIT ?1 ");
+    // clang-format on
+
+    std::vector<std::pair<int64_t, int64_t>> resourceEntries;
+    resources->bind(1, limit);
+    while (resources->run()) {
+        resourceEntries.emplace_back(resources->get<int64_t>(0), resources->get<int64_t>(1));
+    }
+
+    // clang-format off
+    Statement tiles = getStatement(
+        "SELECT id, IFNULL(LENGTH(data), 0) FROM tiles "
+        "LEFT JOIN region_tiles "
+        "ON tile_id = tiles.id "
+        "WHERE tile_id IS NULL "
+        "ORDER BY accessed ASC LIMIT ?1 ");
+    // clang-format on
+
+    std::vector<std::pair<int64_t, int64_t>> tileEntries;
+    tiles->bind(1, limit);
+    while (tiles->run()) {
+        tileEntries.emplace_back(tiles->get<int64_t>(0), tiles->get<int64_t>(1));
+    }
+
+    uint64_t bytes = 0;
+
+    // clang-format off
+    Statement deleteResource = getStatement(
+        "DELETE FROM resources WHERE id = ?");
+    // clang-format on
+
+    for (const auto& entry : resourceEntries) {
+        deleteResource->bind(1, entry.first);
+        deleteResource->run();
+        deleteResource->reset();
+        bytes += entry.second;
+    }
+
+    // clang-format off
+    Statement deleteTile = getStatement(
+        "DELETE FROM tiles WHERE id = ?");
+    // clang-format on
+
+    for (const auto& entry : tileEntries) {
+        deleteTile->bind(1, entry.first);
+        deleteTile->run();
+        deleteTile->reset();
+        bytes += entry.second;
+    }
+
+    if (transaction) {
+        transaction->commit();
+    }
+
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
+
+    const uint64_t entries = resourceEntries.size() + tileEntries.size();
+    if (storedSize) {
+        *storedSize -= std::min(*storedSize, bytes + entries * entryOverhead);
+    }
+
+    evictionStats.evictedEntries += entries;
+    evictionStats.evictedBytes += bytes;
+
+    return entries;
+}
+
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
     offlineMapboxTileCountLimit = limit;
 }
@@ -6,15 +6,20 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/compression.hpp>
 
 #include <unordered_map>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
 class Database;
 class Statement;
+class Transaction;
 } // namespace sqlite
 } // namespace mapbox
 
@@ -28,10 +33,32 @@ public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
     OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+
+    // Opens a read-only connection to an existing database, so that resources can be looked
+    // up on other threads while this one writes. Lookups through a read-only connection
+    // don't mark resources as accessed; call `markAccessed` on a writable one instead.
+    struct ReadOnly {};
+    OfflineDatabase(std::string path, ReadOnly);
+
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
 
+    // Records that the resource was used, for least-recently-used eviction. Lookups of
+    // resources that are found do so as well.
+    void markAccessed(const Resource&);
+
+    // Keeps the access times recorded by `markAccessed` in memory, and writes them in one
+    // transaction once the oldest is `maxDelay` old, rather than writing each as it happens.
+    // They are also written before evicting, and by `flushAccesses`. Until then, other
+    // connections see older access times. A `maxDelay` of zero, the default, disables this.
+    void setAccessBatching(Duration maxDelay);
+    Duration getAccessBatchDelay() const { return maxAccessDelay; }
+
+    // Whether access times are waiting to be written, and writes them.
+    bool hasUnflushedAccesses() const { return !accesses.empty(); }
+    void flushAccesses();
+
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
@@ -48,9 +75,70 @@ public:
     optional<std::pair<Response, uint64_t>> getRegionResource(int64_t regionID, const Resource&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
 
+    // The tiles of a tileset that a region is known to have stored, as a bitmap over the tiles
+    // in the order they are downloaded, so that a download can resume without looking up
+    // every tile. Only tiles that `getRegionResource` or `putRegionResource` recorded as used by
+    // the region may be marked as completed.
+    struct TileProgress {
+        uint64_t tileCount = 0;
+        std::vector<uint8_t> completed;
+        uint64_t completedSize = 0;
+    };
+
+    optional<TileProgress> getRegionTileProgress(int64_t regionID, const std::string& urlTemplate);
+    void putRegionTileProgress(int64_t regionID, const std::string& urlTemplate, const TileProgress&);
+
     OfflineRegionDefinition getRegionDefinition(int64_t regionID);
     OfflineRegionStatus getRegionCompletedStatus(int64_t regionID);
 
+    // The average size of the stored tiles of each zoom level, for OfflineRegionSizeEstimator.
+    std::map<uint8_t, uint64_t> getAverageTileSizes();
+
+    // Commits the writes of `putRegionResource` in transactions of up to `maxWrites` writes,
+    // each committed at most `maxDelay` after it began, instead of one transaction per write.
+    // While a batch is open, the database is locked for writing by other connections.
+    // A `maxWrites` of 1, the default, disables batching.
+    void setWriteBatching(std::size_t maxWrites, Duration maxDelay);
+    Duration getWriteBatchDelay() const { return maxBatchDelay; }
+
+    // Whether batched writes are waiting to be committed, and commits them.
+    bool hasUncommittedWrites() const { return bool(batch); }
+    void commitWrites();
+
+    // Switches the database to a write-ahead log with `synchronous = NORMAL`, which avoids
+    // most fsyncs at the risk of losing the latest commits on power failure, or back to the
+    // default rollback journal with `synchronous = FULL`. The journal mode is stored in the
+    // database file.
+    void setWriteAheadLogging(bool);
+
+    // The codec with which data is compressed as it is stored; Codec::Zlib by default. Data
+    // that doesn't get smaller is stored uncompressed. Stored data is always decompressed with
+    // the codec it was compressed with, and treated as missing if that codec isn't supported.
+    void setCompression(util::Codec);
+    util::Codec getCompression() const { return codec; }
+
+    // Trains a compression dictionary of at most `maxSize` bytes on up to `sampleCount` of the
+    // most recently used tiles, and stores it. Tiles stored from then on with Codec::Zstd are
+    // compressed with it. Returns false if zstd isn't supported or there are too few tiles.
+    bool trainTileDictionary(std::size_t sampleCount = 1000, std::size_t maxSize = 112640);
+
+    // With incremental eviction, deleting a region leaves the entries it no longer needs, and
+    // the pages they free, to `evictIncrementally` rather than evicting and vacuuming at once.
+    // Puts still evict synchronously if they would otherwise exceed the maximum cache size.
+    void setIncrementalEviction(bool enabled) { incrementalEviction = enabled; }
+
+    // Evicts least-recently used entries until the ambient cache, not counting the entries of
+    // regions, is an eighth below the maximum cache size, and then returns free pages to the
+    // file system, for roughly `budget`.
+    // Return value is true iff there is work left for another call.
+    bool evictIncrementally(Duration budget);
+
+    OfflineEvictionStats getEvictionStats() const { return evictionStats; }
+
+    // The size of the stored data plus an estimated overhead per entry, which is kept up to
+    // date as entries are stored and evicted rather than measured by querying the database.
+    uint64_t getStoredSize();
+
     void setOfflineMapboxTileCountLimit(uint64_t);
     uint64_t getOfflineMapboxTileCountLimit();
     bool offlineMapboxTileCountLimitExceeded();
@@ -63,6 +151,8 @@ private:
     void removeExisting();
     void migrateToVersion3();
     void migrateToVersion5();
+    void migrateToVersion6();
+    void migrateToVersion7();
 
     class Statement {
     public:
@@ -79,17 +169,29 @@ private:
 
     Statement getStatement(const char *);
 
-    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
+    optional<std::pair<Response, uint64_t>> getTile(const Resource&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, int64_t compressed);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, int64_t compressed);
+
+    void updateAccessed(const Resource&, Timestamp);
 
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
 
+    // The `compressed` column holds the codec in its low 8 bits and the ID of the dictionary,
+    // if any, above them. Return value is (compressed data, compressed), or an empty string and
+    // 0 if the data is best stored uncompressed.
+    std::pair<std::string, int64_t> compressData(const std::string&, bool tile);
+
+    // Returns nothing if the codec or dictionary isn't available.
+    optional<std::string> decompressData(const std::string&, int64_t compressed);
+
+    std::shared_ptr<const util::CompressionDictionary> getDictionary(int64_t id);
+
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
 
@@ -97,6 +199,7 @@ private:
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     const std::string path;
+    const bool readOnly;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unordered_map<const char *, std::unique_ptr<::mapbox::sqlite::Statement>> statements;
 
@@ -109,6 +212,34 @@ private:
     optional<uint64_t> offlineMapboxTileCount;
 
     bool evict(uint64_t neededFreeSize);
+    uint64_t getAmbientSize();
+
+    // Evicts up to `limit` least-recently used entries of each table that no region uses.
+    // Return value is the number of entries evicted.
+    uint64_t evictChunk(int64_t limit);
+
+    // Return value is the size of the stored data of the resource, if it is stored.
+    optional<uint64_t> getEntrySize(const Resource&);
+
+    optional<uint64_t> storedSize;
+    bool incrementalEviction = false;
+    bool vacuumPending = false;
+    OfflineEvictionStats evictionStats;
+
+    util::Codec codec = util::Codec::Zlib;
+    optional<int64_t> tileDictionary;
+    std::unordered_map<int64_t, std::shared_ptr<const util::CompressionDictionary>> dictionaries;
+
+    // Pending access times, by URL.
+    std::unordered_map<std::string, std::pair<Resource, Timestamp>> accesses;
+    TimePoint accessesStart;
+    Duration maxAccessDelay = Duration::zero();
+
+    std::unique_ptr<mapbox::sqlite::Transaction> batch;
+    std::size_t batchWrites = 0;
+    TimePoint batchStart;
+    std::size_t maxBatchWrites = 1;
+    Duration maxBatchDelay = Duration::zero();
 };
 
 } // namespace mbgl
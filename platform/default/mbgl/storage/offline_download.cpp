@@ -13,10 +13,58 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <algorithm>
 #include <set>
+#include <tuple>
 
 namespace mbgl {
 
+namespace {
+
+// The scheme and authority of the URL, e.g. "http://127.0.0.1:3000".
+std::string hostOf(const std::string& url) {
+    const std::size_t authority = url.find("://");
+    if (authority == std::string::npos) {
+        return {};
+    }
+    return url.substr(0, url.find('/', authority + 3));
+}
+
+// The position of the tile along a Hilbert curve through the tiles of its zoom level, which
+// mostly keeps tiles that are close together close in order too.
+uint64_t hilbertIndex(const CanonicalTileID& tile) {
+    const uint64_t n = uint64_t(1) << tile.z;
+    uint64_t x = tile.x;
+    uint64_t y = tile.y;
+    uint64_t index = 0;
+
+    for (uint64_t s = n / 2; s > 0; s /= 2) {
+        const uint64_t rx = (x & s) ? 1 : 0;
+        const uint64_t ry = (y & s) ? 1 : 0;
+        index += s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so that the curve continues from where it left off.
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return index;
+}
+
+uint64_t tileKey(uint8_t z, uint32_t x, uint32_t y) {
+    return (uint64_t(z) << 56) | (uint64_t(x) << 28) | y;
+}
+
+// Tiles completed between saves of the progress of a download.
+const std::size_t tileProgressSaveInterval = 256;
+
+} // namespace
+
 OfflineDownload::OfflineDownload(int64_t id_,
                                  OfflineRegionDefinition&& definition_,
                                  OfflineDatabase& offlineDatabase_,
@@ -24,7 +72,9 @@ OfflineDownload::OfflineDownload(int64_t id_,
     : id(id_),
       definition(definition_),
       offlineDatabase(offlineDatabase_),
-      onlineFileSource(onlineFileSource_) {
+      onlineFileSource(onlineFileSource_),
+      maxRequests(HTTPFileSource::maximumConcurrentRequests()),
+      maxRequestsPerHost(HTTPFileSource::maximumConcurrentRequests()) {
     setObserver(nullptr);
 }
 
@@ -50,6 +100,15 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     observer->statusChanged(status);
 }
 
+void OfflineDownload::setConcurrency(std::size_t maxRequests_, std::size_t maxRequestsPerHost_) {
+    maxRequests = std::max<std::size_t>(maxRequests_, 1);
+    maxRequestsPerHost = std::max<std::size_t>(maxRequestsPerHost_, 1);
+
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        continueDownload();
+    }
+}
+
 OfflineRegionStatus OfflineDownload::getStatus() const {
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         return status;
@@ -81,15 +140,15 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 
             if (urlOrTileset.is<Tileset>()) {
                 result.requiredResourceCount +=
-                    definition.tileCover(type, tileSize, urlOrTileset.get<Tileset>().zoomRange).size();
+                    definition.tileCount(type, tileSize, urlOrTileset.get<Tileset>().zoomRange);
             } else {
                 result.requiredResourceCount += 1;
                 const std::string& url = urlOrTileset.get<std::string>();
                 optional<Response> sourceResponse = offlineDatabase.get(Resource::source(url));
                 if (sourceResponse) {
                     result.requiredResourceCount +=
-                        definition.tileCover(type, tileSize, style::TileSourceImpl::parseTileJSON(
-                            *sourceResponse->data, url, type, tileSize).zoomRange).size();
+                        definition.tileCount(type, tileSize, style::TileSourceImpl::parseTileJSON(
+                            *sourceResponse->data, url, type, tileSize).zoomRange);
                 } else {
                     result.requiredResourceCountIsPrecise = false;
                 }
@@ -217,38 +276,159 @@ void OfflineDownload::activateDownload() {
    the first few errors is fruitless anyway.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    if (!hasResourcesRemaining() && status.complete()) {
         setState(OfflineRegionDownloadState::Inactive);
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < HTTPFileSource::maximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
-        resourcesRemaining.pop_front();
+    // Take one resource from each host in turn, skipping hosts that have as many requests in
+    // progress as allowed.
+    bool requested = true;
+    while (requested && requests.size() < maxRequests) {
+        requested = false;
+        for (auto& host : hosts) {
+            if (requests.size() >= maxRequests) {
+                break;
+            }
+            if (host.second.resourcesRemaining.empty() || host.second.requests >= maxRequestsPerHost) {
+                continue;
+            }
+            Resource resource = std::move(host.second.resourcesRemaining.front());
+            host.second.resourcesRemaining.pop_front();
+            ensureResource(resource);
+            requested = true;
+        }
     }
 }
 
 void OfflineDownload::deactivateDownload() {
     requiredSourceURLs.clear();
-    resourcesRemaining.clear();
+    hosts.clear();
     requests.clear();
+
+    commitTimer.stop();
+    saveTileProgress();
+    offlineDatabase.commitWrites();
+}
+
+bool OfflineDownload::hasResourcesRemaining() const {
+    return std::any_of(hosts.begin(), hosts.end(), [] (const auto& host) {
+        return !host.second.resourcesRemaining.empty();
+    });
+}
+
+void OfflineDownload::releaseHost(const Resource& resource) {
+    auto it = hosts.find(hostOf(resource.url));
+    if (it != hosts.end() && it->second.requests > 0) {
+        it->second.requests--;
+    }
 }
 
 void OfflineDownload::queueResource(Resource resource) {
     status.requiredResourceCount++;
-    resourcesRemaining.push_front(std::move(resource));
+    std::string host = hostOf(resource.url);
+    hosts[host].resourcesRemaining.push_front(std::move(resource));
 }
 
 void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    for (const auto& tile : definition.tileCover(type, tileSize, tileset.zoomRange)) {
-        status.requiredResourceCount++;
-        resourcesRemaining.push_back(
-            Resource::tile(tileset.tiles[0], definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme));
+    std::vector<CanonicalTileID> tiles = definition.tileCover(type, tileSize, tileset.zoomRange);
+
+    // Tiles that are close together are requested, and so stored, close together.
+    std::sort(tiles.begin(), tiles.end(), [] (const CanonicalTileID& a, const CanonicalTileID& b) {
+        return std::make_tuple(a.z, hilbertIndex(a)) < std::make_tuple(b.z, hilbertIndex(b));
+    });
+
+    const std::string& urlTemplate = tileset.tiles[0];
+    const std::size_t bitmapSize = (tiles.size() + 7) / 8;
+
+    TileProgress& progress = tileProgress[urlTemplate];
+    progress.remaining.clear();
+    progress.changed = false;
+
+    // A bitmap of a different number of tiles is of a different tileset.
+    optional<OfflineDatabase::TileProgress> stored = offlineDatabase.getRegionTileProgress(id, urlTemplate);
+    if (stored && stored->tileCount == tiles.size() && stored->completed.size() == bitmapSize) {
+        progress.stored = std::move(*stored);
+    } else {
+        progress.stored = OfflineDatabase::TileProgress();
+        progress.stored.tileCount = tiles.size();
+        progress.stored.completed.assign(bitmapSize, 0);
+    }
+
+    status.requiredResourceCount += tiles.size();
+
+    uint64_t completed = 0;
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        const CanonicalTileID& tile = tiles[i];
+        if (progress.stored.completed[i / 8] & (1 << (i % 8))) {
+            completed++;
+            continue;
+        }
+
+        progress.remaining.emplace(tileKey(tile.z, tile.x, tile.y), i);
+        Resource resource = Resource::tile(urlTemplate, definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme);
+        if (tileset.tiles.size() > 1) {
+            // Tiles are stored under the first URL template, which maps request them with, but
+            // fetched from the hosts of all templates in turn.
+            const std::string& hostTemplate = tileset.tiles[i % tileset.tiles.size()];
+            resource.url = Resource::tile(hostTemplate, definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme).url;
+        }
+        std::string host = hostOf(resource.url);
+        hosts[host].resourcesRemaining.push_back(std::move(resource));
+    }
+
+    if (completed) {
+        status.completedResourceCount += completed;
+        status.completedResourceSize += progress.stored.completedSize;
+        status.completedTileCount += completed;
+        status.completedTileSize += progress.stored.completedSize;
+        observer->statusChanged(status);
     }
 }
 
+void OfflineDownload::markTileCompleted(const Resource& resource, uint64_t size) {
+    if (resource.kind != Resource::Kind::Tile) {
+        return;
+    }
+
+    const Resource::TileData& tile = *resource.tileData;
+    auto progress = tileProgress.find(tile.urlTemplate);
+    if (progress == tileProgress.end()) {
+        return;
+    }
+
+    auto it = progress->second.remaining.find(tileKey(tile.z, tile.x, tile.y));
+    if (it == progress->second.remaining.end()) {
+        return;
+    }
+
+    const std::size_t i = it->second;
+    progress->second.remaining.erase(it);
+    progress->second.stored.completed[i / 8] |= uint8_t(1 << (i % 8));
+    progress->second.stored.completedSize += size;
+    progress->second.changed = true;
+
+    if (++unsavedTiles >= tileProgressSaveInterval) {
+        saveTileProgress();
+    }
+}
+
+// Within a batch of writes, the progress is committed along with the tiles it covers;
+// otherwise those tiles have been committed already.
+void OfflineDownload::saveTileProgress() {
+    for (auto& progress : tileProgress) {
+        if (progress.second.changed) {
+            offlineDatabase.putRegionTileProgress(id, progress.first, progress.second.stored);
+            progress.second.changed = false;
+        }
+    }
+    unsavedTiles = 0;
+}
+
 void OfflineDownload::ensureResource(const Resource& resource,
                                      std::function<void(Response)> callback) {
+    hosts[hostOf(resource.url)].requests++;
+
     auto workRequestsIt = requests.insert(requests.begin(), nullptr);
     *workRequestsIt = util::RunLoop::Get()->invokeCancellable([=]() {
         requests.erase(workRequestsIt);
@@ -256,6 +436,9 @@ void OfflineDownload::ensureResource(const Resource& resource,
         optional<std::pair<Response, uint64_t>> offlineResponse =
             offlineDatabase.getRegionResource(id, resource);
         if (offlineResponse) {
+            releaseHost(resource);
+            markTileCompleted(resource, offlineResponse->second);
+
             if (callback) {
                 callback(offlineResponse->first);
             }
@@ -276,14 +459,19 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
+        // Downloads give way to the requests of maps in use.
+        Resource onlineResource = resource;
+        onlineResource.priority = Resource::Priority::Low;
+
         auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
+        *fileRequestsIt = onlineFileSource.request(onlineResource, [=](Response onlineResponse) {
             if (onlineResponse.error) {
                 observer->responseError(*onlineResponse.error);
                 return;
             }
 
             requests.erase(fileRequestsIt);
+            releaseHost(resource);
 
             if (callback) {
                 callback(onlineResponse);
@@ -291,6 +479,13 @@ void OfflineDownload::ensureResource(const Resource& resource,
 
             status.completedResourceCount++;
             uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
+            markTileCompleted(resource, resourceSize);
+            if (offlineDatabase.hasUncommittedWrites()) {
+                commitTimer.start(offlineDatabase.getWriteBatchDelay(), Duration::zero(), [&] {
+                    saveTileProgress();
+                    offlineDatabase.commitWrites();
+                });
+            }
             status.completedResourceSize += resourceSize;
             if (resource.kind == Resource::Kind::Tile) {
                 status.completedTileCount += 1;
@@ -1,16 +1,19 @@
 #pragma once
 
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/util/timer.hpp>
 
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <deque>
 
 namespace mbgl {
 
-class OfflineDatabase;
 class FileSource;
 class AsyncRequest;
 class Response;
@@ -35,6 +38,11 @@ public:
 
     OfflineRegionStatus getStatus() const;
 
+    // Requests at most `maxRequests` resources at a time, and at most `maxRequestsPerHost` of
+    // them from any one host, taking resources from each host in turn so that a slow host
+    // doesn't hold up the others. Both default to HTTPFileSource::maximumConcurrentRequests().
+    void setConcurrency(std::size_t maxRequests, std::size_t maxRequestsPerHost);
+
 private:
     void activateDownload();
     void continueDownload();
@@ -57,7 +65,36 @@ private:
 
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::unordered_set<std::string> requiredSourceURLs;
-    std::deque<Resource> resourcesRemaining;
+
+    // Resources waiting to be requested from a host, and the resources of that host being
+    // looked up or requested.
+    struct Host {
+        std::deque<Resource> resourcesRemaining;
+        std::size_t requests = 0;
+    };
+    std::map<std::string, Host> hosts;
+    std::size_t maxRequests;
+    std::size_t maxRequestsPerHost;
+
+    bool hasResourcesRemaining() const;
+    void releaseHost(const Resource&);
+
+    // The tiles of each tileset, by URL template, known to be stored, and the position in the
+    // bitmap of each tile that isn't yet. Saved to the database every so often, and when the
+    // download is deactivated, so that it can resume without looking up completed tiles.
+    struct TileProgress {
+        OfflineDatabase::TileProgress stored;
+        std::unordered_map<uint64_t, std::size_t> remaining;
+        bool changed = false;
+    };
+    std::unordered_map<std::string, TileProgress> tileProgress;
+    std::size_t unsavedTiles = 0;
+
+    void markTileCompleted(const Resource&, uint64_t size);
+    void saveTileProgress();
+
+    // Commits batched writes once no resource has been stored for the batch delay.
+    util::Timer commitTimer;
 
     void queueResource(Resource);
     void queueTiles(SourceType, uint16_t tileSize, const Tileset&);
@@ -6,7 +6,7 @@ CREATE TABLE resources (                   -- Generic table for style, source, s
   modified INTEGER,
   etag TEXT,
   data BLOB,
-  compressed INTEGER NOT NULL DEFAULT 0,
+  compressed INTEGER NOT NULL DEFAULT 0,    -- util::Codec, plus the dictionary id shifted left by 8 bits
   accessed INTEGER NOT NULL,
   UNIQUE (url)
 );
@@ -22,7 +22,7 @@ CREATE TABLE tiles (
   modified INTEGER,
   etag TEXT,
   data BLOB,
-  compressed INTEGER NOT NULL DEFAULT 0,
+  compressed INTEGER NOT NULL DEFAULT 0,    -- util::Codec, plus the dictionary id shifted left by 8 bits
   accessed INTEGER NOT NULL,
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
@@ -47,6 +47,20 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE dictionaries (                -- Compression dictionaries for tile data.
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  data BLOB NOT NULL
+);
+
+CREATE TABLE region_tile_progress (        -- Tiles of a region known to be stored, to resume its download.
+  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,
+  url_template TEXT NOT NULL,
+  tile_count INTEGER NOT NULL,              -- Number of tiles of the tileset in the region
+  completed BLOB NOT NULL,                  -- Bit i is set if tile i, in download order, is stored
+  completed_size INTEGER NOT NULL,          -- Stored size of those tiles
+  UNIQUE (region_id, url_template)
+);
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
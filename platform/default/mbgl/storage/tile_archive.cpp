@@ -0,0 +1,209 @@
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+
+#include "sqlite3.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mbgl {
+
+namespace {
+
+const char magic[8] = { 'M', 'B', 'G', 'L', 'T', 'I', 'L', 'E' };
+const uint32_t version = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+static_assert(sizeof(Header) == 24, "unexpected header size");
+
+// Gzip is what MBTiles files use for vector tiles.
+bool isCompressed(const std::string& data) {
+    return data.size() >= 2 && uint8_t(data[0]) == 0x1F && uint8_t(data[1]) == 0x8B;
+}
+
+} // namespace
+
+// Like the header, read in place from the mapping, which assumes a little endian host.
+struct TileArchive::Entry {
+    uint64_t key;
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+// Writes the directory once all tiles have been added, in ascending key order.
+class TileArchive::Writer {
+public:
+    Writer(const std::string& path, std::size_t count_)
+        : stream(path, std::ios::binary | std::ios::trunc) {
+        if (!stream.good()) {
+            throw util::IOException(errno, ("failed to open file " + path).c_str());
+        }
+
+        static_assert(sizeof(Entry) == 24, "unexpected entry size");
+
+        const std::size_t directorySize = sizeof(Header) + count_ * sizeof(Entry);
+        directory.reserve(count_);
+        stream.seekp(directorySize);
+        offset = directorySize;
+    }
+
+    void add(uint8_t z, uint32_t x, uint32_t y, const std::string& data) {
+        const uint64_t key = TileArchive::key(z, x, y);
+        if (!directory.empty() && key <= directory.back().key) {
+            throw std::runtime_error("tiles must be added once each, in ascending key order");
+        }
+
+        directory.push_back({ key, offset, uint32_t(data.size()), 0 });
+        stream.write(data.data(), data.size());
+        offset += data.size();
+    }
+
+    void finish() {
+        Header header;
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.reserved = 0;
+        header.count = directory.size();
+
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(Entry));
+        stream.close();
+
+        if (stream.fail()) {
+            throw std::runtime_error("failed to write tile archive");
+        }
+    }
+
+private:
+    std::ofstream stream;
+    std::vector<Entry> directory;
+    uint64_t offset;
+};
+
+TileArchive::TileArchive(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw util::IOException(errno, ("failed to open file " + path).c_str());
+    }
+
+    struct stat buf;
+    if (fstat(fd, &buf) == -1) {
+        const int error = errno;
+        close(fd);
+        throw util::IOException(error, ("failed to stat file " + path).c_str());
+    }
+
+    mappingSize = buf.st_size;
+    void* address = mappingSize ? mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    const int error = errno;
+
+    // The mapping stays valid after the file is closed.
+    close(fd);
+
+    if (address == MAP_FAILED) {
+        throw util::IOException(mappingSize ? error : EINVAL, ("failed to map file " + path).c_str());
+    }
+
+    mapping = static_cast<const char*>(address);
+
+    // Tiles are read in no particular order, so read ahead as little as possible.
+    madvise(address, mappingSize, MADV_RANDOM);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    if (mappingSize >= sizeof(header)) {
+        std::memcpy(&header, mapping, sizeof(header));
+    }
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+        header.count > (mappingSize - sizeof(header)) / sizeof(Entry)) {
+        munmap(address, mappingSize);
+        throw std::runtime_error("not a tile archive: " + path);
+    }
+
+    entries = reinterpret_cast<const Entry*>(mapping + sizeof(header));
+    count = header.count;
+}
+
+TileArchive::~TileArchive() {
+    munmap(const_cast<char*>(mapping), mappingSize);
+}
+
+optional<TileArchive::Data> TileArchive::get(uint8_t z, uint32_t x, uint32_t y) const {
+    if (z > 28 || (x >> z) || (y >> z)) {
+        return {};
+    }
+
+    const uint64_t wanted = key(z, x, y);
+    const Entry* end = entries + count;
+    const Entry* entry = std::lower_bound(entries, end, wanted, [] (const Entry& lhs, uint64_t rhs) {
+        return lhs.key < rhs;
+    });
+
+    if (entry == end || entry->key != wanted || entry->offset + entry->length > mappingSize) {
+        return {};
+    }
+
+    return Data { mapping + entry->offset, entry->length };
+}
+
+void TileArchive::write(const std::string& path, std::vector<Tile> tiles) {
+    std::sort(tiles.begin(), tiles.end(), [] (const Tile& lhs, const Tile& rhs) {
+        return key(lhs.z, lhs.x, lhs.y) < key(rhs.z, rhs.x, rhs.y);
+    });
+
+    Writer writer(path, tiles.size());
+    for (const auto& tile : tiles) {
+        writer.add(tile.z, tile.x, tile.y, isCompressed(tile.data) ? util::decompress(tile.data) : tile.data);
+    }
+    writer.finish();
+}
+
+std::size_t TileArchive::importMBTiles(const std::string& mbtilesPath, const std::string& path) {
+    mapbox::sqlite::Database db(mbtilesPath, mapbox::sqlite::ReadOnly);
+
+    mapbox::sqlite::Statement countStmt = db.prepare("SELECT COUNT(*) FROM tiles");
+    countStmt.run();
+    const auto count = countStmt.get<int64_t>(0);
+
+    // MBTiles rows count from the bottom (TMS); descending rows are ascending tile y.
+    // clang-format off
+    mapbox::sqlite::Statement stmt = db.prepare(
+        "SELECT zoom_level, tile_column, tile_row, tile_data "
+        "FROM tiles "
+        "ORDER BY zoom_level, tile_column, tile_row DESC");
+    // clang-format on
+
+    Writer writer(path, count);
+    std::size_t written = 0;
+    while (stmt.run()) {
+        const auto z = uint8_t(stmt.get<int>(0));
+        const auto x = uint32_t(stmt.get<int64_t>(1));
+        const auto y = uint32_t((int64_t(1) << z) - 1 - stmt.get<int64_t>(2));
+        const std::string data = stmt.get<std::string>(3);
+        writer.add(z, x, y, isCompressed(data) ? util::decompress(data) : data);
+        written++;
+    }
+    writer.finish();
+
+    return written;
+}
+
+} // namespace mbgl
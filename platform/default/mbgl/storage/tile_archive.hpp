@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   A read-only archive of the tiles of one tileset in a single file, which is memory-mapped
+   rather than read, so that looking up a tile costs a binary search over the mapped directory
+   and copying the tile out of the mapped pages.
+
+   The file starts with a 24 byte header (the magic string "MBGLTILE", a 32 bit version, 32
+   reserved bits, and the 64 bit tile count), followed by a directory of 24 byte entries sorted
+   by tile key (see `key`), each holding the 64 bit key, the 64 bit offset of the tile data
+   from the start of the file, the 32 bit length of the data, and 32 reserved bits. The tile
+   data follows the directory. Tiles are stored uncompressed, and all integers are little
+   endian.
+*/
+class TileArchive : private util::noncopyable {
+public:
+    // Throws util::IOException if the file can't be mapped, and std::runtime_error if it
+    // isn't a tile archive.
+    explicit TileArchive(const std::string& path);
+    ~TileArchive();
+
+    // The data of a tile, pointing into the mapping. Valid for the lifetime of the archive.
+    struct Data {
+        const char* data;
+        std::size_t size;
+    };
+
+    optional<Data> get(uint8_t z, uint32_t x, uint32_t y) const;
+
+    std::size_t tileCount() const { return count; }
+
+    // Orders tiles by zoom level, then x, then y. Supports zoom levels up to 28.
+    static uint64_t key(uint8_t z, uint32_t x, uint32_t y) {
+        return (uint64_t(z) << 56) | (uint64_t(x) << 28) | y;
+    }
+
+    struct Tile {
+        uint8_t z;
+        uint32_t x;
+        uint32_t y;
+        std::string data;
+    };
+
+    // Writes an archive of the given tiles, in any order.
+    static void write(const std::string& path, std::vector<Tile>);
+
+    // Writes an archive of the tiles of an MBTiles file, decompressing gzipped tiles.
+    // Returns the number of tiles written.
+    static std::size_t importMBTiles(const std::string& mbtilesPath, const std::string& path);
+
+private:
+    struct Entry;
+    class Writer;
+
+    const char* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    const Entry* entries = nullptr;
+    std::size_t count = 0;
+};
+
+} // namespace mbgl
@@ -16,10 +16,15 @@
 #include <mbgl/util/http_timeout.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <list>
+#include <map>
+#include <memory>
+#include <tuple>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -36,7 +41,6 @@ public:
 
     OnlineFileSource::Impl& impl;
     Resource resource;
-    std::unique_ptr<AsyncRequest> request;
     util::Timer timer;
     Callback callback;
 
@@ -68,24 +72,29 @@ public:
 
     void remove(OnlineFileRequest* request) {
         allRequests.erase(request);
-        if (activeRequests.erase(request)) {
-            activatePendingRequest();
-        } else {
-            auto it = pendingRequestsMap.find(request);
-            if (it != pendingRequestsMap.end()) {
-                pendingRequestsList.erase(it->second);
-                pendingRequestsMap.erase(it);
+        auto active = activeRequests.find(request);
+        if (active != activeRequests.end()) {
+            std::shared_ptr<InFlightRequest> inFlight = active->second;
+            activeRequests.erase(active);
+            inFlight->waiters.remove(request);
+
+            // The last waiter cancels the network request, and makes room for another.
+            if (inFlight->waiters.empty() && inFlight->request) {
+                inFlightRequests.erase(inFlight->key);
+                activatePendingRequest();
             }
+        } else {
+            unqueueRequest(request);
         }
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
     void activateOrQueueRequest(OnlineFileRequest* request) {
         assert(allRequests.find(request) != allRequests.end());
         assert(activeRequests.find(request) == activeRequests.end());
-        assert(!request->request);
 
-        if (activeRequests.size() >= HTTPFileSource::maximumConcurrentRequests()) {
+        // Joining a request in progress doesn't take up room in the active set.
+        if (inFlightRequests.size() >= HTTPFileSource::maximumConcurrentRequests() &&
+            inFlightRequests.find(inFlightKey(request->resource)) == inFlightRequests.end()) {
             queueRequest(request);
         } else {
             activateRequest(request);
@@ -93,36 +102,79 @@ public:
     }
 
     void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
-        pendingRequestsMap.emplace(request, std::move(it));
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        const std::size_t priority = queuePriority(request->resource);
+        auto position = pendingRequestsLists[priority].insert(pendingRequestsLists[priority].end(), request);
+        auto byKey = pendingRequestsByKey.emplace(inFlightKey(request->resource), request);
+        pendingRequestsMap.emplace(request, PendingRequest { priority, position, byKey });
     }
 
     void activateRequest(OnlineFileRequest* request) {
-        activeRequests.insert(request);
-        request->request = httpFileSource.request(request->resource, [=] (Response response) {
-            activeRequests.erase(request);
-            activatePendingRequest();
-            request->request.reset();
-            request->completed(response);
-        });
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
-    }
+        InFlightKey key = inFlightKey(request->resource);
 
-    void activatePendingRequest() {
-        if (pendingRequestsList.empty()) {
+        auto it = inFlightRequests.find(key);
+        if (it != inFlightRequests.end()) {
+            joinRequest(request, it->second);
             return;
         }
 
-        OnlineFileRequest* request = pendingRequestsList.front();
-        pendingRequestsList.pop_front();
+        auto inFlight = std::make_shared<InFlightRequest>();
+        inFlight->key = key;
+        inFlight->waiters.push_back(request);
+        activeRequests.emplace(request, inFlight);
+        stats.networkRequests++;
+
+        // Queued requests for the same resource join this one rather than wait their turn,
+        // however low their priority.
+        std::vector<OnlineFileRequest*> queued;
+        auto range = pendingRequestsByKey.equal_range(key);
+        for (auto queuedIt = range.first; queuedIt != range.second; ++queuedIt) {
+            queued.push_back(queuedIt->second);
+        }
+        for (auto queuedRequest : queued) {
+            unqueueRequest(queuedRequest);
+            joinRequest(queuedRequest, inFlight);
+        }
+
+        inFlightRequests.emplace(std::move(key), inFlight);
 
-        pendingRequestsMap.erase(request);
+        // Holding a weak reference avoids a cycle through the network request's callback.
+        std::weak_ptr<InFlightRequest> weak = inFlight;
+        inFlight->request = httpFileSource.request(request->resource, [this, weak] (Response response) {
+            if (auto completed = weak.lock()) {
+                complete(std::move(completed), response);
+            }
+        });
+    }
 
-        activateRequest(request);
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+    void activatePendingRequest() {
+        for (auto& pendingRequestsList : pendingRequestsLists) {
+            if (!pendingRequestsList.empty()) {
+                OnlineFileRequest* request = pendingRequestsList.front();
+                unqueueRequest(request);
+                activateRequest(request);
+                return;
+            }
+        }
     }
     
+    // Requests that wait for the network move to the end of the queue of their new priority.
+    // Others make their next request, if any, with the new priority.
+    void setPriority(AsyncRequest& handle, Resource::Priority priority) {
+        auto it = std::find_if(allRequests.begin(), allRequests.end(), [&] (OnlineFileRequest* request) {
+            return request == &handle;
+        });
+        if (it == allRequests.end() || (*it)->resource.priority == priority) {
+            return;
+        }
+
+        OnlineFileRequest* request = *it;
+        request->resource.priority = priority;
+        if (isPending(request)) {
+            unqueueRequest(request);
+            queueRequest(request);
+        }
+    }
+
     bool isPending(OnlineFileRequest* request) {
         return pendingRequestsMap.find(request) != pendingRequestsMap.end();
     }
@@ -131,7 +183,95 @@ public:
         return activeRequests.find(request) != activeRequests.end();
     }
 
+    OnlineFileSource::RequestStats getRequestStats() const {
+        return stats;
+    }
+
 private:
+    // Requests share a network request when all the parts of the resource that the request
+    // depends on are the same.
+    using InFlightKey = std::tuple<std::string, Resource::Kind, optional<std::string>, optional<Timestamp>>;
+
+    static InFlightKey inFlightKey(const Resource& resource) {
+        return InFlightKey { resource.url, resource.kind, resource.priorEtag, resource.priorModified };
+    }
+
+    // Waiting requests are made in order of priority, and in the order they were queued
+    // within a priority: first those of the style itself, its sources, sprites and glyphs,
+    // which hold up the rendering of every tile, then those of tiles and other resources of
+    // regular priority, then those of fallback and prefetched tiles, and last those of low
+    // priority, such as the requests of offline downloads.
+    static constexpr std::size_t queuePriorities = 5;
+
+    static std::size_t queuePriority(const Resource& resource) {
+        switch (resource.priority) {
+        case Resource::Priority::Regular:
+            break;
+        case Resource::Priority::Fallback:
+            return 2;
+        case Resource::Priority::Prefetch:
+            return 3;
+        case Resource::Priority::Low:
+            return 4;
+        }
+
+        switch (resource.kind) {
+        case Resource::Kind::Style:
+        case Resource::Kind::Source:
+        case Resource::Kind::Glyphs:
+        case Resource::Kind::SpriteImage:
+        case Resource::Kind::SpriteJSON:
+            return 0;
+        case Resource::Kind::Unknown:
+        case Resource::Kind::Tile:
+            return 1;
+        }
+
+        return 1;
+    }
+
+    // A network request, and the requests waiting for its response.
+    struct InFlightRequest {
+        InFlightKey key;
+        std::unique_ptr<AsyncRequest> request;
+        std::list<OnlineFileRequest*> waiters;
+    };
+
+    struct PendingRequest {
+        std::size_t priority;
+        std::list<OnlineFileRequest*>::iterator position;
+        std::multimap<InFlightKey, OnlineFileRequest*>::iterator byKey;
+    };
+
+    void joinRequest(OnlineFileRequest* request, const std::shared_ptr<InFlightRequest>& inFlight) {
+        inFlight->waiters.push_back(request);
+        activeRequests.emplace(request, inFlight);
+        stats.coalescedRequests++;
+    }
+
+    void unqueueRequest(OnlineFileRequest* request) {
+        auto it = pendingRequestsMap.find(request);
+        if (it != pendingRequestsMap.end()) {
+            pendingRequestsLists[it->second.priority].erase(it->second.position);
+            pendingRequestsByKey.erase(it->second.byKey);
+            pendingRequestsMap.erase(it);
+        }
+    }
+
+    void complete(std::shared_ptr<InFlightRequest> inFlight, const Response& response) {
+        inFlightRequests.erase(inFlight->key);
+        inFlight->request.reset();
+        activatePendingRequest();
+
+        // Calling a waiter back may cancel the waiters after it, which then leave the list.
+        while (!inFlight->waiters.empty()) {
+            OnlineFileRequest* request = inFlight->waiters.front();
+            inFlight->waiters.pop_front();
+            activeRequests.erase(request);
+            request->completed(response);
+        }
+    }
+
     void networkIsReachableAgain() {
         for (auto& request : allRequests) {
             request->networkIsReachableAgain();
@@ -143,16 +283,23 @@ private:
      *
      * 1. Waiting for timeout (revalidation or retry)
      * 2. Pending (waiting for room in the active set)
-     * 3. Active (open network connection)
+     * 3. Active (open network connection, possibly shared with identical requests)
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequestsMap`, and in the list of their priority in `pendingRequestsLists`.
+     * Requests in the active state are in `activeRequests`, along with the network request
+     * they wait for, which is in `inFlightRequests` until it completes. The active set is
+     * limited by the number of network requests rather than of requests.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
-    std::list<OnlineFileRequest*> pendingRequestsList;
-    std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> pendingRequestsMap;
-    std::unordered_set<OnlineFileRequest*> activeRequests;
+    std::array<std::list<OnlineFileRequest*>, queuePriorities> pendingRequestsLists;
+    std::unordered_map<OnlineFileRequest*, PendingRequest> pendingRequestsMap;
+    std::multimap<InFlightKey, OnlineFileRequest*> pendingRequestsByKey;
+    std::unordered_map<OnlineFileRequest*, std::shared_ptr<InFlightRequest>> activeRequests;
+    std::map<InFlightKey, std::shared_ptr<InFlightRequest>> inFlightRequests;
+
+    OnlineFileSource::RequestStats stats;
 
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
@@ -196,6 +343,14 @@ std::unique_ptr<AsyncRequest> OnlineFileSource::request(const Resource& resource
     return std::make_unique<OnlineFileRequest>(std::move(res), std::move(callback), *impl);
 }
 
+void OnlineFileSource::setPriority(AsyncRequest& request, Resource::Priority priority) {
+    impl->setPriority(request, priority);
+}
+
+OnlineFileSource::RequestStats OnlineFileSource::getRequestStats() const {
+    return impl->getRequestStats();
+}
+
 OnlineFileRequest::OnlineFileRequest(Resource resource_, Callback callback_, OnlineFileSource::Impl& impl_)
     : impl(impl_),
       resource(std::move(resource_)),
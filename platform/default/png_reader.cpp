@@ -1,10 +1,11 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_pool.hpp>
 #include <mbgl/util/premultiply.hpp>
-#include <mbgl/util/char_array_buffer.hpp>
 #include <mbgl/platform/log.hpp>
 
-#include <istream>
-#include <sstream>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 
 extern "C"
 {
@@ -21,14 +22,20 @@ static void user_warning_fn(png_structp, png_const_charp warning_msg) {
     Log::Warning(Event::Image, "ImageReader (PNG): %s", warning_msg);
 }
 
+// Reads straight from the encoded data, which is contiguous in memory.
+struct png_buffer {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+};
+
 static void png_read_data(png_structp png_ptr, png_bytep data, png_size_t length) {
-    std::istream* fin = reinterpret_cast<std::istream*>(png_get_io_ptr(png_ptr));
-    fin->read(reinterpret_cast<char*>(data), length);
-    std::streamsize read_count = fin->gcount();
-    if (read_count < 0 || static_cast<png_size_t>(read_count) != length)
-    {
+    png_buffer* buffer = reinterpret_cast<png_buffer*>(png_get_io_ptr(png_ptr));
+    if (length > buffer->size - buffer->offset) {
         png_error(png_ptr, "Read Error");
     }
+    std::memcpy(data, buffer->data + buffer->offset, length);
+    buffer->offset += length;
 }
 
 struct png_struct_guard {
@@ -44,16 +51,11 @@ struct png_struct_guard {
     png_infopp i_;
 };
 
-PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
-    util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
-    std::istream stream(&dataBuffer);
-
-    png_byte header[8] = { 0 };
-    stream.read(reinterpret_cast<char*>(header), 8);
-    if (stream.gcount() != 8)
+PremultipliedImage decodePNG(const uint8_t* data, size_t size, util::ImagePool* pool) {
+    if (size < 8)
         throw std::runtime_error("PNG reader: Could not read image");
 
-    int is_png = !png_sig_cmp(header, 0, 8);
+    int is_png = !png_sig_cmp(data, 0, 8);
     if (!is_png)
         throw std::runtime_error("File or stream is not a png");
 
@@ -70,7 +72,8 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     if (!info_ptr)
         throw std::runtime_error("failed to create info_ptr");
 
-    png_set_read_fn(png_ptr, &stream, png_read_data);
+    png_buffer buffer { data, size, 8 };
+    png_set_read_fn(png_ptr, &buffer, png_read_data);
     png_set_sig_bytes(png_ptr, 8);
     png_read_info(png_ptr, info_ptr);
 
@@ -80,8 +83,6 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image { static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
-
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
 
@@ -100,25 +101,33 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
-        png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
-        // according to docs png_read_image
-        // "..automatically handles interlacing,
-        // so you don't need to call png_set_interlace_handling()"
+    // Rows are premultiplied as they are decoded, while they are still in cache.
+    PremultipliedImage image = pool
+        ? pool->acquire(static_cast<uint16_t>(width), static_cast<uint16_t>(height))
+        : PremultipliedImage { static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
+    const size_t stride = image.stride();
+
+    if (png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7) {
+        // Interlaced rows are complete only after the last pass.
+        const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
+        for (unsigned row = 0; row < height; ++row)
+            rows[row] = image.data.get() + row * stride;
+        png_set_interlace_handling(png_ptr);
+        png_read_update_info(png_ptr, info_ptr);
+        png_read_image(png_ptr, rows.get());
+        util::premultiply(image.data.get(), size_t(width) * height);
+    } else {
+        png_read_update_info(png_ptr, info_ptr);
+        for (unsigned row = 0; row < height; ++row) {
+            uint8_t* pixels = image.data.get() + row * stride;
+            png_read_row(png_ptr, pixels, nullptr);
+            util::premultiply(pixels, width);
+        }
     }
 
-    png_read_update_info(png_ptr, info_ptr);
-
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
-
     png_read_end(png_ptr, nullptr);
 
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
@@ -0,0 +1,74 @@
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <cassert>
+#include <unordered_map>
+
+namespace mbgl {
+
+class TileArchiveFileSource::Impl {
+public:
+    void addArchive(const std::string& urlTemplate, std::shared_ptr<const TileArchive> archive) {
+        archives[urlTemplate] = std::move(archive);
+    }
+
+    // Runs on this thread because reading the mapping may wait for the disk.
+    void request(const Resource& resource, FileSource::Callback callback) {
+        assert(resource.tileData);
+        const Resource::TileData& tile = *resource.tileData;
+
+        optional<TileArchive::Data> data;
+        auto it = archives.find(tile.urlTemplate);
+        if (it != archives.end() && tile.z >= 0 && tile.x >= 0 && tile.y >= 0) {
+            data = it->second->get(tile.z, tile.x, tile.y);
+        }
+
+        Response response;
+        if (!data) {
+            response.noContent = true;
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::NotFound, "Not found in tile archive");
+        } else if (data->size == 0) {
+            response.noContent = true;
+        } else {
+            // Response data can't share the mapped pages, so this is the one copy of the tile.
+            response.data = std::make_shared<std::string>(data->data, data->size);
+        }
+
+        callback(response);
+    }
+
+private:
+    std::unordered_map<std::string, std::shared_ptr<const TileArchive>> archives;
+};
+
+TileArchiveFileSource::TileArchiveFileSource()
+    : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"TileArchiveFileSource", util::ThreadPriority::Low})) {
+}
+
+TileArchiveFileSource::~TileArchiveFileSource() = default;
+
+void TileArchiveFileSource::addArchive(const std::string& urlTemplate, const std::string& path) {
+    std::shared_ptr<const TileArchive> archive = std::make_shared<TileArchive>(path);
+    thread->invokeSync(&Impl::addArchive, urlTemplate, archive);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    urlTemplates.insert(urlTemplate);
+}
+
+bool TileArchiveFileSource::accepts(const Resource& resource) const {
+    if (resource.kind != Resource::Kind::Tile || !resource.tileData) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return urlTemplates.count(resource.tileData->urlTemplate);
+}
+
+std::unique_ptr<AsyncRequest> TileArchiveFileSource::request(const Resource& resource, Callback callback) {
+    return thread->invokeWithCallback(&Impl::request, resource, callback);
+}
+
+} // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/image_pool.hpp>
 #include <mbgl/platform/log.hpp>
 
 extern "C"
@@ -9,23 +10,22 @@ extern "C"
 
 namespace mbgl {
 
-PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
+PremultipliedImage decodeWebP(const uint8_t* data, size_t size, util::ImagePool* pool) {
     int width = 0, height = 0;
     if (WebPGetInfo(data, size, &width, &height) == 0) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
     }
 
-    int stride = width * 4;
-    size_t webpSize = stride * height;
-    auto webp = std::make_unique<uint8_t[]>(webpSize);
+    PremultipliedImage image = pool
+        ? pool->acquire(static_cast<uint16_t>(width), static_cast<uint16_t>(height))
+        : PremultipliedImage { static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
 
-    if (!WebPDecodeRGBAInto(data, size, webp.get(), webpSize, stride)) {
+    if (!WebPDecodeRGBAInto(data, size, image.data.get(), image.size(), image.stride())) {
         throw std::runtime_error("failed to decode WebP data");
     }
 
-    UnassociatedImage image{ static_cast<uint16_t>(width), static_cast<uint16_t>(height),
-                             std::move(webp) };
-    return util::premultiply(std::move(image));
+    util::premultiply(image.data.get(), std::size_t(image.width) * image.height);
+    return image;
 }
 
 } // namespace mbgl
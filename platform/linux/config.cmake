@@ -19,6 +19,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/local_file_source.cpp
         PRIVATE platform/default/http_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
+        PRIVATE platform/default/tile_archive_file_source.cpp
 
         # Offline
         PRIVATE platform/default/mbgl/storage/offline.cpp
@@ -26,6 +27,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/tile_archive.cpp
+        PRIVATE platform/default/mbgl/storage/tile_archive.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -1,4 +1,5 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_pool.hpp>
 
 #include <QBuffer>
 #include <QByteArray>
@@ -20,11 +21,14 @@ std::string encodePNG(const PremultipliedImage& pre) {
 }
 
 #if !defined(QT_IMAGE_DECODERS)
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+PremultipliedImage decodeJPEG(const uint8_t*, size_t, util::ImagePool*);
+PremultipliedImage decodeWebP(const uint8_t*, size_t, util::ImagePool*);
 #endif
 
-PremultipliedImage decodeImage(const std::string& string) {
+namespace {
+
+// Allocates the decoded image from the pool, if any.
+PremultipliedImage decode(const std::string& string, util::ImagePool* pool) {
     const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
@@ -33,14 +37,14 @@ PremultipliedImage decodeImage(const std::string& string) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
         uint32_t webp_magic = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
         if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
-            return decodeWebP(data, size);
+            return decodeWebP(data, size, pool);
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, pool);
         }
     }
 #endif
@@ -54,10 +58,22 @@ PremultipliedImage decodeImage(const std::string& string) {
         throw std::runtime_error("Unsupported image type");
     }
 
-    auto img = std::make_unique<uint8_t[]>(image.byteCount());
-    memcpy(img.get(), image.constBits(), image.byteCount());
+    const uint16_t width = static_cast<uint16_t>(image.width());
+    const uint16_t height = static_cast<uint16_t>(image.height());
+    PremultipliedImage result = pool ? pool->acquire(width, height) : PremultipliedImage { width, height };
+    memcpy(result.data.get(), image.constBits(), image.byteCount());
 
-    return { static_cast<uint16_t>(image.width()), static_cast<uint16_t>(image.height()),
-             std::move(img) };
+    return result;
 }
+
+} // namespace
+
+PremultipliedImage decodeImage(const std::string& string) {
+    return decode(string, nullptr);
+}
+
+PremultipliedImage decodeImage(const std::string& string, util::ImagePool& pool) {
+    return decode(string, &pool);
+}
+
 }
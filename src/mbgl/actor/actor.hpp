@@ -61,6 +61,11 @@ public:
         mailbox->push(actor::makeMessage(object, fn, std::forward<Args>(args)...));
     }
 
+    // Schedulers that support priorities process more urgent actors first.
+    void setPriority(MailboxPriority priority) {
+        mailbox->setPriority(priority);
+    }
+
     ActorRef<std::decay_t<Object>> self() {
         return ActorRef<std::decay_t<Object>>(object, mailbox);
     }
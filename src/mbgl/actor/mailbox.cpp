@@ -3,6 +3,7 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
@@ -10,46 +11,112 @@ Mailbox::Mailbox(Scheduler& scheduler_)
     : scheduler(scheduler_) {
 }
 
+Mailbox::~Mailbox() {
+    // No producers can exist anymore, so the queue is consistent.
+    while (Message* message = dequeue()) {
+        delete message;
+    }
+}
+
 void Mailbox::push(std::unique_ptr<Message> message) {
     assert(!closing);
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    if (wasEmpty) {
+    enqueue(message.release());
+
+    // Schedule on the transition from empty to non-empty only; `receive` takes care of
+    // rescheduling while messages remain.
+    if (size.fetch_add(1) == 0) {
         scheduler.schedule(shared_from_this());
     }
 }
 
 void Mailbox::close() {
-    // Block until the scheduler is guaranteed not to be executing receive().
-    std::lock_guard<std::mutex> closingLock(closingMutex);
     closing = true;
+
+    // Block until the scheduler is guaranteed not to be executing receive(). Both atomics are
+    // sequentially consistent, so either a receive() observes `closing` once it is done, or we
+    // observe it in `receiving` and wait for it to finish.
+    std::unique_lock<std::mutex> closingLock(closingMutex);
+    closingCondition.wait(closingLock, [this] { return receiving == 0; });
 }
 
 void Mailbox::receive() {
-    std::lock_guard<std::mutex> closingLock(closingMutex);
+    ++receiving;
 
     if (closing) {
+        finishReceiving();
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
-
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
+    // `size` is only incremented once a message is fully enqueued, but a message from a
+    // different producer that started pushing earlier may still be linking itself into the
+    // queue ahead of it. That window is a couple of instructions long.
+    Message* message;
+    while (!(message = dequeue())) {
+        std::this_thread::yield();
     }
 
     (*message)();
+    delete message;
+
+    const bool wasEmpty = size.fetch_sub(1) == 1;
 
-    if (!wasEmpty) {
+    if (!wasEmpty && !closing) {
         scheduler.schedule(shared_from_this());
     }
+
+    finishReceiving();
+}
+
+void Mailbox::finishReceiving() {
+    // Once this receive() no longer counts, it touches nothing but the mailbox itself, which
+    // the scheduler keeps alive while calling it.
+    --receiving;
+    if (closing) {
+        { std::lock_guard<std::mutex> closingLock(closingMutex); }
+        closingCondition.notify_all();
+    }
+}
+
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::dequeue() {
+    Message* first = tail;
+    Message* next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    if (first != head.load(std::memory_order_acquire)) {
+        // A producer is between exchanging `head` and linking `next`.
+        return nullptr;
+    }
+
+    // `first` is the last message; put the stub behind it so it can be detached.
+    enqueue(&stub);
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return first;
+    }
+
+    return nullptr;
 }
 
 } // namespace mbgl
@@ -1,31 +1,80 @@
 #pragma once
 
+#include <mbgl/actor/message.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 namespace mbgl {
 
 class Scheduler;
-class Message;
+
+// Relative urgency of a mailbox, from most to least urgent. A `ThreadPool` processes every
+// scheduled mailbox of a more urgent class before any mailbox of a less urgent one.
+enum class MailboxPriority : uint8_t {
+    Highest,
+    High,
+    Low,
+    Lowest,
+};
+
+constexpr std::size_t MailboxPriorityCount = 4;
+
+/*
+    A `Mailbox` is a lock-free, intrusive multi-producer single-consumer queue of messages
+    (Vyukov's MPSC node queue). Any thread may `push`; `receive` is only ever called by one
+    thread at a time, as arranged by the `Scheduler`.
+
+    `push` schedules the mailbox when it transitions from empty to non-empty, and `receive`
+    processes exactly one message and reschedules the mailbox if more are pending.
+
+    `close` blocks until the mailbox is guaranteed not to be executing `receive`. Neither
+    `push` nor an uncontended `receive` takes a lock; the mutex below is only used for
+    `close` to wait out a concurrent `receive`.
+*/
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
     Mailbox(Scheduler&);
+    ~Mailbox();
 
     void push(std::unique_ptr<Message>);
 
     void close();
     void receive();
 
+    // Takes effect the next time the mailbox is scheduled.
+    void setPriority(MailboxPriority priority_) { priority = priority_; }
+    MailboxPriority getPriority() const { return priority; }
+
 private:
+    void enqueue(Message*);
+    Message* dequeue();
+    void finishReceiving();
+
     Scheduler& scheduler;
+    std::atomic<MailboxPriority> priority { MailboxPriority::Highest };
 
+    std::atomic<bool> closing { false };
+    // Number of receive() calls in progress. A rescheduled receive() may start on another
+    // thread before the one that scheduled it has returned.
+    std::atomic<uint32_t> receiving { 0 };
     std::mutex closingMutex;
-    bool closing { false };
+    std::condition_variable closingCondition;
+
+    // Number of messages pushed but not yet received.
+    std::atomic<std::size_t> size { 0 };
+
+    class Stub : public Message {
+        void operator()() override {}
+    };
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    Stub stub;
+    std::atomic<Message*> head { &stub }; // Producers push here.
+    Message* tail { &stub };              // The consumer pops from here.
 };
 
 } // namespace mbgl
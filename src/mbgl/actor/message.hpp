@@ -1,5 +1,10 @@
 #pragma once
 
+#include <mbgl/actor/message_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <tuple>
 #include <utility>
 
 namespace mbgl {
@@ -7,10 +12,26 @@ namespace mbgl {
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
+//
+// Messages double as the nodes of the `Mailbox` queue, and are allocated from a
+// `MessagePool` rather than the general-purpose heap.
 class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    static void* operator new(std::size_t size) {
+        return actor::MessagePool::allocate(size);
+    }
+
+    // Called with the size of the most-derived type, since the destructor is virtual.
+    static void operator delete(void* ptr, std::size_t size) {
+        actor::MessagePool::deallocate(ptr, size);
+    }
+
+private:
+    friend class Mailbox;
+    std::atomic<Message*> next { nullptr };
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -0,0 +1,179 @@
+#include <mbgl/actor/message_pool.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace mbgl {
+namespace actor {
+
+namespace {
+
+constexpr std::size_t sizeClasses[] = { 64, 128, 256, 512 };
+constexpr std::size_t sizeClassCount = sizeof(sizeClasses) / sizeof(sizeClasses[0]);
+
+// Number of blocks moved between a thread cache and the depot at once.
+constexpr std::size_t batchSize = 64;
+
+// Maximum number of batches per size class kept in the depot; excess blocks are freed.
+constexpr std::size_t maxDepotBatches = 64;
+
+std::size_t sizeClassFor(std::size_t size) {
+    for (std::size_t i = 0; i < sizeClassCount; ++i) {
+        if (size <= sizeClasses[i]) {
+            return i;
+        }
+    }
+    return sizeClassCount;
+}
+
+struct Block {
+    Block* next;
+};
+
+struct FreeList {
+    Block* head = nullptr;
+    std::size_t count = 0;
+
+    void push(Block* block) {
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    Block* pop() {
+        Block* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+
+    // Detaches the first `n` blocks as a null-terminated chain.
+    Block* split(std::size_t n) {
+        Block* first = head;
+        Block* last = head;
+        for (std::size_t i = 1; i < n; ++i) {
+            last = last->next;
+        }
+        head = last->next;
+        last->next = nullptr;
+        count -= n;
+        return first;
+    }
+};
+
+void freeChain(Block* block) {
+    while (block) {
+        Block* next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+}
+
+class Depot {
+public:
+    void put(std::size_t sizeClass, Block* batch) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& batches = freeBatches[sizeClass];
+            if (batches.size() < maxDepotBatches) {
+                batches.push_back(batch);
+                return;
+            }
+        }
+        freeChain(batch);
+    }
+
+    Block* take(std::size_t sizeClass) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& batches = freeBatches[sizeClass];
+        if (batches.empty()) {
+            return nullptr;
+        }
+        Block* batch = batches.back();
+        batches.pop_back();
+        return batch;
+    }
+
+private:
+    std::mutex mutex;
+    std::array<std::vector<Block*>, sizeClassCount> freeBatches;
+};
+
+// Intentionally leaked: thread caches are returned here when threads exit, which may
+// happen after static destructors have run.
+Depot& depot() {
+    static Depot& instance = *new Depot;
+    return instance;
+}
+
+class ThreadCache {
+public:
+    ~ThreadCache() {
+        for (std::size_t i = 0; i < sizeClassCount; ++i) {
+            while (lists[i].count >= batchSize) {
+                depot().put(i, lists[i].split(batchSize));
+            }
+            freeChain(lists[i].head);
+        }
+    }
+
+    void* allocate(std::size_t sizeClass) {
+        FreeList& list = lists[sizeClass];
+        if (!list.head) {
+            if (Block* batch = depot().take(sizeClass)) {
+                list.head = batch;
+                list.count = batchSize;
+            } else {
+                return ::operator new(sizeClasses[sizeClass]);
+            }
+        }
+        return list.pop();
+    }
+
+    void deallocate(void* ptr, std::size_t sizeClass) {
+        FreeList& list = lists[sizeClass];
+        list.push(static_cast<Block*>(ptr));
+        if (list.count >= 2 * batchSize) {
+            depot().put(sizeClass, list.split(batchSize));
+        }
+    }
+
+private:
+    std::array<FreeList, sizeClassCount> lists;
+};
+
+ThreadCache& currentThreadCache() {
+    static util::ThreadLocal<ThreadCache>& threadCache = *new util::ThreadLocal<ThreadCache>;
+
+    ThreadCache* cache = threadCache.get();
+    if (!cache) {
+        cache = new ThreadCache;
+        threadCache.set(cache);
+    }
+    return *cache;
+}
+
+} // namespace
+
+void* MessagePool::allocate(std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == sizeClassCount) {
+        return ::operator new(size);
+    }
+    return currentThreadCache().allocate(sizeClass);
+}
+
+void MessagePool::deallocate(void* ptr, std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == sizeClassCount) {
+        ::operator delete(ptr);
+        return;
+    }
+    currentThreadCache().deallocate(ptr, sizeClass);
+}
+
+} // namespace actor
+} // namespace mbgl
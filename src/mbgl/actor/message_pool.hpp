@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+namespace actor {
+
+/*
+    Allocator for `Message` objects. Messages are small, short-lived, and typically allocated
+    on one thread (the sender) and freed on another (the worker that received them), which is
+    the worst case for a general-purpose allocator.
+
+    Allocations are rounded up to one of a few size classes and served from a per-thread free
+    list. When a thread's free list grows too long, a batch of blocks is moved to a shared
+    depot, from which threads with an empty free list refill. The depot lock is therefore
+    taken at most once per batch instead of once per message. Allocations larger than the
+    largest size class go straight to the global heap.
+*/
+
+class MessagePool {
+public:
+    static void* allocate(std::size_t size);
+    static void deallocate(void* ptr, std::size_t size);
+};
+
+} // namespace actor
+} // namespace mbgl
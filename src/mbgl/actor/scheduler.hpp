@@ -19,7 +19,13 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Mailboxes are processed in order of their `MailboxPriority`,
+      and in FIFO order within a priority class.
+
+    * `WorkStealingThreadPool` provides the same guarantees as `ThreadPool`, but gives
+      each thread its own lock-free deque and lets idle threads steal from busy ones,
+      rather than having every thread contend on a single shared queue. It does not
+      take mailbox priorities into account.
 
     * `RunLoop` is a `Scheduler` that is typically used to create a mailbox and
       `ActorRef` for an object that lives on the main thread and is not itself wrapped
@@ -11,15 +11,22 @@ ThreadPool::ThreadPool(std::size_t count) {
                 std::unique_lock<std::mutex> lock(mutex);
 
                 cv.wait(lock, [this] {
-                    return !queue.empty() || terminate;
+                    return queued > 0 || terminate;
                 });
 
                 if (terminate) {
                     return;
                 }
 
-                auto mailbox = queue.front();
-                queue.pop();
+                std::weak_ptr<Mailbox> mailbox;
+                for (auto& queue : queues) {
+                    if (!queue.empty()) {
+                        mailbox = std::move(queue.front());
+                        queue.pop();
+                        break;
+                    }
+                }
+                --queued;
                 lock.unlock();
 
                 if (auto locked = mailbox.lock()) {
@@ -44,9 +51,17 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    auto locked = mailbox.lock();
+    if (!locked) {
+        return;
+    }
+
+    const auto priority = static_cast<std::size_t>(locked->getPriority());
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        queues[priority].push(std::move(mailbox));
+        ++queued;
     }
 
     cv.notify_one();
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/mailbox.hpp>
 
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -18,7 +20,11 @@ public:
 
 private:
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+
+    // One FIFO queue per MailboxPriority, most urgent first.
+    std::array<std::queue<std::weak_ptr<Mailbox>>, MailboxPriorityCount> queues;
+    std::size_t queued { 0 };
+
     std::mutex mutex;
     std::condition_variable cv;
     bool terminate { false };
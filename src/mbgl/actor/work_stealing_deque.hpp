@@ -0,0 +1,141 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A `WorkStealingDeque<T>` is a lock-free Chase-Lev deque of `T*` pointers, as described in
+    "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al., PPoPP 2013).
+
+    A single owner thread may `push` and `pop` at the bottom end; any number of other threads
+    may concurrently `steal` from the top end. The owner side never takes a lock; thieves
+    contend only on a single compare-and-swap of `top`.
+
+    The deque does not own the pointed-to objects. Ring buffers that are outgrown by `push`
+    are retired, not freed, until the deque is destroyed, because a concurrent thief may still
+    be reading from them.
+*/
+
+template <class T>
+class WorkStealingDeque : private util::noncopyable {
+public:
+    WorkStealingDeque(std::size_t capacity = 64)
+        : array(new Array(capacity)) {
+        retired.emplace_back(array.load(std::memory_order_relaxed));
+    }
+
+    // Owner thread only.
+    void push(T* item) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(a->capacity) - 1) {
+            a = grow(a, b, t);
+        }
+
+        a->put(b, item);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner thread only. Returns nullptr when the deque is empty, or when the last item was
+    // taken by a concurrent thief.
+    T* pop() {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = a->get(b);
+        if (t == b) {
+            // Single item left: race any thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread. Returns nullptr when the deque is empty or the steal lost a race.
+    T* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array* a = array.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // Any thread; the result is only a snapshot.
+    bool empty() const {
+        const int64_t t = top.load(std::memory_order_relaxed);
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+
+private:
+    struct Array {
+        Array(std::size_t capacity_)
+            : capacity(capacity_),
+              mask(capacity_ - 1),
+              items(new std::atomic<T*>[capacity_]) {
+            // The capacity must be a power of two so that indices can wrap with a mask.
+            assert((capacity & mask) == 0);
+        }
+
+        T* get(int64_t i) const {
+            return items[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T* item) {
+            items[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        const std::size_t capacity;
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T*>[]> items;
+    };
+
+    Array* grow(Array* a, int64_t b, int64_t t) {
+        Array* bigger = new Array(a->capacity * 2);
+        retired.emplace_back(bigger);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, a->get(i));
+        }
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t> top { 0 };
+    std::atomic<int64_t> bottom { 0 };
+    std::atomic<Array*> array;
+
+    // Owned by the owner thread; holds every array ever allocated.
+    std::vector<std::unique_ptr<Array>> retired;
+};
+
+} // namespace mbgl
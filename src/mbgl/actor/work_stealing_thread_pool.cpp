@@ -0,0 +1,160 @@
+#include <mbgl/actor/work_stealing_thread_pool.hpp>
+#include <mbgl/actor/work_stealing_deque.hpp>
+#include <mbgl/actor/mailbox.hpp>
+
+#include <random>
+
+namespace mbgl {
+
+// How often a worker with a non-empty deque checks the injection queue first.
+static constexpr uint32_t injectionPollInterval = 61;
+
+class WorkStealingThreadPool::Worker {
+public:
+    Worker(std::size_t index)
+        : random(static_cast<std::minstd_rand::result_type>(index + 1)) {
+    }
+
+    WorkStealingDeque<std::weak_ptr<Mailbox>> deque;
+    std::minstd_rand random;
+    uint32_t ticks = 0;
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count) {
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.emplace_back(std::make_unique<Worker>(i));
+    }
+
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this, i] () {
+            run(*workers[i]);
+        });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Like `ThreadPool`, pending work is dropped on destruction.
+    for (auto& worker : workers) {
+        while (auto item = worker->deque.pop()) {
+            delete item;
+        }
+    }
+
+    while (!injection.empty()) {
+        delete injection.front();
+        injection.pop();
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    auto item = new std::weak_ptr<Mailbox>(std::move(mailbox));
+
+    if (Worker* worker = current.get()) {
+        worker->deque.push(item);
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push(item);
+    }
+
+    pending.fetch_add(1);
+
+    // Only touch the mutex when a worker might be parked. Paired with the increment of
+    // `sleeping` before the predicate check in `run()`, either the parking worker sees the
+    // new item, or we see the parked worker and wake it.
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        cv.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::run(Worker& worker) {
+    current.set(&worker);
+
+    while (!terminate) {
+        if (auto item = take(worker)) {
+            pending.fetch_sub(1);
+            std::weak_ptr<Mailbox> mailbox = std::move(*item);
+            delete item;
+
+            if (auto locked = mailbox.lock()) {
+                locked->receive();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.fetch_add(1);
+        cv.wait(lock, [this] {
+            return pending.load() > 0 || terminate;
+        });
+        sleeping.fetch_sub(1);
+    }
+
+    // ThreadLocal deletes its value on thread exit; the worker is owned by the pool.
+    current.set(nullptr);
+}
+
+std::weak_ptr<Mailbox>* WorkStealingThreadPool::take(Worker& worker) {
+    if (++worker.ticks % injectionPollInterval == 0) {
+        if (auto item = takeInjected()) {
+            return item;
+        }
+    }
+
+    // Taking from the top of our own deque keeps mailboxes in FIFO order, matching the
+    // fairness of `ThreadPool`.
+    if (auto item = worker.deque.steal()) {
+        return item;
+    }
+
+    if (auto item = takeInjected()) {
+        return item;
+    }
+
+    return stealFromOthers(worker);
+}
+
+std::weak_ptr<Mailbox>* WorkStealingThreadPool::takeInjected() {
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    if (injection.empty()) {
+        return nullptr;
+    }
+    auto item = injection.front();
+    injection.pop();
+    return item;
+}
+
+std::weak_ptr<Mailbox>* WorkStealingThreadPool::stealFromOthers(Worker& worker) {
+    const std::size_t count = workers.size();
+    if (count < 2) {
+        return nullptr;
+    }
+
+    const std::size_t start = worker.random() % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers[(start + i) % count];
+        if (&victim == &worker) {
+            continue;
+        }
+        if (auto item = victim.deque.steal()) {
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace mbgl
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A `WorkStealingThreadPool` is a drop-in replacement for `ThreadPool` that avoids a single
+    shared queue. Each worker thread owns a lock-free `WorkStealingDeque` of scheduled mailboxes:
+
+    - A mailbox scheduled from one of the pool's own workers (typically a mailbox rescheduling
+      itself after `receive()`, or an actor messaging another actor in the same pool) is pushed
+      onto that worker's deque without taking a lock.
+    - A mailbox scheduled from any other thread goes to a shared injection queue.
+    - An idle worker takes from its own deque first, then from the injection queue, and then
+      tries to steal from the other workers, starting at a random victim.
+
+    Each worker consumes its own deque in FIFO order, so a mailbox with a long backlog does not
+    starve other mailboxes scheduled on the same worker. The injection queue is additionally
+    polled periodically so that externally scheduled work can't be starved by a busy worker.
+
+    Workers only park on a condition variable when there is no work anywhere in the pool.
+*/
+
+class WorkStealingThreadPool : public Scheduler {
+public:
+    WorkStealingThreadPool(std::size_t count);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+private:
+    class Worker;
+
+    void run(Worker&);
+    std::weak_ptr<Mailbox>* take(Worker&);
+    std::weak_ptr<Mailbox>* takeInjected();
+    std::weak_ptr<Mailbox>* stealFromOthers(Worker&);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    util::ThreadLocal<Worker> current;
+
+    std::mutex injectionMutex;
+    std::queue<std::weak_ptr<Mailbox>*> injection;
+
+    // Number of scheduled mailboxes that have not been taken yet. This is signed because a
+    // thief may take (and decrement) an item before the scheduling thread has incremented.
+    std::atomic<int64_t> pending { 0 };
+    std::atomic<std::size_t> sleeping { 0 };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> terminate { false };
+};
+
+} // namespace mbgl
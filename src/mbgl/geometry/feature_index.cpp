@@ -10,7 +10,9 @@
 
 #include <mapbox/geometry/envelope.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <string>
 
 namespace mbgl {
@@ -23,12 +25,57 @@ void FeatureIndex::insert(const GeometryCollection& geometries,
                           std::size_t index,
                           const std::string& sourceLayerName,
                           const std::string& bucketName) {
+    const uint32_t sourceLayerID = intern(sourceLayerName);
+    const uint32_t bucketID = intern(bucketName);
     for (const auto& ring : geometries) {
-        grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
+        grid.insert(InternedSubfeature { index, sourceLayerID, bucketID },
                     mapbox::geometry::envelope(ring));
     }
 }
 
+void FeatureIndex::insert(const Subfeatures& subfeatures,
+                          const std::string& sourceLayerName,
+                          const std::string& bucketName) {
+    const uint32_t sourceLayerID = intern(sourceLayerName);
+    const uint32_t bucketID = intern(bucketName);
+    for (const auto& subfeature : subfeatures) {
+        grid.insert(InternedSubfeature { subfeature.first, sourceLayerID, bucketID },
+                    subfeature.second);
+    }
+}
+
+std::size_t FeatureIndex::getSubfeatureCount() const {
+    return grid.getElements().size();
+}
+
+FeatureIndex::Subfeatures FeatureIndex::getSubfeatures(std::size_t first) const {
+    const auto& elements = grid.getElements();
+    assert(first <= elements.size());
+
+    Subfeatures result;
+    result.reserve(elements.size() - first);
+    for (auto it = elements.begin() + first; it != elements.end(); ++it) {
+        result.emplace_back(it->first.index, it->second);
+    }
+    return result;
+}
+
+void FeatureIndex::build() {
+    grid.build();
+}
+
+uint32_t FeatureIndex::intern(const std::string& name) {
+    auto it = nameIDs.find(name);
+    if (it != nameIDs.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<uint32_t>(names.size());
+    names.push_back(name);
+    nameIDs.emplace(name, id);
+    return id;
+}
+
 static bool vectorContains(const std::vector<std::string>& vector, const std::string& s) {
     return std::find(vector.begin(), vector.end(), s) != vector.end();
 }
@@ -42,10 +89,6 @@ static bool vectorsIntersect(const std::vector<std::string>& vectorA, const std:
     return false;
 }
 
-static bool topDown(const IndexedSubfeature& a, const IndexedSubfeature& b) {
-    return a.sortIndex > b.sortIndex;
-}
-
 static bool topDownSymbols(const IndexedSubfeature& a, const IndexedSubfeature& b) {
     return a.sortIndex < b.sortIndex;
 }
@@ -65,17 +108,40 @@ void FeatureIndex::query(
 
     const float pixelsToTileUnits = util::EXTENT / tileSize / scale;
     const int16_t additionalRadius = std::min<int16_t>(util::EXTENT, std::ceil(style.getQueryRadius() * pixelsToTileUnits));
-    std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
 
-    std::sort(features.begin(), features.end(), topDown);
-    size_t previousSortIndex = std::numeric_limits<size_t>::max();
-    for (const auto& indexedFeature : features) {
+    // The layers of each bucket that the query asks for, by interned bucket name, and the
+    // source layers, by interned source layer name; resolved once per query rather than
+    // once per subfeature.
+    std::vector<const std::vector<std::string>*> bucketLayers(names.size(), nullptr);
+    for (const auto& bucket : bucketLayerIDs) {
+        if (!filterLayerIDs || vectorsIntersect(bucket.second, *filterLayerIDs)) {
+            bucketLayers[nameIDs.at(bucket.first)] = &bucket.second;
+        }
+    }
+
+    std::vector<const GeometryTileLayer*> sourceLayers(names.size(), nullptr);
+    auto getSourceLayer = [&] (uint32_t id) -> const GeometryTileLayer& {
+        if (!sourceLayers[id]) {
+            sourceLayers[id] = geometryTileData.getLayer(names[id]);
+            assert(sourceLayers[id]);
+        }
+        return *sourceLayers[id];
+    };
 
-        // If this feature is the same as the previous feature, skip it.
-        if (indexedFeature.sortIndex == previousSortIndex) continue;
-        previousSortIndex = indexedFeature.sortIndex;
+    const auto& elements = grid.getElements();
+    std::vector<uint32_t> subfeatures;
+    grid.query({ box.min - additionalRadius, box.max + additionalRadius }, [&] (std::size_t uid) {
+        if (bucketLayers[elements[uid].first.bucketName]) {
+            subfeatures.push_back(uid);
+        }
+    });
 
-        addFeature(result, indexedFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+    // Subfeatures are indexed bottom to top.
+    std::sort(subfeatures.begin(), subfeatures.end(), std::greater<uint32_t>());
+    for (auto uid : subfeatures) {
+        const InternedSubfeature& subfeature = elements[uid].first;
+        addFeature(result, subfeature.index, getSourceLayer(subfeature.sourceLayerName),
+                   *bucketLayers[subfeature.bucketName], queryGeometry, filterLayerIDs, tileID, style, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -86,44 +152,56 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(box, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        auto bucket = nameIDs.find(symbolFeature.bucketName);
+        if (bucket == nameIDs.end() || !bucketLayers[bucket->second]) {
+            continue;
+        }
+
+        auto sourceLayer = geometryTileData.getLayer(symbolFeature.sourceLayerName);
+        assert(sourceLayer);
+
+        addFeature(result, symbolFeature.index, *sourceLayer, *bucketLayers[bucket->second],
+                   queryGeometry, filterLayerIDs, tileID, style, bearing, pixelsToTileUnits);
     }
 }
 
 void FeatureIndex::addFeature(
     std::unordered_map<std::string, std::vector<Feature>>& result,
-    const IndexedSubfeature& indexedFeature,
+    std::size_t index,
+    const GeometryTileLayer& sourceLayer,
+    const std::vector<std::string>& layerIDs,
     const GeometryCollection& queryGeometry,
     const optional<std::vector<std::string>>& filterLayerIDs,
-    const GeometryTileData& geometryTileData,
     const CanonicalTileID& tileID,
     const style::Style& style,
     const float bearing,
     const float pixelsToTileUnits) const {
 
-    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketName);
-    if (filterLayerIDs && !vectorsIntersect(layerIDs, *filterLayerIDs)) {
-        return;
-    }
-
-    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
-    assert(sourceLayer);
-
-    auto geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
+    auto geometryTileFeature = sourceLayer.getFeature(index);
     assert(geometryTileFeature);
 
+    // Decoded at most once, and only if a non-symbol layer needs to test intersection.
+    optional<GeometryCollection> geometries;
+
     for (const auto& layerID : layerIDs) {
         if (filterLayerIDs && !vectorContains(*filterLayerIDs, layerID)) {
             continue;
         }
 
         auto styleLayer = style.getLayer(layerID);
-        if (!styleLayer ||
-            (!styleLayer->is<style::SymbolLayer>() &&
-             !styleLayer->baseImpl->queryIntersectsGeometry(queryGeometry, geometryTileFeature->getGeometries(), bearing, pixelsToTileUnits))) {
+        if (!styleLayer) {
             continue;
         }
 
+        if (!styleLayer->is<style::SymbolLayer>()) {
+            if (!geometries) {
+                geometries = geometryTileFeature->getGeometries();
+            }
+            if (!styleLayer->baseImpl->queryIntersectsGeometry(queryGeometry, *geometries, bearing, pixelsToTileUnits)) {
+                continue;
+            }
+        }
+
         result[layerID].push_back(convertFeature(*geometryTileFeature, tileID));
     }
 }
@@ -155,6 +233,7 @@ optional<GeometryCollection> FeatureIndex::translateQueryGeometry(
 }
 
 void FeatureIndex::addBucketLayerName(const std::string& bucketName, const std::string& layerID) {
+    intern(bucketName);
     bucketLayerIDs[bucketName].push_back(layerID);
 }
 
@@ -162,4 +241,16 @@ void FeatureIndex::setCollisionTile(std::unique_ptr<CollisionTile> collisionTile
     collisionTile = std::move(collisionTile_);
 }
 
+std::unique_ptr<CollisionTile> FeatureIndex::takeCollisionTile() {
+    return std::move(collisionTile);
+}
+
+std::size_t FeatureIndex::getByteSize() const {
+    std::size_t size = grid.getByteSize();
+    for (const auto& name : names) {
+        size += sizeof(name) + name.size();
+    }
+    return size;
+}
+
 } // namespace mbgl
@@ -5,6 +5,7 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/feature.hpp>
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -27,12 +28,35 @@ public:
     size_t sortIndex;
 };
 
+// A subfeature indexed by a `FeatureIndex`, whose source layer and bucket names are
+// interned by the index. Its sort index is its position in the index.
+class InternedSubfeature {
+public:
+    std::size_t index;
+    uint32_t sourceLayerName;
+    uint32_t bucketName;
+};
+
 class FeatureIndex {
 public:
     FeatureIndex();
 
+    // Bounding boxes of indexed subfeatures, with the index of their feature.
+    using Subfeatures = std::vector<std::pair<std::size_t, GridIndex<InternedSubfeature>::BBox>>;
+
     void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
 
+    // Indexes subfeatures taken from another index again, e.g. those of a bucket that is
+    // reused from an earlier layout of the tile.
+    void insert(const Subfeatures&, const std::string& sourceLayerName, const std::string& bucketName);
+
+    // The number of subfeatures indexed so far, and the subfeatures indexed since then.
+    std::size_t getSubfeatureCount() const;
+    Subfeatures getSubfeatures(std::size_t first) const;
+
+    // Prepares the index for queries once all subfeatures have been inserted.
+    void build();
+
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCollection& queryGeometry,
@@ -54,22 +78,32 @@ public:
     void addBucketLayerName(const std::string& bucketName, const std::string& layerName);
 
     void setCollisionTile(std::unique_ptr<CollisionTile>);
+    std::unique_ptr<CollisionTile> takeCollisionTile();
+
+    // Approximate memory held by the index, in bytes.
+    std::size_t getByteSize() const;
 
 private:
+    uint32_t intern(const std::string&);
+
     void addFeature(
             std::unordered_map<std::string, std::vector<Feature>>& result,
-            const IndexedSubfeature&,
+            std::size_t index,
+            const GeometryTileLayer&,
+            const std::vector<std::string>& layerIDs,
             const GeometryCollection& queryGeometry,
             const optional<std::vector<std::string>>& filterLayerIDs,
-            const GeometryTileData&,
             const CanonicalTileID&,
             const style::Style&,
             const float bearing,
             const float pixelsToTileUnits) const;
 
     std::unique_ptr<CollisionTile> collisionTile;
-    GridIndex<IndexedSubfeature> grid;
-    unsigned int sortIndex = 0;
+    GridIndex<InternedSubfeature> grid;
+
+    // Source layer and bucket names, by interned ID.
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> nameIDs;
 
     std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
 };
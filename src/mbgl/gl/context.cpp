@@ -143,7 +143,7 @@ UniqueFramebuffer Context::createFramebuffer() {
 }
 
 UniqueTexture
-Context::createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit unit) {
+Context::createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit unit, TextureFormat format) {
     auto obj = createTexture();
     activeTexture = unit;
     texture[unit] = obj;
@@ -151,8 +151,13 @@ Context::createTexture(uint16_t width, uint16_t height, const void* data, Textur
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-    MBGL_CHECK_ERROR(
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    if (format == TextureFormat::RGB565) {
+        MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB,
+                                      GL_UNSIGNED_SHORT_5_6_5, data));
+    } else {
+        MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+                                      GL_UNSIGNED_BYTE, data));
+    }
     return obj;
 }
 
@@ -56,6 +56,13 @@ public:
         return { size, createTexture(size[0], size[1], nullptr, unit) };
     }
 
+    // Create a texture from pixels in the given format. RGB565 pixels are 16 bit integers in
+    // native byte order, and rows must start at multiples of 4 bytes.
+    Texture createTexture(const std::array<uint16_t, 2>& size, const void* data, TextureFormat format, TextureUnit unit = 0) {
+        return { size, createTexture(size[0], size[1], data, unit, format),
+                 TextureFilter::Nearest, TextureMipMap::No, format };
+    }
+
     void bindTexture(Texture&,
                      TextureUnit = 0,
                      TextureFilter = TextureFilter::Nearest,
@@ -123,7 +130,8 @@ public:
 private:
     UniqueBuffer createVertexBuffer(const void* data, std::size_t size);
     UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
-    UniqueTexture createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit);
+    UniqueTexture createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit,
+                                TextureFormat = TextureFormat::RGBA);
     void bindAttribute(const AttributeBinding&, std::size_t stride, const int8_t* offset);
 
     friend detail::ProgramDeleter;
@@ -13,6 +13,7 @@ public:
     UniqueTexture texture;
     TextureFilter filter = TextureFilter::Nearest;
     TextureMipMap mipmap = TextureMipMap::No;
+    TextureFormat format = TextureFormat::RGBA;
 };
 
 } // namespace gl
@@ -51,6 +51,10 @@ enum class BufferType : uint32_t {
 enum class TextureMipMap : bool { No = false, Yes = true };
 enum class TextureFilter : bool { Nearest = false, Linear = true };
 
+// RGBA textures hold 4 bytes per pixel. RGB565 textures hold 2 bytes per pixel, with 5 bits
+// of red, 6 bits of green and 5 bits of blue, and are opaque.
+enum class TextureFormat : uint8_t { RGBA, RGB565 };
+
 enum class StencilTestFunction : uint32_t {
     Never = 0x0200,
     Less = 0x0201,
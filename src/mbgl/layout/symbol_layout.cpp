@@ -2,7 +2,7 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/clip_lines.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/tile_layer_filter.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/get_anchors.hpp>
@@ -54,9 +54,10 @@ SymbolLayout::SymbolLayout(std::string bucketName_,
 
     // Determine and load glyph ranges
     const size_t featureCount = static_cast<size_t>(layer.featureCount());
+    TileLayerFilter layerFilter(filter, layer);
     for (size_t i = 0; i < featureCount; i++) {
         auto feature = layer.getFeature(i);
-        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!layerFilter(i, *feature))
             continue;
 
         SymbolFeature ft;
@@ -19,11 +19,15 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/async_task.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/actor/thread_pool.hpp>
 #include <mbgl/platform/log.hpp>
 
+#include <cmath>
+#include <cstring>
+
 namespace mbgl {
 
 using namespace style;
@@ -36,7 +40,7 @@ enum class RenderState : uint8_t {
 
 class Map::Impl : public style::Observer {
 public:
-    Impl(View&, FileSource&, MapMode, GLContextMode, ConstrainMode, ViewportMode);
+    Impl(View&, FileSource&, Scheduler*, MapMode, GLContextMode, ConstrainMode, ViewportMode);
 
     void onSourceAttributionChanged(style::Source&, const std::string&) override;
     void onUpdate(Update) override;
@@ -63,7 +67,10 @@ public:
 
     Update updateFlags = Update::Nothing;
     util::AsyncTask asyncUpdate;
-    ThreadPool workerThreadPool;
+
+    // Null when the map uses a scheduler it shares with other maps.
+    std::unique_ptr<ThreadPool> workerThreadPool;
+    Scheduler& workerScheduler;
 
     std::unique_ptr<AnnotationManager> annotationManager;
     std::unique_ptr<Painter> painter;
@@ -77,18 +84,30 @@ public:
 
     Map::StillImageCallback callback;
     size_t sourceCacheSize;
+    size_t tileCacheMemoryBudget = 0;
     TimePoint timePoint;
     bool loading = false;
+
+    // Start of the current wait for a fully rendered frame, and the length of the last one.
+    optional<TimePoint> fullFrameRequested;
+    optional<Duration> timeToFirstFullFrame;
 };
 
 Map::Map(View& view, FileSource& fileSource, MapMode mapMode, GLContextMode contextMode, ConstrainMode constrainMode, ViewportMode viewportMode)
-    : impl(std::make_unique<Impl>(view, fileSource, mapMode, contextMode, constrainMode, viewportMode)) {
+    : impl(std::make_unique<Impl>(view, fileSource, nullptr, mapMode, contextMode, constrainMode, viewportMode)) {
+    view.initialize(this);
+    update(Update::Dimensions);
+}
+
+Map::Map(View& view, FileSource& fileSource, Scheduler& workerScheduler, MapMode mapMode, GLContextMode contextMode, ConstrainMode constrainMode, ViewportMode viewportMode)
+    : impl(std::make_unique<Impl>(view, fileSource, &workerScheduler, mapMode, contextMode, constrainMode, viewportMode)) {
     view.initialize(this);
     update(Update::Dimensions);
 }
 
 Map::Impl::Impl(View& view_,
                 FileSource& fileSource_,
+                Scheduler* workerScheduler_,
                 MapMode mode_,
                 GLContextMode contextMode_,
                 ConstrainMode constrainMode_,
@@ -102,7 +121,8 @@ Map::Impl::Impl(View& view_,
       contextMode(contextMode_),
       pixelRatio(view.getPixelRatio()),
       asyncUpdate([this] { update(); }),
-      workerThreadPool(4),
+      workerThreadPool(workerScheduler_ ? nullptr : std::make_unique<ThreadPool>(4)),
+      workerScheduler(workerScheduler_ ? *workerScheduler_ : *workerThreadPool),
       annotationManager(std::make_unique<AnnotationManager>(pixelRatio)) {
 }
 
@@ -147,10 +167,81 @@ void Map::renderStill(StillImageCallback callback) {
     }
 
     impl->callback = callback;
+    impl->fullFrameRequested = Clock::now();
     impl->updateFlags |= Update::RenderStill;
     impl->asyncUpdate.send();
 }
 
+void Map::renderStillTiles(uint8_t z, uint32_t x, uint32_t y, uint16_t size, uint16_t tileSize, StillTilesCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "StillTilesCallback not set");
+        return;
+    }
+
+    const uint64_t tiles = uint64_t(1) << std::min<uint8_t>(z, 32);
+    if (size == 0 || tileSize == 0 || x + uint64_t(size) > tiles || y + uint64_t(size) > tiles) {
+        callback(std::make_exception_ptr(util::MisuseException("Metatile is outside the world")), {});
+        return;
+    }
+
+    // Tiles smaller than the map's own tiles are rendered at a lower map zoom level.
+    const double zoom = z + std::log2(double(tileSize) / util::tileSize);
+    if (zoom < getMinZoom() || zoom > getMaxZoom()) {
+        callback(std::make_exception_ptr(util::MisuseException("Metatile zoom level is out of range")), {});
+        return;
+    }
+
+    const std::array<uint16_t, 2> viewSize = impl->view.getSize();
+    if (viewSize[0] != uint32_t(size) * tileSize || viewSize[1] != uint32_t(size) * tileSize) {
+        callback(std::make_exception_ptr(util::MisuseException("View size doesn't match the metatile")), {});
+        return;
+    }
+
+    // Leave the camera of a render in progress alone; renderStill() reports the misuse.
+    if (impl->mode == MapMode::Still && !impl->callback) {
+        const double scale = std::pow(2.0, z);
+        const double n = M_PI - 2.0 * M_PI * (y + size / 2.0) / scale;
+
+        CameraOptions camera;
+        camera.center = LatLng { util::RAD2DEG * std::atan(std::sinh(n)),
+                                 (x + size / 2.0) / scale * util::DEGREES_MAX - util::LONGITUDE_MAX };
+        camera.zoom = zoom;
+        camera.angle = 0;
+        camera.pitch = 0;
+
+        // The view may have been resized to fit this metatile.
+        update(Update::Dimensions);
+        jumpTo(camera);
+    }
+
+    renderStill([size, callback](std::exception_ptr error, PremultipliedImage&& image) {
+        if (error) {
+            callback(error, {});
+            return;
+        }
+
+        // Each tile is tileSize pixels times the pixel ratio of the view.
+        const uint16_t tilePixels = image.width / size;
+        const std::size_t tileStride = std::size_t(tilePixels) * 4;
+
+        std::vector<PremultipliedImage> result;
+        result.reserve(std::size_t(size) * size);
+        for (uint16_t row = 0; row < size; row++) {
+            for (uint16_t column = 0; column < size; column++) {
+                PremultipliedImage tile { tilePixels, tilePixels };
+                const uint8_t* source = image.data.get() +
+                    std::size_t(row) * tilePixels * image.stride() + column * tileStride;
+                for (uint16_t line = 0; line < tilePixels; line++) {
+                    std::memcpy(tile.data.get() + line * tileStride, source + line * image.stride(), tileStride);
+                }
+                result.push_back(std::move(tile));
+            }
+        }
+
+        callback(nullptr, std::move(result));
+    });
+}
+
 void Map::update(Update flags) {
     impl->onUpdate(flags);
 }
@@ -176,8 +267,15 @@ void Map::render() {
 
     if (!isFullyLoaded()) {
         impl->renderState = RenderState::Partial;
+        if (!impl->fullFrameRequested) {
+            impl->fullFrameRequested = Clock::now();
+        }
     } else if (impl->renderState != RenderState::Fully) {
         impl->renderState = RenderState::Fully;
+        if (impl->fullFrameRequested) {
+            impl->timeToFirstFullFrame = Clock::now() - *impl->fullFrameRequested;
+            impl->fullFrameRequested = {};
+        }
         impl->view.notifyMapChange(MapChangeDidFinishRenderingMapFullyRendered);
         if (impl->loading) {
             impl->loading = false;
@@ -230,7 +328,7 @@ void Map::Impl::update() {
     style::UpdateParameters parameters(pixelRatio,
                                        debugOptions,
                                        transform.getState(),
-                                       workerThreadPool,
+                                       workerScheduler,
                                        fileSource,
                                        mode,
                                        *annotationManager,
@@ -266,7 +364,16 @@ void Map::Impl::render() {
                     annotationManager->getSpriteAtlas());
 
     if (mode == MapMode::Still) {
-        callback(nullptr, view.readStillImage());
+        if (fullFrameRequested) {
+            timeToFirstFullFrame = Clock::now() - *fullFrameRequested;
+            fullFrameRequested = {};
+        }
+
+        // The view may finish reading the image while the next one renders. When it finishes
+        // right away, the callback still can't start another render, as with readStillImage().
+        view.readStillImageAsync([stillCallback = callback] (PremultipliedImage&& image) {
+            stillCallback(nullptr, std::move(image));
+        });
         callback = nullptr;
     }
 
@@ -289,6 +396,7 @@ void Map::setStyleURL(const std::string& url) {
     }
 
     impl->loading = true;
+    impl->fullFrameRequested = Clock::now();
 
     impl->view.notifyMapChange(MapChangeWillStartLoadingMap);
 
@@ -298,6 +406,7 @@ void Map::setStyleURL(const std::string& url) {
     impl->styleMutated = false;
 
     impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
+    impl->style->setTileCacheMemoryBudget(impl->tileCacheMemoryBudget);
 
     impl->styleRequest = impl->fileSource.request(Resource::style(impl->styleURL), [this](Response res) {
         // Once we get a fresh style, or the style is mutated, stop revalidating.
@@ -333,6 +442,7 @@ void Map::setStyleJSON(const std::string& json) {
     }
 
     impl->loading = true;
+    impl->fullFrameRequested = Clock::now();
 
     impl->view.notifyMapChange(MapChangeWillStartLoadingMap);
 
@@ -341,6 +451,7 @@ void Map::setStyleJSON(const std::string& json) {
     impl->styleMutated = false;
 
     impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
+    impl->style->setTileCacheMemoryBudget(impl->tileCacheMemoryBudget);
 
     impl->loadStyleJSON(json);
 }
@@ -972,6 +1083,20 @@ void Map::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void Map::setTileCacheMemoryBudget(size_t bytes) {
+    impl->tileCacheMemoryBudget = bytes;
+    if (impl->style) {
+        impl->style->setTileCacheMemoryBudget(bytes);
+    }
+}
+
+std::unordered_map<std::string, size_t> Map::getTileCacheMemoryUsage() const {
+    if (!impl->style) {
+        return {};
+    }
+    return impl->style->getTileCacheMemoryUsage();
+}
+
 void Map::onLowMemory() {
     if (impl->painter) {
         impl->painter->cleanup();
@@ -1010,6 +1135,10 @@ void Map::Impl::onResourceError(std::exception_ptr error) {
     }
 }
 
+optional<Duration> Map::getTimeToFirstFullFrame() const {
+    return impl->timeToFirstFullFrame;
+}
+
 void Map::dumpDebugLogs() const {
     Log::Info(Event::General, "--------------------------------------------------------------------------------");
     Log::Info(Event::General, "MapContext::styleURL: %s", impl->styleURL.c_str());
@@ -0,0 +1,165 @@
+#include <mbgl/map/render_pool.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/actor/thread_pool.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/async_task.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace mbgl {
+
+class RenderPool::Impl {
+public:
+    Impl(FileSource& fileSource_, std::size_t size, ViewFactory createView, std::size_t workerThreads)
+        : fileSource(fileSource_),
+          workerThreadPool(workerThreads) {
+        instances.reserve(size);
+        for (std::size_t i = 0; i < size; i++) {
+            std::unique_ptr<View> view = createView();
+            auto map = std::make_unique<Map>(*view, fileSource, workerThreadPool, MapMode::Still);
+            instances.push_back({ std::move(view), std::move(map), false, 0 });
+        }
+    }
+
+    // Maps take the style over when they are next idle, so that renders in progress finish
+    // with the style they were requested under.
+    void setStyleJSON(const std::string& json) {
+        styleJSON = json;
+        styleError = nullptr;
+        styleVersion++;
+        dispatch.send();
+    }
+
+    void setStyleError(std::exception_ptr error) {
+        styleJSON = {};
+        styleError = error;
+        dispatch.send();
+    }
+
+    void failPendingRenders(std::exception_ptr error) {
+        std::deque<Render> failed;
+        std::swap(failed, renders);
+        for (auto& render : failed) {
+            render.callback(error, {});
+        }
+    }
+
+    // Starts as many waiting renders as there are idle maps.
+    void dispatchRenders() {
+        if (styleError) {
+            failPendingRenders(styleError);
+            return;
+        }
+        if (!styleJSON) {
+            return;
+        }
+
+        for (auto& instance : instances) {
+            if (renders.empty()) {
+                return;
+            }
+            if (instance.busy) {
+                continue;
+            }
+
+            Render render = std::move(renders.front());
+            renders.pop_front();
+
+            if (instance.styleVersion != styleVersion) {
+                instance.map->setStyleJSON(*styleJSON);
+                instance.styleVersion = styleVersion;
+            }
+
+            Instance* rendering = &instance;
+            rendering->busy = true;
+            rendering->map->jumpTo(render.camera);
+            rendering->map->renderStill([this, rendering, callback = std::move(render.callback)]
+                                        (std::exception_ptr error, PremultipliedImage&& image) {
+                rendering->busy = false;
+                callback(error, std::move(image));
+
+                // The map can't start another render until this callback has returned.
+                dispatch.send();
+            });
+        }
+    }
+
+    struct Instance {
+        std::unique_ptr<View> view;
+        std::unique_ptr<Map> map;
+        bool busy;
+        // The version of the pool's style that the map has.
+        uint64_t styleVersion;
+    };
+
+    struct Render {
+        CameraOptions camera;
+        Map::StillImageCallback callback;
+    };
+
+    FileSource& fileSource;
+
+    // Declared before the maps, which use it until they are destroyed.
+    ThreadPool workerThreadPool;
+    std::vector<Instance> instances;
+
+    std::deque<Render> renders;
+    optional<std::string> styleJSON;
+    std::exception_ptr styleError;
+    uint64_t styleVersion = 0;
+    std::unique_ptr<AsyncRequest> styleRequest;
+
+    util::AsyncTask dispatch { [this] { dispatchRenders(); } };
+};
+
+RenderPool::RenderPool(FileSource& fileSource, std::size_t size, ViewFactory createView, std::size_t workerThreads)
+    : impl(std::make_unique<Impl>(fileSource, size, std::move(createView), workerThreads)) {
+}
+
+RenderPool::~RenderPool() = default;
+
+void RenderPool::setStyleURL(const std::string& url) {
+    impl->styleJSON = {};
+    impl->styleError = nullptr;
+    impl->styleRequest = impl->fileSource.request(Resource::style(url), [this](Response res) {
+        if (res.error) {
+            impl->setStyleError(std::make_exception_ptr(std::runtime_error(res.error->message)));
+        } else if (res.notModified) {
+            return;
+        } else if (res.noContent) {
+            impl->setStyleError(std::make_exception_ptr(std::runtime_error("style is empty")));
+        } else {
+            impl->setStyleJSON(*res.data);
+        }
+
+        // Revalidating the style would change it under renders in progress.
+        impl->styleRequest.reset();
+    });
+}
+
+void RenderPool::setStyleJSON(const std::string& json) {
+    impl->styleRequest.reset();
+    impl->setStyleJSON(json);
+}
+
+void RenderPool::renderStill(const CameraOptions& camera, Map::StillImageCallback callback) {
+    impl->renders.push_back({ camera, std::move(callback) });
+    impl->dispatch.send();
+}
+
+std::size_t RenderPool::size() const {
+    return impl->instances.size();
+}
+
+std::size_t RenderPool::pendingRenders() const {
+    return impl->renders.size();
+}
+
+} // namespace mbgl
@@ -14,6 +14,10 @@ PremultipliedImage View::readStillImage(std::array<uint16_t, 2>) {
     return {};
 }
 
+void View::readStillImageAsync(StillImageCallback callback) {
+    callback(readStillImage());
+}
+
 void View::notifyMapChange(MapChange) {
     // no-op
 }
@@ -4,6 +4,7 @@
 #include <mbgl/util/noncopyable.hpp>
 
 #include <atomic>
+#include <cstddef>
 
 #define BUFFER_OFFSET_0  ((int8_t*)nullptr)
 #define BUFFER_OFFSET(i) ((BUFFER_OFFSET_0) + (i))
@@ -40,6 +41,9 @@ public:
 
     virtual bool needsClipping() const = 0;
 
+    // Approximate memory held by the bucket's vertex, index, and image data, in bytes.
+    virtual std::size_t getByteSize() const = 0;
+
     bool needsUpload() const {
         return !uploaded;
     }
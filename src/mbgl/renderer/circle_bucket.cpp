@@ -34,6 +34,11 @@ bool CircleBucket::hasData() const {
     return !groups.empty();
 }
 
+std::size_t CircleBucket::getByteSize() const {
+    return vertices.size() * sizeof(CircleVertex) +
+           triangles.size() * sizeof(gl::Triangle);
+}
+
 bool CircleBucket::needsClipping() const {
     return true;
 }
@@ -22,6 +22,7 @@ public:
 
     bool hasData() const override;
     bool needsClipping() const override;
+    std::size_t getByteSize() const override;
     void addGeometry(const GeometryCollection&);
 
     void drawCircles(CircleShader&, gl::Context&, PaintMode);
@@ -117,6 +117,12 @@ bool FillBucket::hasData() const {
     return !triangleGroups.empty() || !lineGroups.empty();
 }
 
+std::size_t FillBucket::getByteSize() const {
+    return vertices.size() * sizeof(FillVertex) +
+           lines.size() * sizeof(gl::Line) +
+           triangles.size() * sizeof(gl::Triangle);
+}
+
 bool FillBucket::needsClipping() const {
     return true;
 }
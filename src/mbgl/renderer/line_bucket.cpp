@@ -453,6 +453,11 @@ bool LineBucket::hasData() const {
     return !groups.empty();
 }
 
+std::size_t LineBucket::getByteSize() const {
+    return vertices.size() * sizeof(LineVertex) +
+           triangles.size() * sizeof(gl::Triangle);
+}
+
 bool LineBucket::needsClipping() const {
     return true;
 }
@@ -26,6 +26,7 @@ public:
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
     bool needsClipping() const override;
+    std::size_t getByteSize() const override;
 
     void addGeometry(const GeometryCollection&);
     void addGeometry(const GeometryCoordinates& line);
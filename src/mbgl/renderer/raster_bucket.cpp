@@ -4,20 +4,72 @@
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/image_pool.hpp>
+
+#include <cstring>
 
 namespace mbgl {
 
 using namespace style;
 
-RasterBucket::RasterBucket(PremultipliedImage&& image_) : image(std::move(image_)) {
+namespace {
+
+bool isOpaque(const PremultipliedImage& image) {
+    const uint8_t* const end = image.data.get() + image.size();
+    for (const uint8_t* pixel = image.data.get(); pixel != end; pixel += 4) {
+        if (pixel[3] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Packs the pixels in place. Each pixel is written before the ones it overlaps are read.
+void packRGB565(PremultipliedImage& image) {
+    uint8_t* const data = image.data.get();
+    const std::size_t pixels = std::size_t(image.width) * image.height;
+    for (std::size_t i = 0; i < pixels; i++) {
+        const uint8_t* pixel = data + i * 4;
+        const uint16_t packed = ((pixel[0] * 31 + 127) / 255) << 11 |
+                                ((pixel[1] * 63 + 127) / 255) << 5 |
+                                ((pixel[2] * 31 + 127) / 255);
+        std::memcpy(data + i * 2, &packed, sizeof(packed));
+    }
+}
+
+} // namespace
+
+RasterBucket::RasterBucket(PremultipliedImage&& image_,
+                           std::shared_ptr<util::ImagePool> pool_,
+                           gl::TextureFormat opaqueFormat)
+    : image(std::move(image_)),
+      pool(std::move(pool_)) {
+    // Rows of RGB565 pixels are 4 byte aligned, as the texture upload expects, for even widths.
+    if (opaqueFormat == gl::TextureFormat::RGB565 && image.data && image.width % 2 == 0 &&
+        isOpaque(image)) {
+        packRGB565(image);
+        format = gl::TextureFormat::RGB565;
+    }
+}
+
+RasterBucket::~RasterBucket() {
+    releaseImage();
 }
 
 void RasterBucket::upload(gl::Context& context) {
-    texture = context.createTexture(image);
-    image = {};
+    texture = context.createTexture({{ image.width, image.height }}, image.data.get(), format);
+    releaseImage();
     uploaded = true;
 }
 
+void RasterBucket::releaseImage() {
+    if (pool) {
+        pool->release(std::move(image));
+    } else {
+        image = {};
+    }
+}
+
 void RasterBucket::render(Painter& painter,
                           PaintParameters& parameters,
                           const Layer& layer,
@@ -40,6 +92,23 @@ bool RasterBucket::hasData() const {
     return true;
 }
 
+std::size_t RasterBucket::getByteSize() const {
+    // The image is released once it has been uploaded to the texture.
+    return texture ? getTextureByteSize() : getImageByteSize();
+}
+
+std::size_t RasterBucket::getImageByteSize() const {
+    return image.size();
+}
+
+std::size_t RasterBucket::getTextureByteSize() const {
+    if (!texture) {
+        return 0;
+    }
+    return std::size_t(texture->size[0]) * texture->size[1] *
+           (texture->format == gl::TextureFormat::RGB565 ? 2 : 4);
+}
+
 bool RasterBucket::needsClipping() const {
     return false;
 }
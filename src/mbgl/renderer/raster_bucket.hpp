@@ -5,8 +5,14 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/gl/texture.hpp>
 
+#include <memory>
+
 namespace mbgl {
 
+namespace util {
+class ImagePool;
+} // namespace util
+
 class RasterShader;
 class RasterVertex;
 
@@ -18,17 +24,37 @@ class VertexArrayObject;
 
 class RasterBucket : public Bucket {
 public:
-    RasterBucket(PremultipliedImage&&);
+    // Returns the image to the pool, if any, once it has been uploaded. With RGB565 as the
+    // opaque format, an image without transparent pixels is packed into RGB565 pixels at the
+    // start of its buffer, so that it uploads to a texture of half the size.
+    RasterBucket(PremultipliedImage&&,
+                 std::shared_ptr<util::ImagePool> = nullptr,
+                 gl::TextureFormat opaqueFormat = gl::TextureFormat::RGBA);
+    ~RasterBucket() override;
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
     bool needsClipping() const override;
+    std::size_t getByteSize() const override;
+
+    // The bytes held by the decoded image until it is uploaded, and by the texture afterwards.
+    std::size_t getImageByteSize() const;
+    std::size_t getTextureByteSize() const;
+
+    gl::TextureFormat getFormat() const { return format; }
+
+    // The pixels of the decoded image in the bucket's format, until it is uploaded.
+    const uint8_t* getImageData() const { return image.data.get(); }
 
     void drawRaster(RasterShader&, gl::VertexBuffer<RasterVertex>&, gl::VertexArrayObject&, gl::Context&);
 
 private:
+    void releaseImage();
+
     PremultipliedImage image;
+    std::shared_ptr<util::ImagePool> pool;
+    gl::TextureFormat format = gl::TextureFormat::RGBA;
     optional<gl::Texture> texture;
 };
 
@@ -50,6 +50,13 @@ bool SymbolBucket::hasData() const {
     return false;
 }
 
+std::size_t SymbolBucket::getByteSize() const {
+    return (text.vertices.size() + icon.vertices.size()) * sizeof(SymbolVertex) +
+           (text.triangles.size() + icon.triangles.size()) * sizeof(gl::Triangle) +
+           collisionBox.vertices.size() * sizeof(CollisionBoxVertex) +
+           collisionBox.lines.size() * sizeof(gl::Line);
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.groups.empty();
 }
@@ -33,6 +33,7 @@ public:
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
     bool needsClipping() const override;
+    std::size_t getByteSize() const override;
 
     void drawGlyphs(SymbolSDFShader&, gl::Context&, PaintMode);
     void drawIcons(SymbolSDFShader&, gl::Context&, PaintMode);
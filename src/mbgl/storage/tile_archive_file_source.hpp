@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+#include <mutex>
+#include <unordered_set>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles from memory-mapped tile archives, one per tileset.
+class TileArchiveFileSource : public FileSource {
+public:
+    TileArchiveFileSource();
+    ~TileArchiveFileSource() override;
+
+    // Serves the tiles of the tileset with the given URL template from the archive at `path`,
+    // replacing any previous archive for the tileset. Throws if the archive can't be opened.
+    void addArchive(const std::string& urlTemplate, const std::string& path);
+
+    // Whether the resource is a tile of a tileset with an archive. May be called from any
+    // thread.
+    bool accepts(const Resource&) const;
+
+    // Responds with a NotFound error for tiles missing from the archive.
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+private:
+    class Impl;
+    std::unique_ptr<util::Thread<Impl>> thread;
+
+    // Guards urlTemplates, which accepts() reads on the threads that make requests.
+    mutable std::mutex mutex;
+    std::unordered_set<std::string> urlTemplates;
+};
+
+} // namespace mbgl
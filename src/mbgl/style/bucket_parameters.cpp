@@ -1,5 +1,5 @@
 #include <mbgl/style/bucket_parameters.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/tile_layer_filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 namespace mbgl {
@@ -8,9 +8,10 @@ namespace style {
 void BucketParameters::eachFilteredFeature(const Filter& filter,
                                                 std::function<void (const GeometryTileFeature&, std::size_t index, const std::string& layerName)> function) {
     auto name = layer.getName();
+    TileLayerFilter layerFilter(filter, layer);
     for (std::size_t i = 0; !cancelled() && i < layer.featureCount(); i++) {
         auto feature = layer.getFeature(i);
-        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!layerFilter(i, *feature))
             continue;
         function(*feature, i, name);
     }
@@ -0,0 +1,386 @@
+#include <mbgl/style/compiled_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+// Booleans are not numbers, as far as filters are concerned.
+optional<double> numericValue(const Value& value) {
+    if (value.is<int64_t>()) {
+        return double(value.get<int64_t>());
+    } else if (value.is<uint64_t>()) {
+        return double(value.get<uint64_t>());
+    } else if (value.is<double>()) {
+        return value.get<double>();
+    } else {
+        return {};
+    }
+}
+
+// Like `FilterEvaluator`, compares numbers of the same type exactly and numbers of different
+// types as doubles. Both values must be numeric.
+bool numbersEqual(const Value& lhs, const Value& rhs) {
+    if (lhs.which() == rhs.which()) {
+        return lhs == rhs;
+    }
+    return *numericValue(lhs) == *numericValue(rhs);
+}
+
+bool setContains(const std::vector<Value>& numbers, const Value& value) {
+    return std::any_of(numbers.begin(), numbers.end(), [&] (const Value& number) {
+        return numbersEqual(number, value);
+    });
+}
+
+} // namespace
+
+class CompiledFilter::Compiler {
+public:
+    CompiledFilter& result;
+
+    std::size_t operator()(const NullFilter&) const {
+        return constant(true);
+    }
+
+    std::size_t operator()(const EqualsFilter& filter) const {
+        return equals(filter.key, filter.value, false);
+    }
+
+    std::size_t operator()(const NotEqualsFilter& filter) const {
+        return equals(filter.key, filter.value, true);
+    }
+
+    std::size_t operator()(const LessThanFilter& filter) const {
+        return compare(filter.key, filter.value, Comparison::LessThan);
+    }
+
+    std::size_t operator()(const LessThanEqualsFilter& filter) const {
+        return compare(filter.key, filter.value, Comparison::LessThanEquals);
+    }
+
+    std::size_t operator()(const GreaterThanFilter& filter) const {
+        return compare(filter.key, filter.value, Comparison::GreaterThan);
+    }
+
+    std::size_t operator()(const GreaterThanEqualsFilter& filter) const {
+        return compare(filter.key, filter.value, Comparison::GreaterThanEquals);
+    }
+
+    std::size_t operator()(const InFilter& filter) const {
+        return in(filter.key, filter.values, false);
+    }
+
+    std::size_t operator()(const NotInFilter& filter) const {
+        return in(filter.key, filter.values, true);
+    }
+
+    std::size_t operator()(const AnyFilter& filter) const {
+        return compound(Op::Any, filter.filters);
+    }
+
+    std::size_t operator()(const AllFilter& filter) const {
+        return compound(Op::All, filter.filters);
+    }
+
+    std::size_t operator()(const NoneFilter& filter) const {
+        return compound(Op::None, filter.filters);
+    }
+
+    std::size_t operator()(const HasFilter& filter) const {
+        return has(filter.key, false);
+    }
+
+    std::size_t operator()(const NotHasFilter& filter) const {
+        return has(filter.key, true);
+    }
+
+private:
+    std::size_t has(const std::string& key, bool negate) const {
+        if (key == "$type") {
+            return constant(!negate);
+        }
+        return add(property(Op::Has, key, negate));
+    }
+
+    std::size_t equals(const std::string& key, const Value& value, bool negate) const {
+        if (key == "$type") {
+            return type(negate, [&] (const Value& featureType) {
+                return numericValue(value) && numbersEqual(featureType, value);
+            });
+        }
+
+        Op op;
+        if (numericValue(value)) {
+            op = Op::EqualsNumber;
+        } else if (value.is<std::string>()) {
+            op = Op::EqualsString;
+        } else if (value.is<bool>()) {
+            op = Op::EqualsBool;
+        } else {
+            // Null and nested values never compare equal.
+            return constant(negate);
+        }
+
+        Instruction instruction = property(op, key, negate);
+        instruction.operand = value;
+        return add(std::move(instruction));
+    }
+
+    std::size_t compare(const std::string& key, const Value& value, Comparison comparison) const {
+        if (optional<double> number = numericValue(value)) {
+            Instruction instruction = property(Op::NumberRange, key, false);
+            instruction.min = -std::numeric_limits<double>::infinity();
+            instruction.max = std::numeric_limits<double>::infinity();
+            switch (comparison) {
+            case Comparison::LessThan:
+                instruction.max = *number;
+                instruction.maxInclusive = false;
+                break;
+            case Comparison::LessThanEquals:
+                instruction.max = *number;
+                break;
+            case Comparison::GreaterThan:
+                instruction.min = *number;
+                instruction.minInclusive = false;
+                break;
+            case Comparison::GreaterThanEquals:
+                instruction.min = *number;
+                break;
+            }
+            return add(std::move(instruction));
+        }
+
+        Op op;
+        if (value.is<std::string>()) {
+            op = Op::CompareString;
+        } else if (value.is<bool>()) {
+            op = Op::CompareBool;
+        } else {
+            return constant(false);
+        }
+
+        Instruction instruction = property(op, key, false);
+        instruction.comparison = comparison;
+        instruction.operand = value;
+        return add(std::move(instruction));
+    }
+
+    std::size_t in(const std::string& key, const std::vector<Value>& values, bool negate) const {
+        if (key == "$type") {
+            return type(negate, [&] (const Value& featureType) {
+                return std::any_of(values.begin(), values.end(), [&] (const Value& value) {
+                    return numericValue(value) && numbersEqual(featureType, value);
+                });
+            });
+        }
+
+        ValueSet set;
+        for (const auto& value : values) {
+            if (numericValue(value)) {
+                set.numbers.push_back(value);
+            } else if (value.is<std::string>()) {
+                set.strings.push_back(value.get<std::string>());
+            } else if (value.is<bool>()) {
+                (value.get<bool>() ? set.containsTrue : set.containsFalse) = true;
+            }
+        }
+
+        std::sort(set.strings.begin(), set.strings.end());
+        set.strings.erase(std::unique(set.strings.begin(), set.strings.end()), set.strings.end());
+
+        Instruction instruction = property(Op::In, key, negate);
+        instruction.set = result.sets.size();
+        result.sets.push_back(std::move(set));
+        return add(std::move(instruction));
+    }
+
+    std::size_t compound(Op op, const std::vector<Filter>& filters) const {
+        std::vector<std::size_t> compiled;
+        compiled.reserve(filters.size());
+        for (const auto& filter : filters) {
+            std::size_t child = Filter::visit(filter, *this);
+            if (op == Op::All && mergeRange(compiled, child)) {
+                continue;
+            }
+            compiled.push_back(child);
+        }
+
+        Instruction instruction;
+        instruction.op = op;
+        instruction.firstChild = result.children.size();
+        instruction.childCount = compiled.size();
+        result.children.insert(result.children.end(), compiled.begin(), compiled.end());
+        return add(std::move(instruction));
+    }
+
+    // Within an `all` filter, narrows an earlier range over the same value instead of
+    // adding another one, so that e.g. [">=", "rank", 2] and ["<", "rank", 5] read the
+    // property once.
+    bool mergeRange(const std::vector<std::size_t>& compiled, std::size_t child) const {
+        const Instruction& range = result.instructions[child];
+        if (range.op != Op::NumberRange || std::isnan(range.min) || std::isnan(range.max)) {
+            return false;
+        }
+
+        for (auto index : compiled) {
+            Instruction& existing = result.instructions[index];
+            if (existing.op != Op::NumberRange || existing.source != range.source || existing.key != range.key ||
+                std::isnan(existing.min) || std::isnan(existing.max)) {
+                continue;
+            }
+
+            if (range.min > existing.min || (range.min == existing.min && !range.minInclusive)) {
+                existing.min = range.min;
+                existing.minInclusive = range.minInclusive;
+            }
+            if (range.max < existing.max || (range.max == existing.max && !range.maxInclusive)) {
+                existing.max = range.max;
+                existing.maxInclusive = range.maxInclusive;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    template <class Matches>
+    std::size_t type(bool negate, Matches matches) const {
+        Instruction instruction;
+        instruction.op = Op::Type;
+        instruction.negate = negate;
+        for (uint8_t featureType = 0; featureType <= uint8_t(FeatureType::Polygon); ++featureType) {
+            if (matches(Value(uint64_t(featureType)))) {
+                instruction.typeMask |= 1 << featureType;
+            }
+        }
+        return add(std::move(instruction));
+    }
+
+    Instruction property(Op op, const std::string& key, bool negate) const {
+        Instruction instruction;
+        instruction.op = op;
+        instruction.negate = negate;
+        if (key == "$type") {
+            instruction.source = Source::Type;
+        } else if (key == "$id") {
+            instruction.source = Source::Identifier;
+        } else {
+            instruction.key = key;
+        }
+        return instruction;
+    }
+
+    std::size_t constant(bool value) const {
+        Instruction instruction;
+        instruction.op = value ? Op::True : Op::False;
+        return add(std::move(instruction));
+    }
+
+    std::size_t add(Instruction instruction) const {
+        result.instructions.push_back(std::move(instruction));
+        return result.instructions.size() - 1;
+    }
+};
+
+CompiledFilter::CompiledFilter(const Filter& filter) {
+    root = Filter::visit(filter, Compiler { *this });
+}
+
+bool CompiledFilter::operator()(const Feature& feature) const {
+    return operator()(apply_visitor(ToFeatureType(), feature.geometry), feature.id, [&] (const std::string& key) -> optional<Value> {
+        auto it = feature.properties.find(key);
+        if (it == feature.properties.end())
+            return {};
+        return it->second;
+    });
+}
+
+bool CompiledFilter::test(const Instruction& instruction, const optional<Value>& value) const {
+    // Missing values fail every test; negated tests therefore pass.
+    if (!value) {
+        return instruction.negate;
+    }
+
+    auto compare = [&] (const auto& lhs, const auto& rhs) {
+        switch (instruction.comparison) {
+        case Comparison::LessThan:
+            return lhs < rhs;
+        case Comparison::LessThanEquals:
+            return lhs <= rhs;
+        case Comparison::GreaterThan:
+            return lhs > rhs;
+        case Comparison::GreaterThanEquals:
+            return lhs >= rhs;
+        }
+        return false;
+    };
+
+    bool result = false;
+
+    switch (instruction.op) {
+    case Op::Has:
+        result = true;
+        break;
+
+    case Op::EqualsNumber:
+        result = numericValue(*value) && numbersEqual(*value, instruction.operand);
+        break;
+
+    case Op::EqualsString:
+        result = value->is<std::string>() && value->get<std::string>() == instruction.operand.get<std::string>();
+        break;
+
+    case Op::EqualsBool:
+        result = value->is<bool>() && value->get<bool>() == instruction.operand.get<bool>();
+        break;
+
+    case Op::CompareString:
+        result = value->is<std::string>() && compare(value->get<std::string>(), instruction.operand.get<std::string>());
+        break;
+
+    case Op::CompareBool:
+        result = value->is<bool>() && compare(value->get<bool>(), instruction.operand.get<bool>());
+        break;
+
+    case Op::NumberRange:
+        if (optional<double> number = numericValue(*value)) {
+            result = (instruction.minInclusive ? *number >= instruction.min : *number > instruction.min) &&
+                     (instruction.maxInclusive ? *number <= instruction.max : *number < instruction.max);
+        }
+        break;
+
+    case Op::In: {
+        const ValueSet& set = sets[instruction.set];
+        if (value->is<std::string>()) {
+            result = std::binary_search(set.strings.begin(), set.strings.end(), value->get<std::string>());
+        } else if (value->is<bool>()) {
+            result = value->get<bool>() ? set.containsTrue : set.containsFalse;
+        } else if (numericValue(*value)) {
+            result = setContains(set.numbers, *value);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return result != instruction.negate;
+}
+
+optional<Value> CompiledFilter::identifierValue(const optional<FeatureIdentifier>& id) {
+    if (!id) {
+        return {};
+    }
+    return FeatureIdentifier::visit(*id, [] (auto id_) {
+        return Value(std::move(id_));
+    });
+}
+
+} // namespace style
+} // namespace mbgl
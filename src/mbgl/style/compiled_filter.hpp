@@ -0,0 +1,176 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+   A `Filter` lowered into a flat array of instructions, each specialized for the type of
+   the value it compares against:
+
+   * `$type` comparisons become a bitmask of the matching feature types.
+   * Numeric `<`, `<=`, `>`, and `>=` comparisons become numeric ranges, and comparisons of
+     the same property within an `all` filter are merged into a single range.
+   * `in` and `!in` become a sorted set of strings plus a list of numbers.
+   * `!=`, `!in`, and `!has` become their positive counterparts with a negated result.
+
+   Evaluating a `CompiledFilter` gives the same result as evaluating the `Filter` it was
+   compiled from with `FilterEvaluator`, which remains the reference implementation. Use
+   the same way:
+
+       CompiledFilter compiled(filter);
+       if (compiled(feature)) {
+           // matches the filter
+       }
+*/
+class CompiledFilter {
+public:
+    explicit CompiledFilter(const Filter&);
+
+    bool operator()(const Feature&) const;
+
+    template <class PropertyAccessor>
+    bool operator()(FeatureType, const optional<FeatureIdentifier>&, PropertyAccessor) const;
+
+private:
+    enum class Op : uint8_t {
+        True,
+        False,
+        Type,           // typeMask
+        Has,
+        EqualsNumber,   // operand
+        EqualsString,   // operand
+        EqualsBool,     // operand
+        CompareString,  // comparison, operand
+        CompareBool,    // comparison, operand
+        NumberRange,    // min, max
+        In,             // set
+        Any,            // children
+        All,            // children
+        None,           // children
+    };
+
+    enum class Source : uint8_t {
+        Property,
+        Type,
+        Identifier,
+    };
+
+    enum class Comparison : uint8_t {
+        LessThan,
+        LessThanEquals,
+        GreaterThan,
+        GreaterThanEquals,
+    };
+
+    struct ValueSet {
+        std::vector<std::string> strings; // Sorted.
+        std::vector<Value> numbers;
+        bool containsFalse = false;
+        bool containsTrue = false;
+    };
+
+    struct Instruction {
+        Op op;
+        bool negate = false;
+
+        Source source = Source::Property;
+        std::string key;
+
+        uint8_t typeMask = 0;
+        Comparison comparison = Comparison::LessThan;
+        Value operand;
+
+        double min = 0;
+        double max = 0;
+        bool minInclusive = true;
+        bool maxInclusive = true;
+
+        std::size_t set = 0;
+
+        std::size_t firstChild = 0;
+        std::size_t childCount = 0;
+    };
+
+    class Compiler;
+
+    template <class PropertyAccessor>
+    bool evaluate(std::size_t, FeatureType, const optional<FeatureIdentifier>&, const PropertyAccessor&) const;
+
+    bool test(const Instruction&, const optional<Value>&) const;
+
+    static optional<Value> identifierValue(const optional<FeatureIdentifier>&);
+
+    std::vector<Instruction> instructions;
+    std::vector<std::size_t> children;
+    std::vector<ValueSet> sets;
+    std::size_t root = 0;
+};
+
+template <class PropertyAccessor>
+bool CompiledFilter::operator()(FeatureType type, const optional<FeatureIdentifier>& id, PropertyAccessor accessor) const {
+    return evaluate(root, type, id, accessor);
+}
+
+template <class PropertyAccessor>
+bool CompiledFilter::evaluate(std::size_t n,
+                              FeatureType type,
+                              const optional<FeatureIdentifier>& id,
+                              const PropertyAccessor& accessor) const {
+    const Instruction& instruction = instructions[n];
+
+    switch (instruction.op) {
+    case Op::True:
+        return true;
+
+    case Op::False:
+        return false;
+
+    case Op::Type:
+        return bool((instruction.typeMask >> uint8_t(type)) & 1) != instruction.negate;
+
+    case Op::Any:
+        for (std::size_t i = 0; i < instruction.childCount; ++i) {
+            if (evaluate(children[instruction.firstChild + i], type, id, accessor)) {
+                return true;
+            }
+        }
+        return false;
+
+    case Op::All:
+        for (std::size_t i = 0; i < instruction.childCount; ++i) {
+            if (!evaluate(children[instruction.firstChild + i], type, id, accessor)) {
+                return false;
+            }
+        }
+        return true;
+
+    case Op::None:
+        for (std::size_t i = 0; i < instruction.childCount; ++i) {
+            if (evaluate(children[instruction.firstChild + i], type, id, accessor)) {
+                return false;
+            }
+        }
+        return true;
+
+    default:
+        switch (instruction.source) {
+        case Source::Property:
+            return test(instruction, accessor(instruction.key));
+        case Source::Type:
+            return test(instruction, optional<Value>(uint64_t(type)));
+        case Source::Identifier:
+            return test(instruction, identifierValue(id));
+        }
+        return false;
+    }
+}
+
+} // namespace style
+} // namespace mbgl
@@ -17,6 +17,12 @@ const std::string& Layer::Impl::bucketName() const {
     return ref.empty() ? id : ref;
 }
 
+bool Layer::Impl::hasSameLayout(const Impl& other) const {
+    return source == other.source
+        && sourceLayer == other.sourceLayer
+        && filter == other.filter;
+}
+
 bool Layer::Impl::hasRenderPass(RenderPass pass) const {
     return bool(passes & pass);
 }
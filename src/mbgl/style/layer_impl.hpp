@@ -61,6 +61,11 @@ public:
 
     virtual std::unique_ptr<Bucket> createBucket(BucketParameters&) const = 0;
 
+    // Checks whether this layer selects and lays out the features of a tile exactly like
+    // `other`, a layer of the same type, so that a bucket created for one can be reused for
+    // the other. Paint properties don't matter.
+    virtual bool hasSameLayout(const Impl& other) const;
+
     // Checks whether this layer needs to be rendered in the given render pass.
     bool hasRenderPass(RenderPass) const;
 
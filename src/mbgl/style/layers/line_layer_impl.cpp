@@ -43,6 +43,12 @@ std::unique_ptr<Bucket> LineLayer::Impl::createBucket(BucketParameters& paramete
     return std::move(bucket);
 }
 
+bool LineLayer::Impl::hasSameLayout(const Layer::Impl& other) const {
+    const auto& impl = static_cast<const LineLayer::Impl&>(other);
+    return Layer::Impl::hasSameLayout(other)
+        && layout == impl.layout;
+}
+
 float LineLayer::Impl::getLineWidth() const {
     if (paint.lineGapWidth > 0) {
         return paint.lineGapWidth + 2 * paint.lineWidth;
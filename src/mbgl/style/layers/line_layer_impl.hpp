@@ -16,6 +16,7 @@ public:
     bool recalculate(const CalculationParameters&) override;
 
     std::unique_ptr<Bucket> createBucket(BucketParameters&) const override;
+    bool hasSameLayout(const Layer::Impl&) const override;
 
     float getQueryRadius() const override;
     bool queryIntersectsGeometry(
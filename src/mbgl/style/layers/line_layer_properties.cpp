@@ -12,6 +12,13 @@ void LineLayoutProperties::recalculate(const CalculationParameters& parameters)
     lineRoundLimit.calculate(parameters);
 }
 
+bool LineLayoutProperties::operator==(const LineLayoutProperties& other) const {
+    return lineCap == other.lineCap &&
+        lineJoin == other.lineJoin &&
+        lineMiterLimit == other.lineMiterLimit &&
+        lineRoundLimit == other.lineRoundLimit;
+}
+
 void LinePaintProperties::cascade(const CascadeParameters& parameters) {
     lineOpacity.cascade(parameters);
     lineColor.cascade(parameters);
@@ -16,6 +16,8 @@ class LineLayoutProperties {
 public:
     void recalculate(const CalculationParameters&);
 
+    bool operator==(const LineLayoutProperties&) const;
+
     LayoutProperty<LineCapType> lineCap { LineCapType::Butt };
     LayoutProperty<LineJoinType> lineJoin { LineJoinType::Miter };
     LayoutProperty<float> lineMiterLimit { 2 };
@@ -76,5 +76,13 @@ std::unique_ptr<SymbolLayout> SymbolLayer::Impl::createLayout(BucketParameters&
                                           *spriteAtlas);
 }
 
+bool SymbolLayer::Impl::hasSameLayout(const Layer::Impl& other) const {
+    const auto& impl = static_cast<const SymbolLayer::Impl&>(other);
+    return Layer::Impl::hasSameLayout(other)
+        && layout == impl.layout
+        && id == impl.id
+        && spriteAtlas == impl.spriteAtlas;
+}
+
 } // namespace style
 } // namespace mbgl
@@ -21,6 +21,7 @@ public:
 
     std::unique_ptr<Bucket> createBucket(BucketParameters&) const override;
     std::unique_ptr<SymbolLayout> createLayout(BucketParameters&) const;
+    bool hasSameLayout(const Layer::Impl&) const override;
 
     SymbolLayoutProperties layout;
     SymbolPaintProperties paint;
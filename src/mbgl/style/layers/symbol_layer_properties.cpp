@@ -42,6 +42,43 @@ void SymbolLayoutProperties::recalculate(const CalculationParameters& parameters
     textOptional.calculate(parameters);
 }
 
+bool SymbolLayoutProperties::operator==(const SymbolLayoutProperties& other) const {
+    return symbolPlacement == other.symbolPlacement &&
+        symbolSpacing == other.symbolSpacing &&
+        symbolAvoidEdges == other.symbolAvoidEdges &&
+        iconAllowOverlap == other.iconAllowOverlap &&
+        iconIgnorePlacement == other.iconIgnorePlacement &&
+        iconOptional == other.iconOptional &&
+        iconRotationAlignment == other.iconRotationAlignment &&
+        iconSize == other.iconSize &&
+        iconTextFit == other.iconTextFit &&
+        iconTextFitPadding == other.iconTextFitPadding &&
+        iconImage == other.iconImage &&
+        iconRotate == other.iconRotate &&
+        iconPadding == other.iconPadding &&
+        iconKeepUpright == other.iconKeepUpright &&
+        iconOffset == other.iconOffset &&
+        textPitchAlignment == other.textPitchAlignment &&
+        textRotationAlignment == other.textRotationAlignment &&
+        textField == other.textField &&
+        textFont == other.textFont &&
+        textSize == other.textSize &&
+        textMaxWidth == other.textMaxWidth &&
+        textLineHeight == other.textLineHeight &&
+        textLetterSpacing == other.textLetterSpacing &&
+        textJustify == other.textJustify &&
+        textAnchor == other.textAnchor &&
+        textMaxAngle == other.textMaxAngle &&
+        textRotate == other.textRotate &&
+        textPadding == other.textPadding &&
+        textKeepUpright == other.textKeepUpright &&
+        textTransform == other.textTransform &&
+        textOffset == other.textOffset &&
+        textAllowOverlap == other.textAllowOverlap &&
+        textIgnorePlacement == other.textIgnorePlacement &&
+        textOptional == other.textOptional;
+}
+
 void SymbolPaintProperties::cascade(const CascadeParameters& parameters) {
     iconOpacity.cascade(parameters);
     iconColor.cascade(parameters);
@@ -16,6 +16,8 @@ class SymbolLayoutProperties {
 public:
     void recalculate(const CalculationParameters&);
 
+    bool operator==(const SymbolLayoutProperties&) const;
+
     LayoutProperty<SymbolPlacementType> symbolPlacement { SymbolPlacementType::Point };
     LayoutProperty<float> symbolSpacing { 250 };
     LayoutProperty<bool> symbolAvoidEdges { false };
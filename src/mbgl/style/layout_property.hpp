@@ -31,6 +31,11 @@ public:
         }
     }
 
+    // Properties are equal if they were set to the same value, and therefore evaluate the same.
+    bool operator==(const LayoutProperty& other) const {
+        return currentValue == other.currentValue;
+    }
+
     // TODO: remove / privatize
     operator T() const { return value; }
     T value;
@@ -31,7 +31,9 @@ Source::Impl::Impl(SourceType type_, std::string id_, Source& base_)
       observer(&nullObserver) {
 }
 
-Source::Impl::~Impl() = default;
+Source::Impl::~Impl() {
+    setTileCache(nullptr);
+}
 
 bool Source::Impl::isLoaded() const {
     if (!loaded) return false;
@@ -48,7 +50,9 @@ bool Source::Impl::isLoaded() const {
 void Source::Impl::invalidateTiles() {
     tiles.clear();
     renderTiles.clear();
-    cache.clear();
+    if (cache) {
+        cache->clear(id);
+    }
 }
 
 void Source::Impl::startRender(algorithm::ClipIDGenerator& generator,
@@ -111,13 +115,16 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     auto retainTileFn = [&retain](Tile& tile, Resource::Necessity necessity) -> void {
         retain.emplace(tile.id);
         tile.setNecessity(necessity);
+        tile.setPriority(necessity == Resource::Necessity::Required
+                             ? Tile::Priority::VisibleIdeal
+                             : Tile::Priority::VisibleFallback);
     };
     auto getTileFn = [this](const OverscaledTileID& tileID) -> Tile* {
         auto it = tiles.find(tileID);
         return it == tiles.end() ? nullptr : it->second.get();
     };
     auto createTileFn = [this, &parameters](const OverscaledTileID& tileID) -> Tile* {
-        std::unique_ptr<Tile> tile = cache.get(tileID);
+        std::unique_ptr<Tile> tile = cache ? cache->get(id, tileID) : nullptr;
         if (!tile) {
             tile = createTile(tileID, parameters);
             if (tile) {
@@ -137,13 +144,13 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
                                  idealTiles, zoomRange, tileZoom);
 
-    if (type != SourceType::Raster && type != SourceType::Annotations && cache.getSize() == 0) {
+    if (cache && type != SourceType::Raster && type != SourceType::Annotations && cache->getSize(id) == 0) {
         size_t conservativeCacheSize =
             ((float)parameters.transformState.getWidth() / util::tileSize) *
             ((float)parameters.transformState.getHeight() / util::tileSize) *
             (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
             0.5;
-        cache.setSize(conservativeCacheSize);
+        cache->setSize(id, conservativeCacheSize);
     }
 
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
@@ -153,7 +160,10 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     while (tilesIt != tiles.end()) {
         if (retainIt == retain.end() || tilesIt->first < *retainIt) {
             tilesIt->second->setNecessity(Tile::Necessity::Optional);
-            cache.add(tilesIt->first, std::move(tilesIt->second));
+            tilesIt->second->setPriority(Tile::Priority::Prefetch);
+            if (cache) {
+                cache->add(id, tilesIt->first, std::move(tilesIt->second));
+            }
             tiles.erase(tilesIt++);
         } else {
             if (!(*retainIt < tilesIt->first)) {
@@ -163,9 +173,14 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         }
     }
 
-    const PlacementConfig config { parameters.transformState.getAngle(),
-                                   parameters.transformState.getPitch(),
-                                   parameters.debugOptions & MapDebugOptions::Collision };
+    PlacementConfig config { parameters.transformState.getAngle(),
+                             parameters.transformState.getPitch(),
+                             parameters.debugOptions & MapDebugOptions::Collision };
+
+    // Still images are placed for their exact angle and pitch.
+    if (parameters.mode == MapMode::Continuous) {
+        config = config.quantized();
+    }
 
     for (auto& pair : tiles) {
         pair.second->setPlacementConfig(config);
@@ -173,7 +188,9 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
 }
 
 void Source::Impl::reloadTiles() {
-    cache.clear();
+    if (cache) {
+        cache->clear(id);
+    }
 
     for (auto& pair : tiles) {
         auto tile = pair.second.get();
@@ -236,12 +253,24 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
     return result;
 }
 
+void Source::Impl::setTileCache(TileCache* cache_) {
+    // Dropping the source's cached tiles also drops its cache size.
+    if (cache) {
+        cache->setSize(id, 0);
+    }
+    cache = cache_;
+}
+
 void Source::Impl::setCacheSize(size_t size) {
-    cache.setSize(size);
+    if (cache) {
+        cache->setSize(id, size);
+    }
 }
 
 void Source::Impl::onLowMemory() {
-    cache.clear();
+    if (cache) {
+        cache->clear(id);
+    }
 }
 
 void Source::Impl::setObserver(SourceObserver* observer_) {
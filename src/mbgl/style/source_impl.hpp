@@ -62,8 +62,9 @@ public:
     std::unordered_map<std::string, std::vector<Feature>>
     queryRenderedFeatures(const QueryParameters&) const;
 
+    void setTileCache(TileCache*);
     void setCacheSize(size_t);
-    void onLowMemory();
+    virtual void onLowMemory();
 
     void setObserver(SourceObserver*);
     void dumpDebugLogs() const;
@@ -97,7 +98,9 @@ private:
     virtual std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) = 0;
 
     std::map<UnwrappedTileID, RenderTile> renderTiles;
-    TileCache cache;
+
+    // Shared with the other sources of the style; null until the source is added to one.
+    TileCache* cache = nullptr;
 };
 
 } // namespace style
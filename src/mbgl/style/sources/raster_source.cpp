@@ -5,7 +5,20 @@ namespace mbgl {
 namespace style {
 
 RasterSource::RasterSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize)
-    : Source(SourceType::Raster, std::make_unique<RasterSource::Impl>(std::move(id), *this, std::move(urlOrTileset), tileSize)) {
+    : Source(SourceType::Raster, std::make_unique<RasterSource::Impl>(std::move(id), *this, std::move(urlOrTileset), tileSize)),
+      impl(static_cast<Impl*>(baseImpl.get())) {
+}
+
+void RasterSource::setPackOpaqueTiles(bool pack) {
+    impl->opaqueFormat = pack ? gl::TextureFormat::RGB565 : gl::TextureFormat::RGBA;
+}
+
+bool RasterSource::getPackOpaqueTiles() const {
+    return impl->opaqueFormat == gl::TextureFormat::RGB565;
+}
+
+RasterSource::MemoryUsage RasterSource::getMemoryUsage() const {
+    return impl->getMemoryUsage();
 }
 
 } // namespace style
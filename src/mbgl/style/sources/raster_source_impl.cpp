@@ -1,5 +1,6 @@
 #include <mbgl/style/sources/raster_source_impl.hpp>
 #include <mbgl/tile/raster_tile.hpp>
+#include <mbgl/util/image_pool.hpp>
 
 namespace mbgl {
 namespace style {
@@ -7,12 +8,31 @@ namespace style {
 RasterSource::Impl::Impl(std::string id_, Source& base_,
                          variant<std::string, Tileset> urlOrTileset_,
                          uint16_t tileSize_)
-    : TileSourceImpl(SourceType::Raster, std::move(id_), base_, std::move(urlOrTileset_), tileSize_) {
+    : TileSourceImpl(SourceType::Raster, std::move(id_), base_, std::move(urlOrTileset_), tileSize_),
+      // Keeps idle buffers for up to 32 tiles of 512 pixels.
+      imagePool(std::make_shared<util::ImagePool>(32 * 512 * 512 * 4)) {
 }
 
 std::unique_ptr<Tile> RasterSource::Impl::createTile(const OverscaledTileID& tileID,
                                                const UpdateParameters& parameters) {
-    return std::make_unique<RasterTile>(tileID, parameters, tileset);
+    return std::make_unique<RasterTile>(tileID, parameters, tileset, imagePool, opaqueFormat);
+}
+
+RasterSource::MemoryUsage RasterSource::Impl::getMemoryUsage() const {
+    RasterSource::MemoryUsage usage;
+    for (const auto& pair : tiles) {
+        // All tiles of the source are created by createTile().
+        const auto& tile = static_cast<const RasterTile&>(*pair.second);
+        usage.images += tile.getImageByteSize();
+        usage.textures += tile.getTextureByteSize();
+    }
+    usage.pooled = imagePool->getBytes();
+    return usage;
+}
+
+void RasterSource::Impl::onLowMemory() {
+    Source::Impl::onLowMemory();
+    imagePool->clear();
 }
 
 } // namespace style
@@ -2,16 +2,32 @@
 
 #include <mbgl/style/sources/raster_source.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/gl/types.hpp>
+
+#include <memory>
 
 namespace mbgl {
+
+namespace util {
+class ImagePool;
+} // namespace util
+
 namespace style {
 
 class RasterSource::Impl : public TileSourceImpl {
 public:
     Impl(std::string id, Source&, variant<std::string, Tileset>, uint16_t tileSize);
 
+    RasterSource::MemoryUsage getMemoryUsage() const;
+    void onLowMemory() override;
+
+    gl::TextureFormat opaqueFormat = gl::TextureFormat::RGBA;
+
 private:
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
+
+    // Shared with the tiles, their workers and their buckets, any of which may outlive the source.
+    const std::shared_ptr<util::ImagePool> imagePool;
 };
 
 } // namespace style
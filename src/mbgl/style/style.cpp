@@ -131,6 +131,7 @@ void Style::setJSON(const std::string& json) {
 
 void Style::addSource(std::unique_ptr<Source> source) {
     source->baseImpl->setObserver(this);
+    source->baseImpl->setTileCache(&tileCache);
     sources.emplace_back(std::move(source));
 }
 
@@ -451,6 +452,14 @@ void Style::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void Style::setTileCacheMemoryBudget(size_t bytes) {
+    tileCache.setMaxBytes(bytes);
+}
+
+std::unordered_map<std::string, size_t> Style::getTileCacheMemoryUsage() const {
+    return tileCache.getBytesPerSource();
+}
+
 void Style::onLowMemory() {
     for (const auto& source : sources) {
         source->baseImpl->onLowMemory();
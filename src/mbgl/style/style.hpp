@@ -9,6 +9,7 @@
 #include <mbgl/sprite/sprite_atlas_observer.hpp>
 #include <mbgl/map/mode.hpp>
 #include <mbgl/map/zoom_history.hpp>
+#include <mbgl/tile/tile_cache.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
@@ -19,6 +20,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
@@ -97,6 +99,8 @@ public:
     float getQueryRadius() const;
 
     void setSourceTileCacheSize(size_t);
+    void setTileCacheMemoryBudget(size_t);
+    std::unordered_map<std::string, size_t> getTileCacheMemoryUsage() const;
     void onLowMemory();
 
     void dumpDebugLogs() const;
@@ -107,6 +111,9 @@ public:
     std::unique_ptr<LineAtlas> lineAtlas;
 
 private:
+    // Declared before `sources`, which remove their cached tiles when destroyed.
+    TileCache tileCache;
+
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
     std::vector<std::string> classes;
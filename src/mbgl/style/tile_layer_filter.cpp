@@ -0,0 +1,155 @@
+#include <mbgl/style/tile_layer_filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+namespace mbgl {
+namespace style {
+
+class TileLayerFilter::Compiler {
+public:
+    TileLayerFilter& result;
+    const GeometryTileColumns* columns;
+
+    std::size_t operator()(const NullFilter&) const {
+        return constant(true);
+    }
+
+    std::size_t operator()(const AnyFilter& filter) const {
+        return compound(Node::Type::Any, filter.filters);
+    }
+
+    std::size_t operator()(const AllFilter& filter) const {
+        return compound(Node::Type::All, filter.filters);
+    }
+
+    std::size_t operator()(const NoneFilter& filter) const {
+        return compound(Node::Type::None, filter.filters);
+    }
+
+    // Comparisons, membership tests, and has / !has.
+    template <class PropertyFilter>
+    std::size_t operator()(const PropertyFilter& propertyFilter) const {
+        Filter filter(propertyFilter);
+
+        if (propertyFilter.key == "$type" || propertyFilter.key == "$id") {
+            return feature(filter);
+        }
+
+        // The result of the filter for a feature whose property has the given value.
+        auto evaluate = [&] (optional<Value> value) {
+            return filter(FeatureType::Unknown, {}, [&] (const std::string&) { return value; });
+        };
+
+        const bool missing = evaluate({});
+
+        optional<uint32_t> keyIndex = columns->getKeyIndex(propertyFilter.key);
+        if (!keyIndex) {
+            return constant(missing);
+        }
+
+        Node node;
+        node.type = Node::Type::Property;
+        node.result = missing;
+        node.column = &columns->getColumn(*keyIndex);
+
+        const std::vector<Value>& values = columns->getValues();
+        node.matches.reserve(values.size());
+        for (const auto& value : values) {
+            node.matches.push_back(evaluate(value));
+        }
+
+        return add(std::move(node));
+    }
+
+    std::size_t constant(bool value) const {
+        Node node;
+        node.type = Node::Type::Constant;
+        node.result = value;
+        return add(std::move(node));
+    }
+
+    std::size_t feature(const Filter& filter) const {
+        Node node;
+        node.type = Node::Type::Feature;
+        node.featureFilter = result.featureFilters.size();
+        result.featureFilters.emplace_back(filter);
+        return add(std::move(node));
+    }
+
+    std::size_t compound(Node::Type type, const std::vector<Filter>& filters) const {
+        std::vector<std::size_t> compiled;
+        compiled.reserve(filters.size());
+        for (const auto& filter : filters) {
+            compiled.push_back(Filter::visit(filter, *this));
+        }
+
+        Node node;
+        node.type = type;
+        node.firstChild = result.children.size();
+        node.childCount = compiled.size();
+        result.children.insert(result.children.end(), compiled.begin(), compiled.end());
+        return add(std::move(node));
+    }
+
+    std::size_t add(Node node) const {
+        result.nodes.push_back(std::move(node));
+        return result.nodes.size() - 1;
+    }
+};
+
+TileLayerFilter::TileLayerFilter(const Filter& filter, const GeometryTileLayer& layer) {
+    Compiler compiler { *this, layer.getColumns() };
+    root = compiler.columns ? Filter::visit(filter, compiler) : compiler.feature(filter);
+}
+
+bool TileLayerFilter::operator()(std::size_t index, const GeometryTileFeature& feature) const {
+    return evaluate(root, index, feature);
+}
+
+bool TileLayerFilter::evaluate(std::size_t n, std::size_t index, const GeometryTileFeature& feature) const {
+    const Node& node = nodes[n];
+
+    switch (node.type) {
+    case Node::Type::Constant:
+        return node.result;
+
+    case Node::Type::Property: {
+        const uint32_t value = (*node.column)[index];
+        return value == GeometryTileColumns::noValue ? node.result : node.matches[value];
+    }
+
+    case Node::Type::Feature:
+        return featureFilters[node.featureFilter](feature.getType(), feature.getID(), [&] (const std::string& key) {
+            return feature.getValue(key);
+        });
+
+    case Node::Type::Any:
+        for (std::size_t i = 0; i < node.childCount; ++i) {
+            if (evaluate(children[node.firstChild + i], index, feature)) {
+                return true;
+            }
+        }
+        return false;
+
+    case Node::Type::All:
+        for (std::size_t i = 0; i < node.childCount; ++i) {
+            if (!evaluate(children[node.firstChild + i], index, feature)) {
+                return false;
+            }
+        }
+        return true;
+
+    case Node::Type::None:
+        for (std::size_t i = 0; i < node.childCount; ++i) {
+            if (evaluate(children[node.firstChild + i], index, feature)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace style
+} // namespace mbgl
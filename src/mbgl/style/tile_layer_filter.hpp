@@ -0,0 +1,80 @@
+#pragma once
+
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTileLayer;
+class GeometryTileFeature;
+class GeometryTileColumns;
+
+namespace style {
+
+/*
+   A `Filter` bound to the features of a single `GeometryTileLayer`.
+
+   If the layer supports columnar property access, every property key in the filter is
+   resolved to a key index once, and every comparison against a property is evaluated once
+   per distinct value in the layer. Evaluating the filter for a feature then amounts to a
+   few array lookups, with no string hashing or `Value` copies. `$type` and `$id`
+   comparisons, and layers without columnar access, fall back to a `CompiledFilter`.
+
+       TileLayerFilter layerFilter(filter, layer);
+       for (std::size_t i = 0; i < layer.featureCount(); i++) {
+           auto feature = layer.getFeature(i);
+           if (layerFilter(i, *feature)) {
+               // matches the filter
+           }
+       }
+*/
+class TileLayerFilter {
+public:
+    TileLayerFilter(const Filter&, const GeometryTileLayer&);
+
+    bool operator()(std::size_t index, const GeometryTileFeature&) const;
+
+private:
+    struct Node {
+        enum class Type : uint8_t {
+            Constant,
+            Property,
+            Feature,
+            Any,
+            All,
+            None,
+        };
+
+        Type type;
+
+        // Constant: the result. Property: the result for features lacking the property.
+        bool result = false;
+
+        // Property: value index per feature, and the result per value index.
+        const std::vector<uint32_t>* column = nullptr;
+        std::vector<uint8_t> matches;
+
+        // Feature: the index of the filter in `featureFilters` to evaluate against the
+        // feature itself.
+        std::size_t featureFilter = 0;
+
+        // Any, All, None: the range of `children` holding the indices of child nodes.
+        std::size_t firstChild = 0;
+        std::size_t childCount = 0;
+    };
+
+    class Compiler;
+
+    bool evaluate(std::size_t node, std::size_t index, const GeometryTileFeature&) const;
+
+    std::vector<Node> nodes;
+    std::vector<std::size_t> children;
+    std::vector<CompiledFilter> featureFilters;
+    std::size_t root = 0;
+};
+
+} // namespace style
+} // namespace mbgl
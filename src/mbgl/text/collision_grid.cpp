@@ -0,0 +1,95 @@
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+
+namespace {
+
+// Anchors of labels lie within or slightly beyond the tile, and are rotated about the tile's
+// origin, so boxes are found in an area twice the tile extent in every direction.
+const float gridMin = -2.0f * util::EXTENT;
+const float gridMax = 2.0f * util::EXTENT;
+const uint32_t gridSize = 32;
+const float gridScale = gridSize / (gridMax - gridMin);
+
+} // namespace
+
+CollisionGrid::CollisionGrid()
+    : cells(gridSize * gridSize, -1) {
+}
+
+uint32_t CollisionGrid::cellCoord(float coord) const {
+    return util::clamp<float>(std::floor((coord - gridMin) * gridScale), 0, gridSize - 1);
+}
+
+void CollisionGrid::insert(float minX, float minY, float maxX, float maxY,
+                           const Point<float>& anchor,
+                           const CollisionBox& box,
+                           const IndexedSubfeature& feature) {
+    const auto index = static_cast<uint32_t>(size());
+
+    anchorX.push_back(anchor.x);
+    anchorY.push_back(anchor.y);
+    x1.push_back(box.x1);
+    y1.push_back(box.y1);
+    x2.push_back(box.x2);
+    y2.push_back(box.y2);
+    maxScale.push_back(box.maxScale);
+    placementScale.push_back(box.placementScale);
+    features.push_back(feature);
+
+    minXs.push_back(minX);
+    minYs.push_back(minY);
+    maxXs.push_back(maxX);
+    maxYs.push_back(maxY);
+    lastQuery.push_back(queryCount);
+
+    const uint32_t cx1 = cellCoord(minX);
+    const uint32_t cy1 = cellCoord(minY);
+    const uint32_t cx2 = cellCoord(maxX);
+    const uint32_t cy2 = cellCoord(maxY);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            int32_t& head = cells[y * gridSize + x];
+            nodes.push_back({ index, head });
+            head = static_cast<int32_t>(nodes.size() - 1);
+        }
+    }
+}
+
+void CollisionGrid::query(float minX, float minY, float maxX, float maxY, std::vector<uint32_t>& result) {
+    if (nodes.empty()) {
+        return;
+    }
+
+    ++queryCount;
+
+    const uint32_t cx1 = cellCoord(minX);
+    const uint32_t cy1 = cellCoord(minY);
+    const uint32_t cx2 = cellCoord(maxX);
+    const uint32_t cy2 = cellCoord(maxY);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            for (int32_t node = cells[y * gridSize + x]; node != -1; node = nodes[node].next) {
+                const uint32_t box = nodes[node].box;
+                if (lastQuery[box] == queryCount) {
+                    continue;
+                }
+                lastQuery[box] = queryCount;
+
+                // Boxes touching the area intersect it, as in an R-tree query.
+                if (minXs[box] <= maxX && minYs[box] <= maxY &&
+                    maxXs[box] >= minX && maxYs[box] >= minY) {
+                    result.push_back(box);
+                }
+            }
+        }
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mbgl/text/collision_feature.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+/*
+   A uniform grid of the collision boxes placed in a `CollisionTile`, used instead of an R-tree
+   when building with MBGL_COLLISION_GRID.
+
+   Boxes are stored in insertion order as a structure of arrays, so that the boxes found by a
+   query can be tested against a new box in tight loops that the compiler can vectorize. Each
+   cell holds a linked list of the boxes overlapping it, so inserting a box during placement
+   only appends to a few arrays.
+
+   Coordinates are those of the collision tile: tile coordinates, rotated with the map. Boxes
+   beyond the extent of the grid are kept in its outermost cells.
+*/
+class CollisionGrid {
+public:
+    CollisionGrid();
+
+    // `minX`...`maxY` is the area the box covers; `anchor` is the box's anchor, rotated with
+    // the map.
+    void insert(float minX, float minY, float maxX, float maxY,
+                const Point<float>& anchor,
+                const CollisionBox&,
+                const IndexedSubfeature&);
+
+    // Appends the indices of the boxes that intersect the given area to `result`, each once.
+    void query(float minX, float minY, float maxX, float maxY, std::vector<uint32_t>& result);
+
+    std::size_t size() const {
+        return anchorX.size();
+    }
+
+    // The anchor, extent, and scales of each box, as in `CollisionBox`.
+    std::vector<float> anchorX;
+    std::vector<float> anchorY;
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> x2;
+    std::vector<float> y2;
+    std::vector<float> maxScale;
+    std::vector<float> placementScale;
+
+    std::vector<IndexedSubfeature> features;
+
+private:
+    uint32_t cellCoord(float) const;
+
+    // The area covered by each box.
+    std::vector<float> minXs;
+    std::vector<float> minYs;
+    std::vector<float> maxXs;
+    std::vector<float> maxYs;
+
+    // The first node of each cell's list, or -1.
+    std::vector<int32_t> cells;
+
+    struct Node {
+        uint32_t box;
+        int32_t next;
+    };
+    std::vector<Node> nodes;
+
+    // The number of the query that most recently returned each box, for deduplication.
+    std::vector<uint32_t> lastQuery;
+    uint32_t queryCount = 0;
+};
+
+} // namespace mbgl
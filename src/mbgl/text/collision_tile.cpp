@@ -3,6 +3,7 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace mbgl {
@@ -20,8 +21,6 @@ CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_
         // bottom
         CollisionBox(Point<float>(0, util::EXTENT), -infinity, 0, infinity, 0, infinity),
     }}) {
-    tree.clear();
-
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -77,6 +76,60 @@ float CollisionTile::findPlacementScale(float minPlacementScale, const Point<flo
     return minPlacementScale;
 }
 
+#if MBGL_COLLISION_GRID
+float CollisionTile::findPlacementScale(float minPlacementScale, const Point<float>& anchor,
+        const CollisionBox& box, const CollisionGrid& blockingGrid, const std::vector<uint32_t>& blocking) const {
+    // The same computation as above, in blocks: the properties of the blocking boxes are
+    // gathered into small arrays, which the loop below processes without branches.
+    constexpr std::size_t blockSize = 16;
+    float s1[blockSize], s2[blockSize], s3[blockSize], s4[blockSize];
+    float blockingMaxScale[blockSize], blockingPlacementScale[blockSize];
+
+    for (std::size_t begin = 0; begin < blocking.size(); begin += blockSize) {
+        const std::size_t count = std::min(blockSize, blocking.size() - begin);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const uint32_t j = blocking[begin + i];
+            const float dx = anchor.x - blockingGrid.anchorX[j];
+            const float dy = anchor.y - blockingGrid.anchorY[j];
+            s1[i] = (blockingGrid.x1[j] - box.x2) / dx;
+            s2[i] = (blockingGrid.x2[j] - box.x1) / dx;
+            s3[i] = (blockingGrid.y1[j] - box.y2) * yStretch / dy;
+            s4[i] = (blockingGrid.y2[j] - box.y1) * yStretch / dy;
+            blockingMaxScale[i] = blockingGrid.maxScale[j];
+            blockingPlacementScale[i] = blockingGrid.placementScale[j];
+        }
+
+        float blockScale = minPlacementScale;
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool nanX = s1[i] != s1[i] || s2[i] != s2[i];
+            const bool nanY = s3[i] != s3[i] || s4[i] != s4[i];
+            const float sx1 = nanX ? 1.0f : s1[i];
+            const float sx2 = nanX ? 1.0f : s2[i];
+            const float sy1 = nanY ? 1.0f : s3[i];
+            const float sy2 = nanY ? 1.0f : s4[i];
+
+            const float scaleX = sx1 > sx2 ? sx1 : sx2;
+            const float scaleY = sy1 > sy2 ? sy1 : sy2;
+            float collisionFreeScale = scaleX < scaleY ? scaleX : scaleY;
+            collisionFreeScale = collisionFreeScale < blockingMaxScale[i] ? collisionFreeScale : blockingMaxScale[i];
+            collisionFreeScale = collisionFreeScale < box.maxScale ? collisionFreeScale : box.maxScale;
+
+            // Only collisions while the other label is visible raise the placement scale.
+            const float candidate = collisionFreeScale >= blockingPlacementScale[i] ? collisionFreeScale : blockScale;
+            blockScale = candidate > blockScale ? candidate : blockScale;
+        }
+
+        minPlacementScale = blockScale;
+        if (minPlacementScale >= maxScale) {
+            return minPlacementScale;
+        }
+    }
+
+    return minPlacementScale;
+}
+#endif
+
 float CollisionTile::placeFeature(const CollisionFeature& feature, const bool allowOverlap, const bool avoidEdges) {
 
     float minPlacementScale = minScale;
@@ -85,6 +138,15 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, const bool al
         const auto anchor = util::matrixMultiply(rotationMatrix, box.anchor);
 
         if (!allowOverlap) {
+#if MBGL_COLLISION_GRID
+            const Box treeBox = getTreeBox(anchor, box);
+            candidates.clear();
+            grid.query(treeBox.min_corner().get<0>(), treeBox.min_corner().get<1>(),
+                       treeBox.max_corner().get<0>(), treeBox.max_corner().get<1>(), candidates);
+
+            minPlacementScale = findPlacementScale(minPlacementScale, anchor, box, grid, candidates);
+            if (minPlacementScale >= maxScale) return minPlacementScale;
+#else
             for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
                 const CollisionBox& blocking = std::get<1>(*it);
                 Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
@@ -92,6 +154,7 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, const bool al
                 minPlacementScale = findPlacementScale(minPlacementScale, anchor, box, blockingAnchor, blocking);
                 if (minPlacementScale >= maxScale) return minPlacementScale;
             }
+#endif
         }
 
         if (avoidEdges) {
@@ -127,6 +190,16 @@ void CollisionTile::insertFeature(CollisionFeature& feature, const float minPlac
     }
 
     if (minPlacementScale < maxScale) {
+#if MBGL_COLLISION_GRID
+        CollisionGrid& target = ignorePlacement ? ignoredGrid : grid;
+        for (auto& box : feature.boxes) {
+            const Point<float> anchor = util::matrixMultiply(rotationMatrix, box.anchor);
+            const Box treeBox = getTreeBox(anchor, box);
+            target.insert(treeBox.min_corner().get<0>(), treeBox.min_corner().get<1>(),
+                          treeBox.max_corner().get<0>(), treeBox.max_corner().get<1>(),
+                          anchor, box, feature.indexedFeature);
+        }
+#else
         std::vector<CollisionTreeBox> treeBoxes;
         for (auto& box : feature.boxes) {
             treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, feature.indexedFeature);
@@ -136,6 +209,7 @@ void CollisionTile::insertFeature(CollisionFeature& feature, const float minPlac
         } else {
             tree.insert(treeBoxes.begin(), treeBoxes.end());
         }
+#endif
     }
 
 }
@@ -160,6 +234,35 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const mapbox:
 
     auto anchor = util::matrixMultiply(rotationMatrix, convertPoint<float>(box.min));
     CollisionBox queryBox(anchor, 0, 0, box.max.x - box.min.x, box.max.y - box.min.y, scale);
+#if MBGL_COLLISION_GRID
+    const Box treeBox = getTreeBox(anchor, queryBox);
+
+    auto fn = [&] (CollisionGrid& grid_) {
+        candidates.clear();
+        grid_.query(treeBox.min_corner().get<0>(), treeBox.min_corner().get<1>(),
+                    treeBox.max_corner().get<0>(), treeBox.max_corner().get<1>(), candidates);
+
+        for (auto i : candidates) {
+            const IndexedSubfeature& indexedFeature = grid_.features[i];
+
+            auto& seenFeatures = sourceLayerFeatures[indexedFeature.sourceLayerName];
+            if (seenFeatures.find(indexedFeature.index) == seenFeatures.end()) {
+                const Point<float> blockingAnchor { grid_.anchorX[i], grid_.anchorY[i] };
+                CollisionBox blocking(blockingAnchor, grid_.x1[i], grid_.y1[i], grid_.x2[i], grid_.y2[i], grid_.maxScale[i]);
+                blocking.placementScale = grid_.placementScale[i];
+
+                float minPlacementScale = findPlacementScale(minScale, anchor, queryBox, blockingAnchor, blocking);
+                if (minPlacementScale >= scale) {
+                    seenFeatures.insert(indexedFeature.index);
+                    result.push_back(indexedFeature);
+                }
+            }
+        }
+    };
+
+    fn(grid);
+    fn(ignoredGrid);
+#else
     auto predicates = bgi::intersects(getTreeBox(anchor, queryBox));
 
     auto fn = [&] (const Tree& tree_) {
@@ -181,6 +284,7 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const mapbox:
 
     fn(tree);
     fn(ignoredTree);
+#endif
 
     return result;
 }
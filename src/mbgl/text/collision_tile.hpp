@@ -3,6 +3,10 @@
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/text/placement_config.hpp>
 
+#if MBGL_COLLISION_GRID
+#include <mbgl/text/collision_grid.hpp>
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -55,8 +59,19 @@ private:
             const Point<float>& blockingAnchor, const CollisionBox& blocking);
     Box getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale = 1.0);
 
+#if MBGL_COLLISION_GRID
+    // Like the above, for all of the given boxes in the grid at once.
+    float findPlacementScale(float minPlacementScale,
+            const Point<float>& anchor, const CollisionBox& box,
+            const CollisionGrid&, const std::vector<uint32_t>& blocking) const;
+
+    CollisionGrid grid;
+    CollisionGrid ignoredGrid;
+    std::vector<uint32_t> candidates;
+#else
     Tree tree;
     Tree ignoredTree;
+#endif
     std::array<float, 4> rotationMatrix;
     std::array<float, 4> reverseRotationMatrix;
     std::array<CollisionBox, 4> edges;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <mbgl/math/wrap.hpp>
+
+#include <cmath>
+
 namespace mbgl {
 
 class PlacementConfig {
@@ -16,6 +20,21 @@ public:
         return !operator==(rhs);
     }
 
+    // Symbol placement changes only gradually with the angle and pitch of the map. Rounding
+    // them to these steps lets a rotating or tilting map skip placement on most frames, and
+    // makes it likely that an earlier placement can be reused.
+    static constexpr float angleStep = M_PI / 90;
+    static constexpr float pitchStep = M_PI / 180;
+
+    PlacementConfig quantized() const {
+        const float quantizedAngle = std::round(util::wrap<float>(angle, 0, 2 * M_PI) / angleStep) * angleStep;
+        return {
+            quantizedAngle >= float(2 * M_PI) ? 0 : quantizedAngle,
+            std::round(pitch / pitchStep) * pitchStep,
+            debug
+        };
+    }
+
 public:
     float angle;
     float pitch;
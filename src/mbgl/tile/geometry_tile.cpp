@@ -6,12 +6,17 @@
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/platform/log.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
@@ -61,6 +66,30 @@ void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
         return;
     }
 
+    auto it = std::find_if(retainedPlacements.begin(), retainedPlacements.end(), [&] (const auto& placement) {
+        return placement.config == desiredConfig;
+    });
+
+    if (it != retainedPlacements.end()) {
+        Placement placement = std::move(*it);
+        retainedPlacements.erase(it);
+        retainPlacement();
+
+        symbolBuckets = std::move(placement.buckets);
+        featureIndex->setCollisionTile(std::move(placement.collisionTile));
+        placedConfig = placement.config;
+
+        // Placements still running on the worker were requested for other configs, and must
+        // not replace this one when they arrive. The worker places later layouts for this config.
+        ++correlationID;
+        reusedPlacementID = correlationID;
+        worker.invoke(&GeometryTileWorker::setPlacedConfig, desiredConfig, correlationID);
+        if (layoutResultID >= layoutRequestID) {
+            availableData = DataAvailability::All;
+        }
+        return;
+    }
+
     ++correlationID;
     worker.invoke(&GeometryTileWorker::setPlacementConfig, desiredConfig, correlationID);
 }
@@ -89,37 +118,109 @@ void GeometryTile::redoLayout() {
     }
 
     ++correlationID;
+    layoutRequestID = correlationID;
+    updateWorkerPriority();
     worker.invoke(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
 }
 
+void GeometryTile::setPriority(Priority priority_) {
+    if (priority == priority_) {
+        return;
+    }
+
+    priority = priority_;
+    updateWorkerPriority();
+}
+
+void GeometryTile::updateWorkerPriority() {
+    Priority effective = priority;
+    if (priority != Priority::Prefetch && isRenderable() && layoutResultID >= layoutRequestID) {
+        effective = Priority::PlacementOnly;
+    }
+
+    switch (effective) {
+    case Priority::VisibleIdeal:
+        worker.setPriority(MailboxPriority::Highest);
+        break;
+    case Priority::VisibleFallback:
+        worker.setPriority(MailboxPriority::High);
+        break;
+    case Priority::PlacementOnly:
+        worker.setPriority(MailboxPriority::Low);
+        break;
+    case Priority::Prefetch:
+        worker.setPriority(MailboxPriority::Lowest);
+        break;
+    }
+}
+
 void GeometryTile::onLayout(LayoutResult result) {
     availableData = DataAvailability::Some;
+    for (const auto& name : result.reusedBuckets) {
+        auto it = buckets.find(name);
+        assert(it != buckets.end());
+        if (it != buckets.end()) {
+            result.buckets.emplace(name, std::move(it->second));
+        }
+    }
     buckets = std::move(result.buckets);
     featureIndex = std::move(result.featureIndex);
     data = std::move(result.tileData);
+    symbolBuckets.clear();
+    retainedPlacements.clear();
+    if (result.correlationID < reusedPlacementID) {
+        // The placement that follows this layout was made for a config from before a retained
+        // placement was swapped in, and is dropped. Let the next config update request another.
+        placedConfig = {};
+    }
+    rebuiltLayouts = result.rebuiltLayouts;
+    reusedLayouts = result.reusedLayouts;
+    layoutResultID = result.correlationID;
+    updateWorkerPriority();
     observer->onTileChanged(*this);
 }
 
 void GeometryTile::onPlacement(PlacementResult result) {
+    if (result.correlationID < reusedPlacementID) {
+        return; // Requested before a retained placement was swapped in.
+    }
     if (result.correlationID == correlationID) {
         availableData = DataAvailability::All;
     }
-    for (auto& bucket : result.buckets) {
-        buckets[bucket.first] = std::move(bucket.second);
-    }
+    retainPlacement();
+    retainedPlacements.remove_if([&] (const auto& placement) {
+        return placement.config == result.placedConfig;
+    });
+
+    symbolBuckets = std::move(result.buckets);
     featureIndex->setCollisionTile(std::move(result.collisionTile));
     placedConfig = result.placedConfig;
     observer->onTileChanged(*this);
 }
 
+void GeometryTile::retainPlacement() {
+    std::unique_ptr<CollisionTile> collisionTile = featureIndex->takeCollisionTile();
+    if (!collisionTile || !placedConfig) {
+        return; // Nothing was placed since the last layout.
+    }
+
+    retainedPlacements.push_front({ *placedConfig, std::move(symbolBuckets), std::move(collisionTile) });
+    symbolBuckets.clear();
+
+    if (retainedPlacements.size() > maxRetainedPlacements) {
+        retainedPlacements.pop_back();
+    }
+}
+
 void GeometryTile::onError(std::exception_ptr err) {
     availableData = DataAvailability::All;
     observer->onTileError(*this, err);
 }
 
 Bucket* GeometryTile::getBucket(const Layer& layer) {
-    const auto it = buckets.find(layer.baseImpl->bucketName());
-    if (it == buckets.end()) {
+    const auto& bucketMap = layer.is<SymbolLayer>() ? symbolBuckets : buckets;
+    const auto it = bucketMap.find(layer.baseImpl->bucketName());
+    if (it == bucketMap.end()) {
         return nullptr;
     }
 
@@ -127,6 +228,34 @@ Bucket* GeometryTile::getBucket(const Layer& layer) {
     return it->second.get();
 }
 
+std::size_t GeometryTile::getByteSize() const {
+    std::size_t size = 0;
+    for (const auto& pair : buckets) {
+        size += pair.second->getByteSize();
+    }
+    for (const auto& pair : symbolBuckets) {
+        size += pair.second->getByteSize();
+    }
+    for (const auto& placement : retainedPlacements) {
+        for (const auto& pair : placement.buckets) {
+            size += pair.second->getByteSize();
+        }
+    }
+    if (featureIndex) {
+        size += featureIndex->getByteSize();
+    }
+    if (data) {
+        size += data->getByteSize();
+    }
+    return size;
+}
+
+void GeometryTile::dumpDebugLogs() const {
+    Tile::dumpDebugLogs();
+    Log::Info(Event::General, "GeometryTile::rebuiltLayouts: %s", util::toString(rebuiltLayouts).c_str());
+    Log::Info(Event::General, "GeometryTile::reusedLayouts: %s", util::toString(reusedLayouts).c_str());
+}
+
 void GeometryTile::queryRenderedFeatures(
     std::unordered_map<std::string, std::vector<Feature>>& result,
     const GeometryCoordinates& queryGeometry,
@@ -7,8 +7,10 @@
 #include <mbgl/actor/actor.hpp>
 
 #include <atomic>
+#include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace mbgl {
@@ -34,10 +36,12 @@ public:
     void setError(std::exception_ptr);
     void setData(std::unique_ptr<const GeometryTileData>);
 
+    void setPriority(Priority) override;
     void setPlacementConfig(const PlacementConfig&) override;
     void redoLayout() override;
 
     Bucket* getBucket(const style::Layer&) override;
+    std::size_t getByteSize() const override;
 
     void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -50,12 +54,27 @@ public:
     class LayoutResult {
     public:
         std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+        // Buckets of the previous layout result that are still valid.
+        std::unordered_set<std::string> reusedBuckets;
         std::unique_ptr<FeatureIndex> featureIndex;
         std::unique_ptr<GeometryTileData> tileData;
+        // Numbers of bucket groups that were laid out, and taken over from the previous layout.
+        std::size_t rebuiltLayouts;
+        std::size_t reusedLayouts;
         uint64_t correlationID;
     };
     void onLayout(LayoutResult);
 
+    // Numbers of bucket groups that the most recent layout laid out, and took over from the
+    // layout before.
+    std::size_t getRebuiltLayoutCount() const { return rebuiltLayouts; }
+    std::size_t getReusedLayoutCount() const { return reusedLayouts; }
+
+    // The config of the symbol placement the tile currently shows.
+    const optional<PlacementConfig>& getPlacedConfig() const { return placedConfig; }
+
+    void dumpDebugLogs() const override;
+
     class PlacementResult {
     public:
         std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
@@ -67,7 +86,13 @@ public:
 
     void onError(std::exception_ptr);
 
+    // The number of earlier placements of the current layout that a tile keeps for reuse.
+    static constexpr std::size_t maxRetainedPlacements = 4;
+
 private:
+    void updateWorkerPriority();
+    void retainPlacement();
+
     const std::string sourceID;
     style::Style& style;
 
@@ -80,9 +105,38 @@ private:
     uint64_t correlationID = 0;
     optional<PlacementConfig> placedConfig;
 
+    // The correlation ID at which a retained placement was last swapped in. Placement results
+    // with lower IDs are stale.
+    uint64_t reusedPlacementID = 0;
+
+    Priority priority = Priority::VisibleIdeal;
+
+    // Correlation IDs of the most recent layout request and the most recent layout result.
+    // When the latter has caught up, only placement work remains for this tile.
+    uint64_t layoutRequestID = 0;
+    uint64_t layoutResultID = 0;
+
+    std::size_t rebuiltLayouts = 0;
+    std::size_t reusedLayouts = 0;
+
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unique_ptr<const GeometryTileData> data;
+
+    // Symbol buckets of the placement for `placedConfig`; its collision tile is held by the
+    // feature index.
+    std::unordered_map<std::string, std::unique_ptr<Bucket>> symbolBuckets;
+
+    class Placement {
+    public:
+        PlacementConfig config;
+        std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+        std::unique_ptr<CollisionTile> collisionTile;
+    };
+
+    // Earlier placements of the current layout, most recently used first. When the map is
+    // rotated or tilted back to one of them, it is swapped in instead of placing symbols again.
+    std::list<Placement> retainedPlacements;
 };
 
 } // namespace mbgl
@@ -5,6 +5,8 @@
 
 namespace mbgl {
 
+constexpr uint32_t GeometryTileColumns::noValue;
+
 static double signedArea(const GeometryCoordinates& ring) {
     double sum = 0;
 
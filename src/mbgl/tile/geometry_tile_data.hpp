@@ -5,6 +5,7 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 #include <memory>
@@ -40,12 +41,28 @@ public:
     virtual GeometryCollection getGeometries() const = 0;
 };
 
+// Columnar access to the properties of every feature in a layer. A property key is resolved
+// to a key index once per layer; the column for a key holds, for each feature, an index into
+// the layer's table of distinct values, or `noValue` if the feature lacks that property.
+class GeometryTileColumns {
+public:
+    static constexpr uint32_t noValue = std::numeric_limits<uint32_t>::max();
+
+    virtual ~GeometryTileColumns() = default;
+    virtual optional<uint32_t> getKeyIndex(const std::string& key) const = 0;
+    virtual const std::vector<uint32_t>& getColumn(uint32_t keyIndex) const = 0;
+    virtual const std::vector<Value>& getValues() const = 0;
+};
+
 class GeometryTileLayer {
 public:
     virtual ~GeometryTileLayer() = default;
     virtual std::size_t featureCount() const = 0;
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
     virtual std::string getName() const = 0;
+
+    // Returns nullptr if the layer doesn't support columnar property access.
+    virtual const GeometryTileColumns* getColumns() const { return nullptr; }
 };
 
 class GeometryTileData {
@@ -53,6 +70,9 @@ public:
     virtual ~GeometryTileData() = default;
     virtual std::unique_ptr<GeometryTileData> clone() const = 0;
     virtual const GeometryTileLayer* getLayer(const std::string&) const = 0;
+
+    // Size of the encoded tile data owned by this object, if any, in bytes.
+    virtual std::size_t getByteSize() const { return 0; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
@@ -68,10 +68,17 @@ GeometryTileWorker::~GeometryTileWorker() {
    read all the queued messages until we get to "coalesced", and then redo either
    layout or placement if there were one or more "set"s (with layout taking priority,
    since it will trigger placement when complete), or return to the [idle] state if not.
+
+   "setPlacedConfig" only records the config that later layouts are placed for: the tile
+   already has that placement, so a pending placement is cancelled rather than started.
 */
 
 void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
     try {
+        // Layouts of the previous data can't be reused, and symbol layouts refer to it.
+        bucketLayouts.clear();
+        symbolLayouts.clear();
+
         data = std::move(data_);
         correlationID = correlationID_;
 
@@ -140,6 +147,23 @@ void GeometryTileWorker::setPlacementConfig(PlacementConfig placementConfig_, ui
     }
 }
 
+void GeometryTileWorker::setPlacedConfig(PlacementConfig placementConfig_, uint64_t correlationID_) {
+    placementConfig = std::move(placementConfig_);
+    correlationID = correlationID_;
+
+    switch (state) {
+    case Idle:
+    case Coalescing:
+    case NeedLayout:
+        break;
+
+    case NeedPlacement:
+        // The pending placement was for a config the tile no longer needs.
+        state = Coalescing;
+        break;
+    }
+}
+
 void GeometryTileWorker::coalesced() {
     try {
         switch (state) {
@@ -176,13 +200,22 @@ void GeometryTileWorker::redoLayout() {
         return;
     }
 
-    // We're doing a fresh parse of the tile, because the underlying data or style has changed.
+    // The underlying data or style has changed. Bucket groups whose layout is unaffected are
+    // taken over from the previous layout; all others are laid out again. If this layout is
+    // abandoned, the next one starts from scratch.
+    std::unordered_map<std::string, BucketLayout> previousLayouts = std::move(bucketLayouts);
+    bucketLayouts.clear();
     symbolLayouts.clear();
 
     // We're storing a set of bucket names we've parsed to avoid parsing a bucket twice that is
     // referenced from more than one layer
     std::unordered_set<std::string> parsed;
+    std::unordered_map<std::string, BucketLayout> layouts;
+    std::vector<SymbolLayout*> symbols;
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+    std::unordered_set<std::string> reusedBuckets;
+    std::size_t rebuilt = 0;
+    std::size_t reused = 0;
     auto featureIndex = std::make_unique<FeatureIndex>();
 
     for (auto i = layers->rbegin(); i != layers->rend(); i++) {
@@ -210,6 +243,25 @@ void GeometryTileWorker::redoLayout() {
             continue;
         }
 
+        auto previous = previousLayouts.find(bucketName);
+        if (previous != previousLayouts.end() &&
+            previous->second.layer->type == layer->type &&
+            layer->baseImpl->hasSameLayout(*previous->second.layer->baseImpl)) {
+            BucketLayout& layout = layouts.emplace(bucketName, std::move(previous->second)).first->second;
+
+            if (layout.symbolLayout) {
+                symbols.push_back(layout.symbolLayout.get());
+            } else {
+                featureIndex->insert(layout.subfeatures, layout.sourceLayerName, bucketName);
+                if (layout.hasBucket) {
+                    reusedBuckets.emplace(bucketName);
+                }
+            }
+
+            reused++;
+            continue;
+        }
+
         BucketParameters parameters(id,
                                     *geometryLayer,
                                     obsolete,
@@ -218,20 +270,39 @@ void GeometryTileWorker::redoLayout() {
                                     *featureIndex,
                                     mode);
 
+        BucketLayout layout;
+        layout.layer = layer->baseImpl->clone();
+
         if (layer->is<SymbolLayer>()) {
-            symbolLayouts.push_back(layer->as<SymbolLayer>()->impl->createLayout(parameters));
+            layout.symbolLayout = layer->as<SymbolLayer>()->impl->createLayout(parameters);
+            symbols.push_back(layout.symbolLayout.get());
         } else {
+            const std::size_t firstSubfeature = featureIndex->getSubfeatureCount();
             std::unique_ptr<Bucket> bucket = layer->baseImpl->createBucket(parameters);
+            layout.sourceLayerName = geometryLayer->getName();
+            layout.subfeatures = featureIndex->getSubfeatures(firstSubfeature);
             if (bucket->hasData()) {
-                buckets.emplace(layer->baseImpl->bucketName(), std::move(bucket));
+                layout.hasBucket = true;
+                buckets.emplace(bucketName, std::move(bucket));
             }
         }
+
+        layouts.emplace(bucketName, std::move(layout));
+        rebuilt++;
     }
 
+    bucketLayouts = std::move(layouts);
+    symbolLayouts = std::move(symbols);
+
+    featureIndex->build();
+
     parent.invoke(&GeometryTile::onLayout, GeometryTile::LayoutResult {
         std::move(buckets),
+        std::move(reusedBuckets),
         std::move(featureIndex),
         *data ? (*data)->clone() : nullptr,
+        rebuilt,
+        reused,
         correlationID
     });
 
@@ -246,7 +317,7 @@ void GeometryTileWorker::attemptPlacement() {
     bool canPlace = true;
 
     // Prepare as many SymbolLayouts as possible.
-    for (auto& symbolLayout : symbolLayouts) {
+    for (auto symbolLayout : symbolLayouts) {
         if (obsolete) {
             return;
         }
@@ -269,7 +340,7 @@ void GeometryTileWorker::attemptPlacement() {
     auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
 
-    for (auto& symbolLayout : symbolLayouts) {
+    for (auto symbolLayout : symbolLayouts) {
         if (obsolete) {
             return;
         }
@@ -2,13 +2,16 @@
 
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -34,6 +37,8 @@ public:
     void setLayers(std::vector<std::unique_ptr<style::Layer>>, uint64_t correlationID);
     void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
     void setPlacementConfig(PlacementConfig, uint64_t correlationID);
+    // The tile already holds a placement for this config; later layouts are placed for it.
+    void setPlacedConfig(PlacementConfig, uint64_t correlationID);
 
 private:
     void coalesce();
@@ -64,7 +69,29 @@ private:
     optional<std::unique_ptr<const GeometryTileData>> data;
     optional<PlacementConfig> placementConfig;
 
-    std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
+    // The result of laying out a group of layers that share a bucket. It stays valid for as
+    // long as the tile data is unchanged and the layers lay out their features the same way,
+    // so that style changes only redo layout for the bucket groups they affect.
+    class BucketLayout {
+    public:
+        // A copy of the layer that the bucket was laid out for.
+        std::unique_ptr<style::Layer> layer;
+
+        // Non-symbol layers: whether the tile holds a bucket for the group, and the features
+        // the bucket contributed to the feature index.
+        bool hasBucket = false;
+        std::string sourceLayerName;
+        FeatureIndex::Subfeatures subfeatures;
+
+        // Symbol layers: the layout, which is placed again whenever placement changes.
+        std::unique_ptr<SymbolLayout> symbolLayout;
+    };
+
+    // Bucket layouts of the most recent layout, by bucket name.
+    std::unordered_map<std::string, BucketLayout> bucketLayouts;
+
+    // Symbol layouts of the most recent layout, in placement order.
+    std::vector<SymbolLayout*> symbolLayouts;
 };
 
 } // namespace mbgl
@@ -14,12 +14,16 @@ namespace mbgl {
 
 RasterTile::RasterTile(const OverscaledTileID& id_,
                        const style::UpdateParameters& parameters,
-                       const Tileset& tileset)
+                       const Tileset& tileset,
+                       std::shared_ptr<util::ImagePool> pool,
+                       gl::TextureFormat opaqueFormat)
     : Tile(id_),
       loader(*this, id_, parameters, tileset),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
-             ActorRef<RasterTile>(*this, mailbox)) {
+             ActorRef<RasterTile>(*this, mailbox),
+             std::move(pool),
+             opaqueFormat) {
 }
 
 RasterTile::~RasterTile() = default;
@@ -39,7 +43,7 @@ void RasterTile::setData(std::shared_ptr<const std::string> data,
     worker.invoke(&RasterTileWorker::parse, data);
 }
 
-void RasterTile::onParsed(std::unique_ptr<Bucket> result) {
+void RasterTile::onParsed(std::unique_ptr<RasterBucket> result) {
     bucket = std::move(result);
     availableData = DataAvailability::All;
     observer->onTileChanged(*this);
@@ -55,8 +59,39 @@ Bucket* RasterTile::getBucket(const style::Layer&) {
     return bucket.get();
 }
 
+std::size_t RasterTile::getByteSize() const {
+    return bucket ? bucket->getByteSize() : 0;
+}
+
+std::size_t RasterTile::getImageByteSize() const {
+    return bucket ? bucket->getImageByteSize() : 0;
+}
+
+std::size_t RasterTile::getTextureByteSize() const {
+    return bucket ? bucket->getTextureByteSize() : 0;
+}
+
 void RasterTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setPriority(Priority priority) {
+    loader.setPriority(priority);
+
+    switch (priority) {
+    case Priority::VisibleIdeal:
+        worker.setPriority(MailboxPriority::Highest);
+        break;
+    case Priority::VisibleFallback:
+        worker.setPriority(MailboxPriority::High);
+        break;
+    case Priority::PlacementOnly:
+        worker.setPriority(MailboxPriority::Low);
+        break;
+    case Priority::Prefetch:
+        worker.setPriority(MailboxPriority::Lowest);
+        break;
+    }
+}
+
 } // namespace mbgl
@@ -8,6 +8,11 @@
 namespace mbgl {
 
 class Tileset;
+class RasterBucket;
+
+namespace util {
+class ImagePool;
+} // namespace util
 
 namespace style {
 class Layer;
@@ -16,12 +21,16 @@ class UpdateParameters;
 
 class RasterTile : public Tile {
 public:
+    // Decodes into images from the pool, if any, and uploads opaque tiles in the given format.
     RasterTile(const OverscaledTileID&,
                    const style::UpdateParameters&,
-                   const Tileset&);
+                   const Tileset&,
+                   std::shared_ptr<util::ImagePool> = nullptr,
+                   gl::TextureFormat opaqueFormat = gl::TextureFormat::RGBA);
     ~RasterTile() final;
 
     void setNecessity(Necessity) final;
+    void setPriority(Priority) final;
 
     void setError(std::exception_ptr);
     void setData(std::shared_ptr<const std::string> data,
@@ -30,8 +39,13 @@ public:
 
     void cancel() override;
     Bucket* getBucket(const style::Layer&) override;
+    std::size_t getByteSize() const override;
+
+    // See RasterBucket.
+    std::size_t getImageByteSize() const;
+    std::size_t getTextureByteSize() const;
 
-    void onParsed(std::unique_ptr<Bucket> result);
+    void onParsed(std::unique_ptr<RasterBucket> result);
     void onError(std::exception_ptr);
 
 private:
@@ -42,7 +56,7 @@ private:
 
     // Contains the Bucket object for the tile. Buckets are render
     // objects and they get added by tile parsing operations.
-    std::unique_ptr<Bucket> bucket;
+    std::unique_ptr<RasterBucket> bucket;
 };
 
 } // namespace mbgl
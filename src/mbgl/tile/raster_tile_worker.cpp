@@ -2,11 +2,17 @@
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/renderer/raster_bucket.cpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/util/image_pool.hpp>
 
 namespace mbgl {
 
-RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_)
-    : parent(std::move(parent_)) {
+RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>,
+                                   ActorRef<RasterTile> parent_,
+                                   std::shared_ptr<util::ImagePool> pool_,
+                                   gl::TextureFormat opaqueFormat_)
+    : parent(std::move(parent_)),
+      pool(std::move(pool_)),
+      opaqueFormat(opaqueFormat_) {
 }
 
 void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
@@ -16,7 +22,9 @@ void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data));
+        auto bucket = pool
+            ? std::make_unique<RasterBucket>(decodeImage(*data, *pool), pool, opaqueFormat)
+            : std::make_unique<RasterBucket>(decodeImage(*data), nullptr, opaqueFormat);
         parent.invoke(&RasterTile::onParsed, std::move(bucket));
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/gl/types.hpp>
 
 #include <memory>
 #include <string>
@@ -9,14 +10,23 @@ namespace mbgl {
 
 class RasterTile;
 
+namespace util {
+class ImagePool;
+} // namespace util
+
 class RasterTileWorker {
 public:
-    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
+    RasterTileWorker(ActorRef<RasterTileWorker>,
+                     ActorRef<RasterTile>,
+                     std::shared_ptr<util::ImagePool>,
+                     gl::TextureFormat opaqueFormat);
 
     void parse(std::shared_ptr<const std::string> data);
 
 private:
     ActorRef<RasterTile> parent;
+    std::shared_ptr<util::ImagePool> pool;
+    const gl::TextureFormat opaqueFormat;
 };
 
 } // namespace mbgl
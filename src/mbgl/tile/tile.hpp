@@ -41,6 +41,22 @@ public:
 
     virtual void setNecessity(Necessity) = 0;
 
+    // Relative urgency of the work for this tile, from most to least urgent. Tiles pass this
+    // on to their worker's mailbox so that work for the current viewport is done first:
+    // - visible ideal: an ideal tile for the current viewport
+    // - visible fallback: a parent or child tile retained to stand in for an ideal tile
+    // - placement only: a renderable tile, other than a prefetched one, whose only pending
+    //   work is symbol placement, which rotating or tilting the map needs redone
+    // - prefetch: a cached tile that isn't needed for rendering at the moment
+    enum class Priority : uint8_t {
+        VisibleIdeal,
+        VisibleFallback,
+        PlacementOnly,
+        Prefetch,
+    };
+
+    virtual void setPriority(Priority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel() = 0;
 
@@ -49,6 +65,10 @@ public:
     virtual void setPlacementConfig(const PlacementConfig&) {}
     virtual void redoLayout() {}
 
+    // Approximate memory held by the tile's buckets, feature index, and raw data, in bytes.
+    // Used to keep the tile cache within its memory budget.
+    virtual std::size_t getByteSize() const { return 0; }
+
     virtual void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
@@ -77,7 +97,7 @@ public:
         return availableData == DataAvailability::Some;
     }
 
-    void dumpDebugLogs() const;
+    virtual void dumpDebugLogs() const;
 
     const OverscaledTileID id;
     optional<Timestamp> modified;
@@ -5,62 +5,145 @@
 
 namespace mbgl {
 
-void TileCache::setSize(size_t size_) {
-    size = size_;
+void TileCache::setMaxBytes(std::size_t maxBytes_) {
+    maxBytes = maxBytes_;
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
+    while (maxBytes && bytes > maxBytes) {
+        remove(entries.begin());
     }
+}
+
+void TileCache::setSize(const std::string& sourceID, std::size_t size) {
+    auto it = sources.find(sourceID);
+    if (it == sources.end()) {
+        if (size) {
+            sources[sourceID].size = size;
+        }
+        return;
+    }
+
+    SourceCache& source = it->second;
+    source.size = size;
+    evict(source);
 
-    assert(orderedKeys.size() <= size);
+    if (!size) {
+        assert(source.entries.empty());
+        sources.erase(it);
+    }
+}
+
+std::size_t TileCache::getSize(const std::string& sourceID) const {
+    auto it = sources.find(sourceID);
+    return it == sources.end() ? 0 : it->second.size;
 }
 
-void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
-    if (!tile->isRenderable() || !size) {
+void TileCache::add(const std::string& sourceID, const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
+    if (!tile->isRenderable()) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    auto it = sources.find(sourceID);
+    if (it == sources.end()) {
+        return;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    SourceCache& source = it->second;
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
+    // replace existing tile
+    auto existing = source.entries.find(key);
+    if (existing != source.entries.end()) {
+        remove(existing->second);
     }
 
-    assert(orderedKeys.size() <= size);
-}
+    // insert tile as newest
+    const std::size_t tileBytes = tile->getByteSize();
+    auto entry = entries.insert(entries.end(), Entry { &source, key, std::move(tile), tileBytes, {} });
+    entry->position = source.order.insert(source.order.end(), entry);
+    source.entries.emplace(key, entry);
+    source.bytes += tileBytes;
+    bytes += tileBytes;
 
-std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
+    // purge oldest tiles if necessary
+    evict(source);
+}
 
-    std::unique_ptr<Tile> tile;
+std::unique_ptr<Tile> TileCache::get(const std::string& sourceID, const OverscaledTileID& key) {
+    auto it = sources.find(sourceID);
+    if (it == sources.end()) {
+        return nullptr;
+    }
 
-    auto it = tiles.find(key);
-    if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
-        assert(tile->isRenderable());
+    auto entry = it->second.entries.find(key);
+    if (entry == it->second.entries.end()) {
+        return nullptr;
     }
 
+    std::unique_ptr<Tile> tile = remove(entry->second);
+    assert(tile->isRenderable());
     return tile;
 }
 
-bool TileCache::has(const OverscaledTileID& key) {
-    return tiles.find(key) != tiles.end();
+bool TileCache::has(const std::string& sourceID, const OverscaledTileID& key) const {
+    auto it = sources.find(sourceID);
+    return it != sources.end() && it->second.entries.find(key) != it->second.entries.end();
+}
+
+void TileCache::clear(const std::string& sourceID) {
+    auto it = sources.find(sourceID);
+    if (it == sources.end()) {
+        return;
+    }
+
+    SourceCache& source = it->second;
+    while (!source.order.empty()) {
+        remove(source.order.front());
+    }
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    entries.clear();
+    bytes = 0;
+
+    for (auto& pair : sources) {
+        pair.second.entries.clear();
+        pair.second.order.clear();
+        pair.second.bytes = 0;
+    }
+}
+
+std::size_t TileCache::getBytes(const std::string& sourceID) const {
+    auto it = sources.find(sourceID);
+    return it == sources.end() ? 0 : it->second.bytes;
+}
+
+std::unordered_map<std::string, std::size_t> TileCache::getBytesPerSource() const {
+    std::unordered_map<std::string, std::size_t> result;
+    for (const auto& pair : sources) {
+        result.emplace(pair.first, pair.second.bytes);
+    }
+    return result;
+}
+
+std::unique_ptr<Tile> TileCache::remove(Entries::iterator entry) {
+    SourceCache& source = *entry->source;
+    source.order.erase(entry->position);
+    source.entries.erase(entry->key);
+    source.bytes -= entry->bytes;
+    bytes -= entry->bytes;
+
+    std::unique_ptr<Tile> tile = std::move(entry->tile);
+    entries.erase(entry);
+    return tile;
+}
+
+void TileCache::evict(SourceCache& source) {
+    while (source.order.size() > source.size) {
+        remove(source.order.front());
+    }
+
+    while (maxBytes && bytes > maxBytes) {
+        remove(entries.begin());
+    }
 }
 
 } // namespace mbgl
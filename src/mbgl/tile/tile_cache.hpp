@@ -4,28 +4,76 @@
 
 #include <list>
 #include <memory>
-#include <map>
+#include <string>
+#include <unordered_map>
 
 namespace mbgl {
 
 class Tile;
 
+/*
+   Keeps recently used tiles of all sources of a style around for reuse, in a single
+   least-recently-used order.
+
+   Two limits apply: each source may cache at most a given number of tiles, and the tiles
+   of all sources together may hold at most a given number of bytes, as reported by
+   `Tile::getByteSize` when the tile is added. When adding a tile exceeds a source's tile
+   limit, that source's least recently used tile is evicted; when it exceeds the memory
+   budget, the least recently used tiles of any source are evicted.
+*/
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    // A `maxBytes` of 0 means that the cache isn't limited by memory.
+    TileCache(std::size_t maxBytes_ = 0) : maxBytes(maxBytes_) {}
+
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const { return maxBytes; }
+
+    // A size of 0 disables caching of the source's tiles and evicts those already cached.
+    void setSize(const std::string& sourceID, std::size_t);
+    std::size_t getSize(const std::string& sourceID) const;
 
-    void setSize(size_t);
-    size_t getSize() const { return size; };
-    void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
-    std::unique_ptr<Tile> get(const OverscaledTileID& key);
-    bool has(const OverscaledTileID& key);
+    void add(const std::string& sourceID, const OverscaledTileID& key, std::unique_ptr<Tile> data);
+    std::unique_ptr<Tile> get(const std::string& sourceID, const OverscaledTileID& key);
+    bool has(const std::string& sourceID, const OverscaledTileID& key) const;
+
+    // Removes the tiles of one source, or of all sources.
+    void clear(const std::string& sourceID);
     void clear();
 
+    // Memory held by the cached tiles of one source, or of all sources.
+    std::size_t getBytes(const std::string& sourceID) const;
+    std::size_t getBytes() const { return bytes; }
+
+    std::unordered_map<std::string, std::size_t> getBytesPerSource() const;
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    struct Entry;
+    using Entries = std::list<Entry>;
+
+    struct SourceCache {
+        std::size_t size = 0;
+        std::size_t bytes = 0;
+        std::unordered_map<OverscaledTileID, Entries::iterator> entries;
+        std::list<Entries::iterator> order; // Least recently used first.
+    };
+
+    struct Entry {
+        SourceCache* source;
+        OverscaledTileID key;
+        std::unique_ptr<Tile> tile;
+        std::size_t bytes;
+        std::list<Entries::iterator>::iterator position;
+    };
+
+    std::unique_ptr<Tile> remove(Entries::iterator);
+    void evict(SourceCache&);
+
+    Entries entries; // Least recently used first, across all sources.
+    std::unordered_map<std::string, SourceCache> sources;
 
-    size_t size;
+    std::size_t maxBytes;
+    std::size_t bytes = 0;
 };
 
 } // namespace mbgl
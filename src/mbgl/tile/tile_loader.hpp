@@ -37,6 +37,10 @@ public:
         }
     }
 
+    // Requests the tile with a priority that matches how much it is needed, and changes the
+    // priority of a request in progress.
+    void setPriority(Tile::Priority);
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
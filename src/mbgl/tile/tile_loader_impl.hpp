@@ -87,6 +87,30 @@ void TileLoader<T>::makeOptional() {
     }
 }
 
+template <typename T>
+void TileLoader<T>::setPriority(Tile::Priority priority) {
+    Resource::Priority resourcePriority = Resource::Priority::Regular;
+    switch (priority) {
+    case Tile::Priority::VisibleIdeal:
+        resourcePriority = Resource::Priority::Regular;
+        break;
+    case Tile::Priority::VisibleFallback:
+    case Tile::Priority::PlacementOnly:
+        resourcePriority = Resource::Priority::Fallback;
+        break;
+    case Tile::Priority::Prefetch:
+        resourcePriority = Resource::Priority::Prefetch;
+        break;
+    }
+
+    if (resourcePriority != resource.priority) {
+        resource.priority = resourcePriority;
+        if (request) {
+            fileSource.setPriority(*request, resourcePriority);
+        }
+    }
+}
+
 template <typename T>
 void TileLoader<T>::loadedData(const Response& res) {
     if (res.error && res.error->reason != Response::Error::Reason::NotFound) {
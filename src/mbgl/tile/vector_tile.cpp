@@ -1,75 +1,11 @@
 #include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
-#include <mbgl/tile/geometry_tile_data.hpp>
 
-#include <protozero/pbf_reader.hpp>
-
-#include <unordered_map>
-#include <unordered_map>
-#include <functional>
 #include <utility>
 
 namespace mbgl {
 
-class VectorTileLayer;
-
-using packed_iter_type = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
-
-class VectorTileFeature : public GeometryTileFeature {
-public:
-    VectorTileFeature(protozero::pbf_reader, const VectorTileLayer&);
-
-    FeatureType getType() const override { return type; }
-    optional<Value> getValue(const std::string&) const override;
-    std::unordered_map<std::string,Value> getProperties() const override;
-    optional<FeatureIdentifier> getID() const override;
-    GeometryCollection getGeometries() const override;
-
-private:
-    const VectorTileLayer& layer;
-    optional<FeatureIdentifier> id;
-    FeatureType type = FeatureType::Unknown;
-    packed_iter_type tags_iter;
-    packed_iter_type geometry_iter;
-};
-
-class VectorTileLayer : public GeometryTileLayer {
-public:
-    VectorTileLayer(protozero::pbf_reader);
-
-    std::size_t featureCount() const override { return features.size(); }
-    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
-    std::string getName() const override;
-
-private:
-    friend class VectorTileData;
-    friend class VectorTileFeature;
-
-    std::string name;
-    uint32_t version = 1;
-    uint32_t extent = 4096;
-    std::unordered_map<std::string, uint32_t> keysMap;
-    std::vector<std::reference_wrapper<const std::string>> keys;
-    std::vector<Value> values;
-    std::vector<protozero::pbf_reader> features;
-};
-
-class VectorTileData : public GeometryTileData {
-public:
-    VectorTileData(std::shared_ptr<const std::string> data);
-
-    std::unique_ptr<GeometryTileData> clone() const override {
-        return std::make_unique<VectorTileData>(*this);
-    }
-
-    const GeometryTileLayer* getLayer(const std::string&) const override;
-
-private:
-    std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
-    mutable std::unordered_map<std::string, VectorTileLayer> layers;
-};
-
 VectorTile::VectorTile(const OverscaledTileID& id_,
                        std::string sourceID_,
                        const style::UpdateParameters& parameters,
@@ -82,6 +18,11 @@ void VectorTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void VectorTile::setPriority(Priority priority) {
+    GeometryTile::setPriority(priority);
+    loader.setPriority(priority);
+}
+
 void VectorTile::setData(std::shared_ptr<const std::string> data_,
                          optional<Timestamp> modified_,
                          optional<Timestamp> expires_) {
@@ -151,7 +92,7 @@ optional<Value> VectorTileFeature::getValue(const std::string& key) const {
     while (start_itr != end_itr) {
         uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
 
-        if (layer.keysMap.size() <= tag_key) {
+        if (layer.keys.size() <= tag_key) {
             throw std::runtime_error("feature referenced out of range key");
         }
 
@@ -272,10 +213,8 @@ VectorTileLayer::VectorTileLayer(protozero::pbf_reader layer_pbf) {
             features.push_back(layer_pbf.get_message());
             break;
         case 3: // keys
-            {
-                auto iter = keysMap.emplace(layer_pbf.get_string(), keysMap.size());
-                keys.emplace_back(std::reference_wrapper<const std::string>(iter.first->first));
-            }
+            keys.push_back(layer_pbf.get_string());
+            keysMap.emplace(keys.back(), keys.size() - 1);
             break;
         case 4: // values
             values.emplace_back(parseValue(layer_pbf.get_message()));
@@ -301,4 +240,65 @@ std::string VectorTileLayer::getName() const {
     return name;
 }
 
+optional<uint32_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    auto it = keysMap.find(key);
+    if (it == keysMap.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+const std::vector<uint32_t>& VectorTileLayer::getColumn(uint32_t keyIndex) const {
+    decodeTags();
+
+    std::vector<uint32_t>& column = columns.at(keyIndex);
+    if (column.size() != features.size()) {
+        column.assign(features.size(), noValue);
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            for (uint32_t t = tagOffsets[i]; t < tagOffsets[i + 1]; ++t) {
+                if (tags[t].first == keyIndex) {
+                    column[i] = tags[t].second;
+                    break;
+                }
+            }
+        }
+    }
+
+    return column;
+}
+
+void VectorTileLayer::decodeTags() const {
+    if (tagsDecoded) {
+        return;
+    }
+    tagsDecoded = true;
+
+    tagOffsets.reserve(features.size() + 1);
+    tagOffsets.push_back(0);
+    columns.resize(keys.size());
+
+    for (auto feature_pbf : features) {
+        while (feature_pbf.next(2)) { // tags
+            auto tags_iter = feature_pbf.get_packed_uint32();
+            auto start_itr = tags_iter.begin();
+            const auto& end_itr = tags_iter.end();
+            while (start_itr != end_itr) {
+                uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+                if (keys.size() <= tag_key) {
+                    throw std::runtime_error("feature referenced out of range key");
+                }
+                if (start_itr == end_itr) {
+                    throw std::runtime_error("uneven number of feature tag ids");
+                }
+                uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+                if (values.size() <= tag_val) {
+                    throw std::runtime_error("feature referenced out of range value");
+                }
+                tags.emplace_back(tag_key, tag_val);
+            }
+        }
+        tagOffsets.push_back(static_cast<uint32_t>(tags.size()));
+    }
+}
+
 } // namespace mbgl
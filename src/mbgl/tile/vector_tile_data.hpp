@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+class VectorTileLayer;
+
+using packed_iter_type = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+class VectorTileFeature : public GeometryTileFeature {
+public:
+    VectorTileFeature(protozero::pbf_reader, const VectorTileLayer&);
+
+    FeatureType getType() const override { return type; }
+    optional<Value> getValue(const std::string&) const override;
+    std::unordered_map<std::string,Value> getProperties() const override;
+    optional<FeatureIdentifier> getID() const override;
+    GeometryCollection getGeometries() const override;
+
+private:
+    const VectorTileLayer& layer;
+    optional<FeatureIdentifier> id;
+    FeatureType type = FeatureType::Unknown;
+    packed_iter_type tags_iter;
+    packed_iter_type geometry_iter;
+};
+
+class VectorTileLayer : public GeometryTileLayer, public GeometryTileColumns {
+public:
+    VectorTileLayer(protozero::pbf_reader);
+
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
+    std::string getName() const override;
+    const GeometryTileColumns* getColumns() const override { return this; }
+
+    optional<uint32_t> getKeyIndex(const std::string&) const override;
+    const std::vector<uint32_t>& getColumn(uint32_t keyIndex) const override;
+    const std::vector<Value>& getValues() const override { return values; }
+
+private:
+    friend class VectorTileData;
+    friend class VectorTileFeature;
+
+    void decodeTags() const;
+
+    std::string name;
+    uint32_t version = 1;
+    uint32_t extent = 4096;
+    std::unordered_map<std::string, uint32_t> keysMap;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    std::vector<protozero::pbf_reader> features;
+
+    // The tags of all features, decoded on first use of a column. The (key, value) index
+    // pairs of feature i are tags[tagOffsets[i]] up to tags[tagOffsets[i + 1]].
+    mutable bool tagsDecoded = false;
+    mutable std::vector<uint32_t> tagOffsets;
+    mutable std::vector<std::pair<uint32_t, uint32_t>> tags;
+
+    // One column per key, built on demand; empty until then.
+    mutable std::vector<std::vector<uint32_t>> columns;
+};
+
+class VectorTileData : public GeometryTileData {
+public:
+    VectorTileData(std::shared_ptr<const std::string> data);
+
+    std::unique_ptr<GeometryTileData> clone() const override {
+        return std::make_unique<VectorTileData>(*this);
+    }
+
+    const GeometryTileLayer* getLayer(const std::string&) const override;
+    std::size_t getByteSize() const override { return data ? data->size() : 0; }
+
+private:
+    std::shared_ptr<const std::string> data;
+    mutable bool parsed = false;
+    mutable std::unordered_map<std::string, VectorTileLayer> layers;
+};
+
+} // namespace mbgl
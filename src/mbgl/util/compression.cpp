@@ -1,7 +1,13 @@
 #include <mbgl/util/compression.hpp>
+#include <mbgl/util/thread_local.hpp>
 
 #include <zlib.h>
 
+#if MBGL_USE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -22,15 +28,56 @@ const static bool zlibVersionCheck __attribute__((unused)) = []() {
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string &raw) {
-    z_stream deflate_stream;
-    memset(&deflate_stream, 0, sizeof(deflate_stream));
+namespace {
+
+// Returns this thread's instance of T, creating it on first use. Instances are destroyed
+// when their thread exits.
+template <class T>
+T& threadContext() {
+    static ThreadLocal<T>& context = *new ThreadLocal<T>;
+    if (!context.get()) {
+        context.set(new T);
+    }
+    return *context.get();
+}
+
+class Deflater {
+public:
+    Deflater() {
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            throw std::runtime_error("failed to initialize deflate");
+        }
+    }
+
+    ~Deflater() {
+        deflateEnd(&stream);
+    }
+
+    z_stream stream;
+};
 
-    // TODO: reuse z_streams
-    if (deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("failed to initialize deflate");
+class Inflater {
+public:
+    Inflater() {
+        memset(&stream, 0, sizeof(stream));
+        // Accepts gzip as well as zlib headers.
+        if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
+        }
+    }
+
+    ~Inflater() {
+        inflateEnd(&stream);
     }
 
+    z_stream stream;
+};
+
+std::string zlibCompress(const std::string& raw) {
+    z_stream& deflate_stream = threadContext<Deflater>().stream;
+    deflateReset(&deflate_stream);
+
     deflate_stream.next_in = (Bytef *)raw.data();
     deflate_stream.avail_in = uInt(raw.size());
 
@@ -48,23 +95,16 @@ std::string compress(const std::string &raw) {
         }
     } while (code == Z_OK);
 
-    deflateEnd(&deflate_stream);
-
     if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+        throw std::runtime_error(deflate_stream.msg ? deflate_stream.msg : "compression error");
     }
 
     return result;
 }
 
-std::string decompress(const std::string &raw) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
-
-    // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
-        throw std::runtime_error("failed to initialize inflate");
-    }
+std::string zlibDecompress(const std::string& raw) {
+    z_stream& inflate_stream = threadContext<Inflater>().stream;
+    inflateReset(&inflate_stream);
 
     inflate_stream.next_in = (Bytef *)raw.data();
     inflate_stream.avail_in = uInt(raw.size());
@@ -77,19 +117,207 @@ std::string decompress(const std::string &raw) {
         inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
         inflate_stream.avail_out = sizeof(out);
         code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
         if (result.size() < inflate_stream.total_out) {
             result.append(out, inflate_stream.total_out - result.size());
         }
     } while (code == Z_OK);
 
-    inflateEnd(&inflate_stream);
-
     if (code != Z_STREAM_END) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
     return result;
 }
+
+#if MBGL_USE_ZSTD
+
+// zstd's own default; higher levels cost a lot more time for little gain on tiles.
+constexpr int zstdLevel = 3;
+
+class ZstdCompressor {
+public:
+    ZstdCompressor() : context(ZSTD_createCCtx()) {
+        if (!context) {
+            throw std::runtime_error("failed to initialize zstd compression");
+        }
+    }
+
+    ~ZstdCompressor() {
+        ZSTD_freeCCtx(context);
+    }
+
+    ZSTD_CCtx* context;
+};
+
+class ZstdDecompressor {
+public:
+    ZstdDecompressor() : context(ZSTD_createDCtx()) {
+        if (!context) {
+            throw std::runtime_error("failed to initialize zstd decompression");
+        }
+    }
+
+    ~ZstdDecompressor() {
+        ZSTD_freeDCtx(context);
+    }
+
+    ZSTD_DCtx* context;
+};
+
+void checkZstd(std::size_t code) {
+    if (ZSTD_isError(code)) {
+        throw std::runtime_error(ZSTD_getErrorName(code));
+    }
+}
+
+#endif // MBGL_USE_ZSTD
+
+} // namespace
+
+// Holds the dictionary digested for compression and for decompression, which is much
+// more expensive than a single use of either.
+class CompressionDictionary::Impl {
+public:
+#if MBGL_USE_ZSTD
+    Impl(const std::string& data)
+        : compression(ZSTD_createCDict(data.data(), data.size(), zstdLevel)),
+          decompression(ZSTD_createDDict(data.data(), data.size())) {
+        if (!compression || !decompression) {
+            throw std::runtime_error("failed to load zstd dictionary");
+        }
+    }
+
+    ~Impl() {
+        ZSTD_freeCDict(compression);
+        ZSTD_freeDDict(decompression);
+    }
+
+    ZSTD_CDict* compression;
+    ZSTD_DDict* decompression;
+#else
+    Impl(const std::string&) {}
+#endif
+};
+
+CompressionDictionary::CompressionDictionary(std::string data_)
+    : data(std::move(data_)),
+      impl(std::make_unique<Impl>(data)) {
+}
+
+CompressionDictionary::~CompressionDictionary() = default;
+
+std::string CompressionDictionary::train(const std::vector<std::string>& samples, std::size_t maxSize) {
+#if MBGL_USE_ZSTD
+    std::string buffer;
+    std::vector<std::size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer += sample;
+        sizes.push_back(sample.size());
+    }
+
+    std::string result(maxSize, '\0');
+    const std::size_t size = ZDICT_trainFromBuffer(&result[0], result.size(),
+        buffer.data(), sizes.data(), unsigned(sizes.size()));
+    if (ZDICT_isError(size)) {
+        return {};
+    }
+
+    result.resize(size);
+    return result;
+#else
+    (void)samples;
+    (void)maxSize;
+    return {};
+#endif
+}
+
+bool isSupported(Codec codec) {
+    switch (codec) {
+    case Codec::None:
+    case Codec::Zlib:
+        return true;
+    case Codec::Zstd:
+#if MBGL_USE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::string compress(const std::string& raw) {
+    return zlibCompress(raw);
+}
+
+std::string decompress(const std::string& raw) {
+    return zlibDecompress(raw);
+}
+
+std::string compress(const std::string& raw, Codec codec, const CompressionDictionary* dictionary) {
+    switch (codec) {
+    case Codec::None:
+        return raw;
+
+    case Codec::Zlib:
+        return zlibCompress(raw);
+
+    case Codec::Zstd: {
+#if MBGL_USE_ZSTD
+        ZSTD_CCtx* context = threadContext<ZstdCompressor>().context;
+        std::string result(ZSTD_compressBound(raw.size()), '\0');
+        const std::size_t size = dictionary
+            ? ZSTD_compress_usingCDict(context, &result[0], result.size(), raw.data(), raw.size(),
+                                       dictionary->impl->compression)
+            : ZSTD_compressCCtx(context, &result[0], result.size(), raw.data(), raw.size(), zstdLevel);
+        checkZstd(size);
+        result.resize(size);
+        return result;
+#else
+        (void)dictionary;
+        break;
+#endif
+    }
+    }
+
+    throw std::runtime_error("unsupported compression codec");
+}
+
+std::string decompress(const std::string& raw, Codec codec, const CompressionDictionary* dictionary) {
+    switch (codec) {
+    case Codec::None:
+        return raw;
+
+    case Codec::Zlib:
+        return zlibDecompress(raw);
+
+    case Codec::Zstd: {
+#if MBGL_USE_ZSTD
+        // Single-pass compression always records the content size in the frame.
+        const unsigned long long contentSize = ZSTD_getFrameContentSize(raw.data(), raw.size());
+        if (contentSize == ZSTD_CONTENTSIZE_ERROR || contentSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+            throw std::runtime_error("decompression error");
+        }
+
+        ZSTD_DCtx* context = threadContext<ZstdDecompressor>().context;
+        std::string result(contentSize, '\0');
+        const std::size_t size = dictionary
+            ? ZSTD_decompress_usingDDict(context, &result[0], result.size(), raw.data(), raw.size(),
+                                         dictionary->impl->decompression)
+            : ZSTD_decompressDCtx(context, &result[0], result.size(), raw.data(), raw.size());
+        checkZstd(size);
+        result.resize(size);
+        return result;
+#else
+        (void)dictionary;
+        break;
+#endif
+    }
+    }
+
+    throw std::runtime_error("unsupported compression codec");
+}
+
 } // namespace util
 } // namespace mbgl
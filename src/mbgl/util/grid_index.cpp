@@ -2,7 +2,7 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <cmath>
 
 namespace mbgl {
 
@@ -17,61 +17,51 @@ GridIndex<T>::GridIndex(int32_t extent_, int32_t n_, int32_t padding_) :
     min(-double(padding) / n * extent),
     max(extent + double(padding) / n * extent)
     {
-        cells.resize(d * d);
     }
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = elements.size();
+    elements.emplace_back(std::move(t), bbox);
+    built = false;
+}
+
+template <class T>
+void GridIndex<T>::build() {
+    // Count the elements of each cell, then place them in order of insertion.
+    cellOffsets.assign(d * d + 1, 0);
+    for (const auto& element : elements) {
+        const BBox& bbox = element.second;
+        for (int32_t y = convertToCellCoord(bbox.min.y); y <= convertToCellCoord(bbox.max.y); ++y) {
+            for (int32_t x = convertToCellCoord(bbox.min.x); x <= convertToCellCoord(bbox.max.x); ++x) {
+                cellOffsets[d * y + x + 1]++;
+            }
+        }
+    }
 
-    auto cx1 = convertToCellCoord(bbox.min.x);
-    auto cy1 = convertToCellCoord(bbox.min.y);
-    auto cx2 = convertToCellCoord(bbox.max.x);
-    auto cy2 = convertToCellCoord(bbox.max.y);
+    for (std::size_t i = 1; i < cellOffsets.size(); ++i) {
+        cellOffsets[i] += cellOffsets[i - 1];
+    }
 
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            cells[cellIndex].push_back(uid);
+    std::vector<uint32_t> positions(cellOffsets.begin(), cellOffsets.end() - 1);
+    cellElements.resize(cellOffsets.back());
+    for (std::size_t uid = 0; uid < elements.size(); ++uid) {
+        const BBox& bbox = elements[uid].second;
+        for (int32_t y = convertToCellCoord(bbox.min.y); y <= convertToCellCoord(bbox.max.y); ++y) {
+            for (int32_t x = convertToCellCoord(bbox.min.x); x <= convertToCellCoord(bbox.max.x); ++x) {
+                cellElements[positions[d * y + x]++] = uid;
+            }
         }
     }
 
-    elements.emplace_back(t, bbox);
+    built = true;
 }
 
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
-
-    auto cx1 = convertToCellCoord(queryBBox.min.x);
-    auto cy1 = convertToCellCoord(queryBBox.min.y);
-    auto cx2 = convertToCellCoord(queryBBox.max.x);
-    auto cy2 = convertToCellCoord(queryBBox.max.y);
-
-    int32_t x, y, cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = d * y + x;
-            for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
-
-                    auto& pair = elements.at(uid);
-                    auto& bbox = pair.second;
-                    if (queryBBox.min.x <= bbox.max.x &&
-                        queryBBox.min.y <= bbox.max.y &&
-                        queryBBox.max.x >= bbox.min.x &&
-                        queryBBox.max.y >= bbox.min.y) {
-
-                        result.push_back(pair.first);
-                    }
-                }
-            }
-        }
-    }
-
+    query(queryBBox, [&] (std::size_t uid) {
+        result.push_back(elements[uid].first);
+    });
     return result;
 }
 
@@ -81,5 +71,12 @@ int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
 }
 
-template class GridIndex<IndexedSubfeature>;
+template <class T>
+std::size_t GridIndex<T>::getByteSize() const {
+    return elements.size() * sizeof(typename decltype(elements)::value_type) +
+           cellOffsets.size() * sizeof(uint32_t) +
+           cellElements.size() * sizeof(uint32_t);
+}
+
+template class GridIndex<InternedSubfeature>;
 } // namespace mbgl
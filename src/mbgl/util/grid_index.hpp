@@ -3,12 +3,21 @@
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
 
 namespace mbgl {
 
+/*
+   A uniform grid of elements with bounding boxes.
+
+   The elements overlapping each cell are stored contiguously: `cellOffsets[i]` is the
+   position in `cellElements` of the first element of cell `i`, and `cellOffsets[i + 1]`
+   the position past its last one. This layout is built by `build()`, once all elements have
+   been inserted; queries before that, or after further inserts, test every element.
+*/
 template <class T>
 class GridIndex {
 public:
@@ -17,11 +26,33 @@ public:
     using BBox = mapbox::geometry::box<int16_t>;
 
     void insert(T&& t, const BBox&);
+    void build();
+
+    // Calls `fn` with the position in `getElements()` of each element whose bounding box
+    // intersects the given one, once per element, without allocating.
+    template <class Fn>
+    void query(const BBox&, Fn&& fn) const;
+
     std::vector<T> query(const BBox&) const;
 
+    // Elements with their bounding boxes, in insertion order.
+    const std::vector<std::pair<T, BBox>>& getElements() const {
+        return elements;
+    }
+
+    // Approximate memory held by the index, excluding heap memory owned by the elements.
+    std::size_t getByteSize() const;
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
 
+    static bool intersects(const BBox& a, const BBox& b) {
+        return a.min.x <= b.max.x &&
+               a.min.y <= b.max.y &&
+               a.max.x >= b.min.x &&
+               a.max.y >= b.min.y;
+    }
+
     const int32_t extent;
     const int32_t n;
     const int32_t padding;
@@ -31,8 +62,49 @@ private:
     const int32_t max;
 
     std::vector<std::pair<T, BBox>> elements;
-    std::vector<std::vector<size_t>> cells;
 
+    bool built = false;
+    std::vector<uint32_t> cellOffsets;
+    std::vector<uint32_t> cellElements;
 };
 
+template <class T>
+template <class Fn>
+void GridIndex<T>::query(const BBox& queryBBox, Fn&& fn) const {
+    if (!built) {
+        for (std::size_t uid = 0; uid < elements.size(); ++uid) {
+            if (intersects(queryBBox, elements[uid].second)) {
+                fn(uid);
+            }
+        }
+        return;
+    }
+
+    const int32_t cx1 = convertToCellCoord(queryBBox.min.x);
+    const int32_t cy1 = convertToCellCoord(queryBBox.min.y);
+    const int32_t cx2 = convertToCellCoord(queryBBox.max.x);
+    const int32_t cy2 = convertToCellCoord(queryBBox.max.y);
+
+    for (int32_t y = cy1; y <= cy2; ++y) {
+        for (int32_t x = cx1; x <= cx2; ++x) {
+            const int32_t cellIndex = d * y + x;
+            for (uint32_t i = cellOffsets[cellIndex]; i < cellOffsets[cellIndex + 1]; ++i) {
+                const uint32_t uid = cellElements[i];
+                const BBox& bbox = elements[uid].second;
+
+                // An element spanning several of the queried cells is reported only from
+                // the first of them, so that no set of seen elements is needed.
+                if (x != std::max(cx1, convertToCellCoord(bbox.min.x)) ||
+                    y != std::max(cy1, convertToCellCoord(bbox.min.y))) {
+                    continue;
+                }
+
+                if (intersects(queryBBox, bbox)) {
+                    fn(uid);
+                }
+            }
+        }
+    }
+}
+
 } // namespace mbgl
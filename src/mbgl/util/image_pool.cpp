@@ -0,0 +1,54 @@
+#include <mbgl/util/image_pool.hpp>
+
+namespace mbgl {
+namespace util {
+
+ImagePool::ImagePool(std::size_t maxBytes_) : maxBytes(maxBytes_) {
+}
+
+PremultipliedImage ImagePool::acquire(uint16_t width, uint16_t height) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buffers.find({ width, height });
+        if (it != buffers.end()) {
+            std::unique_ptr<uint8_t[]> data = std::move(it->second.back());
+            it->second.pop_back();
+            if (it->second.empty()) {
+                buffers.erase(it);
+            }
+            bytes -= std::size_t(width) * height * 4;
+            return { width, height, std::move(data) };
+        }
+    }
+
+    // Unlike the Image constructor, doesn't zero the pixels, which are about to be overwritten.
+    return { width, height, std::unique_ptr<uint8_t[]>(new uint8_t[std::size_t(width) * height * 4]) };
+}
+
+void ImagePool::release(PremultipliedImage&& image) {
+    if (!image.data) {
+        return;
+    }
+
+    const std::size_t size = image.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bytes + size <= maxBytes) {
+        buffers[{ image.width, image.height }].push_back(std::move(image.data));
+        bytes += size;
+    }
+    image = {};
+}
+
+void ImagePool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers.clear();
+    bytes = 0;
+}
+
+std::size_t ImagePool::getBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+/*
+   Keeps the pixel buffers of released images for reuse by images of the same dimensions, so
+   that decoding a stream of equally sized images, such as raster tiles, doesn't allocate a
+   new buffer for each of them. Idle buffers may hold at most a given number of bytes; buffers
+   released beyond that are freed.
+
+   Images may be acquired and released on any thread.
+*/
+class ImagePool : private util::noncopyable {
+public:
+    explicit ImagePool(std::size_t maxBytes);
+
+    // The pixels of the image are uninitialized.
+    PremultipliedImage acquire(uint16_t width, uint16_t height);
+    void release(PremultipliedImage&&);
+
+    // Frees all idle buffers.
+    void clear();
+
+    // The bytes held by idle buffers.
+    std::size_t getBytes() const;
+
+private:
+    const std::size_t maxBytes;
+
+    mutable std::mutex mutex;
+    std::map<std::pair<uint16_t, uint16_t>, std::vector<std::unique_ptr<uint8_t[]>>> buffers;
+    std::size_t bytes = 0;
+};
+
+} // namespace util
+
+// Like decodeImage(const std::string&), but decodes into a buffer acquired from the pool.
+PremultipliedImage decodeImage(const std::string&, util::ImagePool&);
+
+} // namespace mbgl
@@ -1,10 +1,203 @@
 #include <mbgl/util/premultiply.hpp>
 
-#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 namespace mbgl {
 namespace util {
 
+namespace {
+
+inline void premultiplyPixel(uint8_t* pixel) {
+    uint8_t& r = pixel[0];
+    uint8_t& g = pixel[1];
+    uint8_t& b = pixel[2];
+    uint8_t& a = pixel[3];
+    r = (r * a + 127) / 255;
+    g = (g * a + 127) / 255;
+    b = (b * a + 127) / 255;
+}
+
+inline void unpremultiplyPixel(uint8_t* pixel) {
+    uint8_t& r = pixel[0];
+    uint8_t& g = pixel[1];
+    uint8_t& b = pixel[2];
+    uint8_t& a = pixel[3];
+    if (a) {
+        r = (255 * r + (a / 2)) / a;
+        g = (255 * g + (a / 2)) / a;
+        b = (255 * b + (a / 2)) / a;
+    }
+}
+
+// The kernels below compute exactly what the scalar functions above do, several pixels at a
+// time. Dividing by 255 uses x / 255 == (x + 1 + (x >> 8)) >> 8, which holds for the
+// products of two bytes plus 127. Dividing by alpha uses a float division, corrected by one
+// where rounding made it miss the integer quotient.
+
+#if defined(__SSE2__)
+
+const std::size_t vectorPixels = 4;
+
+inline __m128i divideBy255(__m128i x) {
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+// Multiplies the color channels of two pixels widened to 16 bits by their alpha, and the
+// alpha channel by 255, which leaves it unchanged.
+inline __m128i premultiplyWide(__m128i pixels) {
+    const __m128i factors = _mm_or_si128(
+        _mm_and_si128(_mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)),
+                      _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+        _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+    return divideBy255(_mm_add_epi16(_mm_mullo_epi16(pixels, factors), _mm_set1_epi16(127)));
+}
+
+inline void premultiplyVector(uint8_t* data) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i low = premultiplyWide(_mm_unpacklo_epi8(pixels, zero));
+    const __m128i high = premultiplyWide(_mm_unpackhi_epi8(pixels, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_packus_epi16(low, high));
+}
+
+// Unpremultiplies one pixel widened to 32 bits. The result is truncated to 8 bits later, like
+// the assignment to uint8_t in unpremultiplyPixel().
+inline __m128i unpremultiplyWide(__m128i pixel) {
+    const __m128i alpha = _mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i numerator = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel), _mm_srli_epi32(alpha, 1));
+
+    const __m128 numeratorFloat = _mm_cvtepi32_ps(numerator);
+    const __m128 alphaFloat = _mm_cvtepi32_ps(alpha);
+
+    __m128i quotient = _mm_cvttps_epi32(_mm_div_ps(numeratorFloat, alphaFloat));
+    __m128 quotientFloat = _mm_cvtepi32_ps(quotient);
+    quotient = _mm_add_epi32(quotient, _mm_castps_si128(
+        _mm_cmpgt_ps(_mm_mul_ps(quotientFloat, alphaFloat), numeratorFloat)));
+    quotientFloat = _mm_cvtepi32_ps(quotient);
+    quotient = _mm_sub_epi32(quotient, _mm_castps_si128(
+        _mm_cmple_ps(_mm_mul_ps(_mm_add_ps(quotientFloat, _mm_set1_ps(1)), alphaFloat), numeratorFloat)));
+
+    // Keeps the alpha channel, and the color channels of transparent pixels.
+    const __m128i keep = _mm_or_si128(_mm_cmpeq_epi32(alpha, _mm_setzero_si128()), _mm_set_epi32(-1, 0, 0, 0));
+    const __m128i result = _mm_or_si128(_mm_and_si128(keep, pixel), _mm_andnot_si128(keep, quotient));
+    return _mm_and_si128(result, _mm_set1_epi32(0xFF));
+}
+
+inline void unpremultiplyVector(uint8_t* data) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i low = _mm_unpacklo_epi8(pixels, zero);
+    const __m128i high = _mm_unpackhi_epi8(pixels, zero);
+    const __m128i result = _mm_packus_epi16(
+        _mm_packs_epi32(unpremultiplyWide(_mm_unpacklo_epi16(low, zero)), unpremultiplyWide(_mm_unpackhi_epi16(low, zero))),
+        _mm_packs_epi32(unpremultiplyWide(_mm_unpacklo_epi16(high, zero)), unpremultiplyWide(_mm_unpackhi_epi16(high, zero))));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), result);
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+const std::size_t vectorPixels = 8;
+
+inline uint8x8_t premultiplyChannel(uint8x8_t color, uint8x8_t alpha) {
+    const uint16x8_t x = vmlal_u8(vdupq_n_u16(127), color, alpha);
+    return vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+inline void premultiplyVector(uint8_t* data) {
+    uint8x8x4_t pixels = vld4_u8(data);
+    pixels.val[0] = premultiplyChannel(pixels.val[0], pixels.val[3]);
+    pixels.val[1] = premultiplyChannel(pixels.val[1], pixels.val[3]);
+    pixels.val[2] = premultiplyChannel(pixels.val[2], pixels.val[3]);
+    vst4_u8(data, pixels);
+}
+
+#if defined(__aarch64__)
+
+inline uint32x4_t unpremultiplyWide(uint32x4_t color, uint32x4_t alpha) {
+    const uint32x4_t numerator = vaddq_u32(vsubq_u32(vshlq_n_u32(color, 8), color), vshrq_n_u32(alpha, 1));
+
+    const float32x4_t numeratorFloat = vcvtq_f32_u32(numerator);
+    const float32x4_t alphaFloat = vcvtq_f32_u32(alpha);
+
+    uint32x4_t quotient = vcvtq_u32_f32(vdivq_f32(numeratorFloat, alphaFloat));
+    float32x4_t quotientFloat = vcvtq_f32_u32(quotient);
+    quotient = vaddq_u32(quotient, vcgtq_f32(vmulq_f32(quotientFloat, alphaFloat), numeratorFloat));
+    quotientFloat = vcvtq_f32_u32(quotient);
+    quotient = vsubq_u32(quotient, vcleq_f32(vmulq_f32(vaddq_f32(quotientFloat, vdupq_n_f32(1)), alphaFloat), numeratorFloat));
+
+    // Keeps the color channels of transparent pixels.
+    return vbslq_u32(vceqq_u32(alpha, vdupq_n_u32(0)), color, quotient);
+}
+
+inline uint8x8_t unpremultiplyChannel(uint8x8_t color, uint8x8_t alpha) {
+    const uint16x8_t color16 = vmovl_u8(color);
+    const uint16x8_t alpha16 = vmovl_u8(alpha);
+    const uint32x4_t low = unpremultiplyWide(vmovl_u16(vget_low_u16(color16)), vmovl_u16(vget_low_u16(alpha16)));
+    const uint32x4_t high = unpremultiplyWide(vmovl_u16(vget_high_u16(color16)), vmovl_u16(vget_high_u16(alpha16)));
+
+    // Truncates to 8 bits, like the assignment to uint8_t in unpremultiplyPixel().
+    return vmovn_u16(vcombine_u16(vmovn_u32(low), vmovn_u32(high)));
+}
+
+inline void unpremultiplyVector(uint8_t* data) {
+    uint8x8x4_t pixels = vld4_u8(data);
+    pixels.val[0] = unpremultiplyChannel(pixels.val[0], pixels.val[3]);
+    pixels.val[1] = unpremultiplyChannel(pixels.val[1], pixels.val[3]);
+    pixels.val[2] = unpremultiplyChannel(pixels.val[2], pixels.val[3]);
+    vst4_u8(data, pixels);
+}
+
+#else
+
+// 32 bit ARM has no vector division.
+inline void unpremultiplyVector(uint8_t* data) {
+    for (std::size_t i = 0; i < vectorPixels; i++) {
+        unpremultiplyPixel(data + i * 4);
+    }
+}
+
+#endif // defined(__aarch64__)
+
+#else
+
+const std::size_t vectorPixels = 1;
+
+inline void premultiplyVector(uint8_t* data) {
+    premultiplyPixel(data);
+}
+
+inline void unpremultiplyVector(uint8_t* data) {
+    unpremultiplyPixel(data);
+}
+
+#endif
+
+} // namespace
+
+void premultiply(uint8_t* data, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + vectorPixels <= pixels; i += vectorPixels) {
+        premultiplyVector(data + i * 4);
+    }
+    for (; i < pixels; i++) {
+        premultiplyPixel(data + i * 4);
+    }
+}
+
+void unpremultiply(uint8_t* data, std::size_t pixels) {
+    std::size_t i = 0;
+    for (; i + vectorPixels <= pixels; i += vectorPixels) {
+        unpremultiplyVector(data + i * 4);
+    }
+    for (; i < pixels; i++) {
+        unpremultiplyPixel(data + i * 4);
+    }
+}
+
 PremultipliedImage premultiply(UnassociatedImage&& src) {
     PremultipliedImage dst;
 
@@ -12,16 +205,7 @@ PremultipliedImage premultiply(UnassociatedImage&& src) {
     dst.height = src.height;
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.size(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        r = (r * a + 127) / 255;
-        g = (g * a + 127) / 255;
-        b = (b * a + 127) / 255;
-    }
+    premultiply(dst.data.get(), std::size_t(dst.width) * dst.height);
 
     return dst;
 }
@@ -33,18 +217,7 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
     dst.height = src.height;
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.size(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        if (a) {
-            r = (255 * r + (a / 2)) / a;
-            g = (255 * g + (a / 2)) / a;
-            b = (255 * b + (a / 2)) / a;
-        }
-    }
+    unpremultiply(dst.data.get(), std::size_t(dst.width) * dst.height);
 
     return dst;
 }
@@ -2,11 +2,19 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace mbgl {
 namespace util {
 
 PremultipliedImage premultiply(UnassociatedImage&&);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
+// Convert the given number of consecutive RGBA pixels in place, several at a time with SSE2
+// or NEON where available.
+void premultiply(uint8_t* data, std::size_t pixels);
+void unpremultiply(uint8_t* data, std::size_t pixels);
+
 } // namespace util
 } // namespace mbgl
@@ -1,6 +1,7 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/map/transform_state.hpp>
 
 #include <functional>
@@ -136,27 +137,73 @@ int32_t coveringZoomLevel(double zoom, SourceType type, uint16_t size) {
     }
 }
 
-std::vector<UnwrappedTileID> tileCover(const LatLngBounds& bounds_, int32_t z) {
-    if (bounds_.isEmpty() ||
-        bounds_.south() >  util::LATITUDE_MAX ||
-        bounds_.north() < -util::LATITUDE_MAX) {
+namespace {
+
+// The part of the bounds that can be projected, if any.
+optional<LatLngBounds> projectableBounds(const LatLngBounds& bounds) {
+    if (bounds.isEmpty() ||
+        bounds.south() >  util::LATITUDE_MAX ||
+        bounds.north() < -util::LATITUDE_MAX) {
         return {};
     }
 
-    LatLngBounds bounds = LatLngBounds::hull(
-        { std::max(bounds_.south(), -util::LATITUDE_MAX), bounds_.west() },
-        { std::min(bounds_.north(),  util::LATITUDE_MAX), bounds_.east() });
+    return LatLngBounds::hull(
+        { std::max(bounds.south(), -util::LATITUDE_MAX), bounds.west() },
+        { std::min(bounds.north(),  util::LATITUDE_MAX), bounds.east() });
+}
+
+} // namespace
+
+std::vector<UnwrappedTileID> tileCover(const LatLngBounds& bounds_, int32_t z) {
+    const optional<LatLngBounds> bounds = projectableBounds(bounds_);
+    if (!bounds) {
+        return {};
+    }
 
     const TransformState state;
     return tileCover(
-        TileCoordinate::fromLatLng(state, z, bounds.northwest()).p,
-        TileCoordinate::fromLatLng(state, z, bounds.northeast()).p,
-        TileCoordinate::fromLatLng(state, z, bounds.southeast()).p,
-        TileCoordinate::fromLatLng(state, z, bounds.southwest()).p,
-        TileCoordinate::fromLatLng(state, z, bounds.center()).p,
+        TileCoordinate::fromLatLng(state, z, bounds->northwest()).p,
+        TileCoordinate::fromLatLng(state, z, bounds->northeast()).p,
+        TileCoordinate::fromLatLng(state, z, bounds->southeast()).p,
+        TileCoordinate::fromLatLng(state, z, bounds->southwest()).p,
+        TileCoordinate::fromLatLng(state, z, bounds->center()).p,
         z);
 }
 
+uint64_t tileCount(const LatLngBounds& bounds_, int32_t z) {
+    const optional<LatLngBounds> bounds = projectableBounds(bounds_);
+    if (!bounds) {
+        return 0;
+    }
+
+    const TransformState state;
+    const Point<double> nw = TileCoordinate::fromLatLng(state, z, bounds->northwest()).p;
+    const Point<double> se = TileCoordinate::fromLatLng(state, z, bounds->southeast()).p;
+
+    // Scanning the two triangles of the bounds covers whole rows of the same tiles, except
+    // that their common diagonal may end past the east edge in the last row.
+    const double dx = se.x - nw.x;
+    const double dy = se.y - nw.y;
+    if (!dy) {
+        return 0;
+    }
+
+    const int64_t y0 = std::max<int64_t>(0, std::floor(nw.y));
+    const int64_t y1 = std::min<int64_t>(int64_t(1) << z, std::ceil(se.y));
+    if (y1 <= y0) {
+        return 0;
+    }
+
+    // Computed exactly as `scanSpans` computes it.
+    const double diagonalEnd = dx / dy * ::fmax(0, ::fmin(dy, y1 - nw.y)) + nw.x;
+
+    const int64_t x0 = std::floor(nw.x);
+    const int64_t width = std::max<int64_t>(0, int64_t(std::ceil(se.x)) - x0);
+    const int64_t lastRowWidth = std::max<int64_t>(width, int64_t(std::ceil(diagonalEnd)) - x0);
+
+    return uint64_t((y1 - y0 - 1) * width + lastRowWidth);
+}
+
 std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
     const double w = state.getWidth();
     const double h = state.getHeight();
@@ -18,5 +18,8 @@ int32_t coveringZoomLevel(double z, SourceType type, uint16_t tileSize);
 std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z);
 std::vector<UnwrappedTileID> tileCover(const LatLngBounds&, int32_t z);
 
+// The number of tiles `tileCover` returns for the bounds, computed without enumerating them.
+uint64_t tileCount(const LatLngBounds&, int32_t z);
+
 } // namespace util
 } // namespace mbgl
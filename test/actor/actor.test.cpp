@@ -6,6 +6,8 @@
 #include <chrono>
 #include <functional>
 #include <future>
+#include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -137,3 +139,52 @@ TEST(Actor, NonConcurrentMailbox) {
     test.invoke(&Test::end);
     endedFuture.wait();
 }
+
+TEST(Actor, MultipleProducers) {
+    // Messages from several concurrent senders are all delivered, and messages from each
+    // individual sender are processed in the order sent.
+
+    struct Test {
+        std::vector<int> last;
+        int received = 0;
+
+        Test(ActorRef<Test>, std::size_t producers)
+            : last(producers, 0) {
+        }
+
+        void receive(std::size_t producer, int i) {
+            EXPECT_EQ(i, last[producer] + 1);
+            last[producer] = i;
+            received++;
+        }
+
+        void end(std::promise<int> count) {
+            count.set_value(received);
+        }
+    };
+
+    const std::size_t producers = 4;
+    const int messages = 1000;
+
+    ThreadPool pool { 2 };
+
+    Actor<Test> test(pool, producers);
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (auto i = 1; i <= messages; ++i) {
+                test.invoke(&Test::receive, p, i);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::promise<int> countPromise;
+    std::future<int> countFuture = countPromise.get_future();
+    test.invoke(&Test::end, std::move(countPromise));
+    EXPECT_EQ(static_cast<int>(producers) * messages, countFuture.get());
+}
@@ -0,0 +1,73 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ThreadPool, Priority) {
+    // Mailboxes scheduled while the pool is busy are processed most urgent first.
+
+    struct Blocker {
+        Blocker(ActorRef<Blocker>) {
+        }
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Recorder {
+        int id;
+        std::mutex& mutex;
+        std::vector<int>& order;
+
+        Recorder(ActorRef<Recorder>, int id_, std::mutex& mutex_, std::vector<int>& order_)
+            : id(id_), mutex(mutex_), order(order_) {
+        }
+
+        void record(std::promise<void> done) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+            done.set_value();
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::mutex mutex;
+    std::vector<int> order;
+
+    Actor<Blocker> blocker(pool);
+    Actor<Recorder> lowest(pool, 3, std::ref(mutex), std::ref(order));
+    Actor<Recorder> low(pool, 2, std::ref(mutex), std::ref(order));
+    Actor<Recorder> highest(pool, 0, std::ref(mutex), std::ref(order));
+    lowest.setPriority(MailboxPriority::Lowest);
+    low.setPriority(MailboxPriority::Low);
+    highest.setPriority(MailboxPriority::Highest);
+
+    std::promise<void> entered;
+    std::future<void> enteredFuture = entered.get_future();
+    std::promise<void> release;
+    blocker.invoke(&Blocker::block, std::move(entered), release.get_future().share());
+    enteredFuture.wait();
+
+    std::vector<std::future<void>> done;
+    for (auto actor : { &lowest, &low, &highest }) {
+        std::promise<void> promise;
+        done.push_back(promise.get_future());
+        actor->invoke(&Recorder::record, std::move(promise));
+    }
+
+    release.set_value();
+    for (auto& future : done) {
+        future.wait();
+    }
+
+    EXPECT_EQ((std::vector<int> { 0, 2, 3 }), order);
+}
@@ -0,0 +1,143 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/work_stealing_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace mbgl;
+using namespace std::chrono_literals;
+
+TEST(WorkStealingThreadPool, OrderedMailbox) {
+    // Messages are processed in order.
+
+    struct Test {
+        int last = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 4 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 1; i <= 1000; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, NonConcurrentMailbox) {
+    // An individual actor is never itself concurrent, even when its mailbox is stolen.
+
+    struct Test {
+        int last = 0;
+        std::atomic<bool> receiving { false };
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_FALSE(receiving.exchange(true));
+            EXPECT_EQ(i, last + 1);
+            last = i;
+            std::this_thread::sleep_for(1ms);
+            receiving = false;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 10 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 1; i <= 10; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, ActorToActor) {
+    // Messages sent from a worker thread land on that worker's own deque and are stolen by
+    // idle workers; every message is still delivered exactly once.
+
+    struct Sink {
+        std::atomic<int>& received;
+
+        Sink(ActorRef<Sink>, std::atomic<int>& received_)
+            : received(received_) {
+        }
+
+        void receive() {
+            received++;
+        }
+    };
+
+    struct Source {
+        std::vector<ActorRef<Sink>> sinks;
+
+        Source(ActorRef<Source>, std::vector<ActorRef<Sink>> sinks_)
+            : sinks(std::move(sinks_)) {
+        }
+
+        void fanOut(int count, std::promise<void> promise) {
+            for (int i = 0; i < count; ++i) {
+                for (auto& sink : sinks) {
+                    sink.invoke(&Sink::receive);
+                }
+            }
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 8 };
+    std::atomic<int> received { 0 };
+
+    std::vector<std::unique_ptr<Actor<Sink>>> sinks;
+    std::vector<ActorRef<Sink>> refs;
+    for (int i = 0; i < 16; ++i) {
+        sinks.emplace_back(std::make_unique<Actor<Sink>>(pool, std::ref(received)));
+        refs.push_back(sinks.back()->self());
+    }
+
+    Actor<Source> source(pool, refs);
+
+    std::promise<void> sentPromise;
+    std::future<void> sentFuture = sentPromise.get_future();
+    source.invoke(&Source::fanOut, 100, std::move(sentPromise));
+    sentFuture.wait();
+
+    while (received < 1600) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(1600, received);
+}
@@ -0,0 +1,104 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fixture_log_observer.hpp>
+
+#include <mbgl/map/render_pool.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+std::unique_ptr<RenderPool> createPool(FileSource& fileSource, std::size_t size) {
+    auto display = std::make_shared<HeadlessDisplay>();
+    return std::make_unique<RenderPool>(fileSource, size, [display] {
+        return std::make_unique<HeadlessView>(display, 1, 256, 512);
+    });
+}
+
+} // end namespace
+
+TEST(RenderPool, RenderStill) {
+    util::RunLoop loop;
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Log::setObserver(std::make_unique<FixtureLogObserver>());
+
+    auto pool = createPool(fileSource, 2);
+    EXPECT_EQ(2u, pool->size());
+
+    // Requested before the style, the renders wait for it.
+    std::vector<PremultipliedImage> results;
+    for (int i = 0; i < 4; i++) {
+        CameraOptions camera;
+        camera.zoom = i;
+        pool->renderStill(camera, [&](std::exception_ptr error, PremultipliedImage&& image) {
+            EXPECT_EQ(nullptr, error);
+            results.push_back(std::move(image));
+        });
+    }
+    EXPECT_EQ(4u, pool->pendingRenders());
+
+    pool->setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+
+    while (results.size() < 4) {
+        loop.runOnce();
+    }
+
+    EXPECT_EQ(0u, pool->pendingRenders());
+    for (const auto& result : results) {
+        EXPECT_EQ(256u, result.width);
+        EXPECT_EQ(512u, result.height);
+    }
+
+    auto observer = Log::removeObserver();
+    auto flo = dynamic_cast<FixtureLogObserver*>(observer.get());
+    auto unchecked = flo->unchecked();
+    EXPECT_TRUE(unchecked.empty()) << unchecked;
+}
+
+TEST(RenderPool, StyleLoadFailure) {
+    util::RunLoop loop;
+
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+    auto pool = createPool(fileSource, 2);
+
+    pool->setStyleURL("asset://missing.json");
+
+    std::size_t failures = 0;
+    for (int i = 0; i < 3; i++) {
+        pool->renderStill({}, [&](std::exception_ptr error, PremultipliedImage&&) {
+            EXPECT_NE(nullptr, error);
+            failures++;
+        });
+    }
+
+    while (failures < 3) {
+        loop.runOnce();
+    }
+
+    EXPECT_EQ(0u, pool->pendingRenders());
+
+    // Renders requested after the failure fail too.
+    pool->renderStill({}, [&](std::exception_ptr error, PremultipliedImage&&) {
+        EXPECT_NE(nullptr, error);
+        failures++;
+    });
+
+    while (failures < 4) {
+        loop.runOnce();
+    }
+
+    EXPECT_EQ(0u, pool->pendingRenders());
+}
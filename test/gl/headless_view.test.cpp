@@ -0,0 +1,95 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Clears the bottom half of the 64x32 framebuffer to the given color and the top half to blue,
+// so that images show whether their rows were flipped.
+void clear(float red, float green) {
+    MBGL_CHECK_ERROR(glClearColor(red, green, 0, 1));
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+    MBGL_CHECK_ERROR(glEnable(GL_SCISSOR_TEST));
+    MBGL_CHECK_ERROR(glScissor(0, 16, 64, 16));
+    MBGL_CHECK_ERROR(glClearColor(0, 0, 1, 1));
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+    MBGL_CHECK_ERROR(glDisable(GL_SCISSOR_TEST));
+}
+
+} // namespace
+
+TEST(HeadlessView, ReadStillImageAsync) {
+    util::RunLoop loop;
+    HeadlessView view(std::make_shared<HeadlessDisplay>(), 1, 64, 32);
+
+    // With two buffers, the third image waits for the first to transfer.
+    std::vector<PremultipliedImage> images;
+    view.activate();
+    for (int i = 0; i < 3; i++) {
+        clear(i == 1 ? 1 : 0, i == 2 ? 1 : 0);
+        view.readStillImageAsync([&] (PremultipliedImage&& image) {
+            images.push_back(std::move(image));
+        });
+    }
+    view.deactivate();
+
+    while (images.size() < 3) {
+        loop.runOnce();
+    }
+
+    // Images arrive in order, top row first, like with readStillImage().
+    const uint8_t top[4] = { 0, 0, 255, 255 };
+    const uint8_t bottom[3][4] = { { 0, 0, 0, 255 }, { 255, 0, 0, 255 }, { 0, 255, 0, 255 } };
+    for (std::size_t i = 0; i < images.size(); i++) {
+        ASSERT_EQ(64u, images[i].width);
+        ASSERT_EQ(32u, images[i].height);
+        for (std::size_t pixel = 0; pixel < images[i].size(); pixel += 4) {
+            const bool topHalf = pixel < images[i].size() / 2;
+            ASSERT_EQ(0, std::memcmp(topHalf ? top : bottom[i], images[i].data.get() + pixel, 4))
+                << "image " << i << ", row " << pixel / images[i].stride();
+        }
+    }
+
+    // Recycled buffers are reused for images of the same size.
+    const uint8_t* buffer = images[0].data.get();
+    view.recycle(std::move(images[0]));
+    images.clear();
+
+    view.activate();
+    view.readStillImageAsync([&] (PremultipliedImage&& image) {
+        images.push_back(std::move(image));
+    });
+    view.deactivate();
+
+    while (images.empty()) {
+        loop.runOnce();
+    }
+    EXPECT_EQ(buffer, images[0].data.get());
+}
+
+TEST(HeadlessView, ReadStillImageSync) {
+    util::RunLoop loop;
+    HeadlessView view(std::make_shared<HeadlessDisplay>(), 1, 64, 32);
+    view.setReadbackBuffers(0);
+
+    bool called = false;
+    view.activate();
+    clear(1, 0);
+    view.readStillImageAsync([&] (PremultipliedImage&& image) {
+        EXPECT_EQ(view.readStillImage(), image);
+        called = true;
+    });
+    view.deactivate();
+
+    EXPECT_TRUE(called);
+}
@@ -15,6 +15,8 @@
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <cstring>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace std::literals::string_literals;
@@ -42,6 +44,19 @@ TEST(Map, LatLngBehavior) {
     ASSERT_DOUBLE_EQ(latLng1.longitude, latLng2.longitude);
 }
 
+TEST(Map, TimeToFirstFullFrame) {
+    MapTest test;
+    Map map(test.view, test.fileSource, MapMode::Still);
+
+    EXPECT_FALSE(map.getTimeToFirstFullFrame());
+
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test::render(map);
+
+    ASSERT_TRUE(map.getTimeToFirstFullFrame());
+    EXPECT_LE(Duration::zero(), *map.getTimeToFirstFullFrame());
+}
+
 TEST(Map, Offline) {
     MapTest test;
     DefaultFileSource fileSource(":memory:", ".");
@@ -392,3 +407,69 @@ TEST(Map, RemoveImage) {
     test::checkImage("test/fixtures/map/remove_icon", test::render(map));
 }
 
+TEST(Map, RenderStillTiles) {
+    MapTest test;
+    HeadlessView view(test.display, 1, 512, 512);
+
+    // Each quarter of the world has its own color.
+    Map map(view, test.fileSource, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/quadrants.json"));
+
+    // The 2 × 2 block of 256 pixel tiles at z1 is the whole world.
+    std::vector<PremultipliedImage> tiles;
+    bool done = false;
+    map.renderStillTiles(1, 0, 0, 2, 256, [&](std::exception_ptr error, std::vector<PremultipliedImage> result) {
+        EXPECT_EQ(nullptr, error);
+        tiles = std::move(result);
+        done = true;
+    });
+
+    while (!done) {
+        test.runLoop.runOnce();
+    }
+
+    EXPECT_DOUBLE_EQ(0, map.getZoom());
+    EXPECT_NEAR(0, map.getLatLng().latitude, 1e-6);
+    EXPECT_NEAR(0, map.getLatLng().longitude, 1e-6);
+
+    // Each tile is the matching quarter of the whole image, in row order.
+    const PremultipliedImage whole = test::render(map);
+    const uint8_t colors[4][4] = { { 255, 0, 0, 255 }, { 0, 255, 0, 255 }, { 0, 0, 255, 255 }, { 255, 255, 0, 255 } };
+    ASSERT_EQ(4u, tiles.size());
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        ASSERT_EQ(256u, tiles[i].width);
+        ASSERT_EQ(256u, tiles[i].height);
+        EXPECT_EQ(0, std::memcmp(colors[i], tiles[i].data.get() + 128 * tiles[i].stride() + 128 * 4, 4)) << "tile " << i;
+        for (std::size_t line = 0; line < 256; line++) {
+            const uint8_t* expected = whole.data.get() + ((i / 2) * 256 + line) * whole.stride() + (i % 2) * 256 * 4;
+            EXPECT_EQ(0, std::memcmp(expected, tiles[i].data.get() + line * tiles[i].stride(), tiles[i].stride()));
+        }
+    }
+}
+
+TEST(Map, RenderStillTilesMisuse) {
+    MapTest test;
+    HeadlessView view(test.display, 1, 512, 512);
+
+    Map map(view, test.fileSource, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto expectError = [&] (uint8_t z, uint32_t x, uint32_t y, uint16_t size, uint16_t tileSize) {
+        bool called = false;
+        map.renderStillTiles(z, x, y, size, tileSize, [&](std::exception_ptr error, std::vector<PremultipliedImage> result) {
+            EXPECT_NE(nullptr, error);
+            EXPECT_TRUE(result.empty());
+            called = true;
+        });
+        EXPECT_TRUE(called);
+    };
+
+    // The view doesn't fit the metatile.
+    expectError(2, 0, 0, 4, 256);
+
+    // The metatile reaches past the edge of the world.
+    expectError(2, 3, 0, 2, 256);
+
+    // 256 pixel tiles at z0 would need a map zoom level below 0.
+    expectError(0, 0, 0, 1, 256);
+}
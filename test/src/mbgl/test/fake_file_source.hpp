@@ -41,6 +41,10 @@ public:
         return std::make_unique<FakeFileRequest>(resource, callback, requests);
     }
 
+    void setPriority(AsyncRequest& request, Resource::Priority priority) override {
+        static_cast<FakeFileRequest&>(request).resource.priority = priority;
+    }
+
     bool respond(Resource::Kind kind, const Response& response) {
         auto it = std::find_if(requests.begin(), requests.end(), [&] (FakeFileRequest* request) {
             return request->resource.kind == kind;
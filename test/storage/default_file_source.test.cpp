@@ -1,6 +1,10 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/tile_archive.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/timer.hpp>
+#include <mbgl/util/constants.hpp>
 
 using namespace mbgl;
 
@@ -291,6 +295,133 @@ TEST(DefaultFileSource, OptionalNotFound) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(OptionalReaders)) {
+    util::RunLoop loop;
+
+    try {
+        util::deleteFile("test/fixtures/offline_database/cache.db");
+    } catch (util::IOException&) {
+    }
+
+    DefaultFileSource fs("test/fixtures/offline_database/cache.db", ".", util::DEFAULT_MAX_CACHE_SIZE, 2);
+
+    std::size_t lookups = 0;
+    fs.setQueueWaitObserver([&] (const Resource&, Duration wait) {
+        EXPECT_LE(Duration::zero(), wait);
+        lookups++;
+    });
+
+    const Resource cached { Resource::Unknown, "http://127.0.0.1:3000/cached", {}, Resource::Optional };
+    const Resource uncached { Resource::Unknown, "http://127.0.0.1:3000/uncached", {}, Resource::Optional };
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    fs.put(cached, response);
+
+    // Both requests are looked up on the reader threads.
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    req1 = fs.request(cached, [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+
+        req2 = fs.request(uncached, [&](Response res2) {
+            req2.reset();
+            ASSERT_TRUE(res2.error.get());
+            EXPECT_EQ(Response::Error::Reason::NotFound, res2.error->reason);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2u, lookups);
+}
+
+// Destroying the request in the callback of a cached response, which a reader thread has
+// looked up, must not touch the request afterwards. Run with AddressSanitizer to catch it.
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(ReadersResetInCallback)) {
+    util::RunLoop loop;
+
+    try {
+        util::deleteFile("test/fixtures/offline_database/cache.db");
+    } catch (util::IOException&) {
+    }
+
+    DefaultFileSource fs("test/fixtures/offline_database/cache.db", ".", util::DEFAULT_MAX_CACHE_SIZE, 2);
+
+    const Resource optional { Resource::Unknown, "http://127.0.0.1:3000/optional", {}, Resource::Optional };
+    const Resource required { Resource::Unknown, "http://127.0.0.1:3000/required" };
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    fs.put(optional, response);
+    fs.put(required, response);
+
+    std::size_t responses = 0;
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    req1 = fs.request(optional, [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        responses++;
+    });
+    req2 = fs.request(required, [&](Response res) {
+        req2.reset();
+        EXPECT_EQ(nullptr, res.error);
+        responses++;
+    });
+
+    // Gives the canceled online request time to call back, which it must not.
+    util::Timer timer;
+    timer.start(Milliseconds(200), Duration::zero(), [&] {
+        loop.stop();
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2u, responses);
+}
+
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(TileArchive)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    TileArchive::write("test/fixtures/tile_archive/default.archive", {
+        { 0, 0, 0, "Archived value" },
+    });
+    fs.addTileArchive("http://127.0.0.1:3000/{z}-{x}-{y}", "test/fixtures/tile_archive/default.archive");
+
+    const Resource archived = Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    Resource cached = Resource::tile("http://127.0.0.1:3000/{z}-{x}-{y}", 1.0, 0, 0, 1, Tileset::Scheme::XYZ, Resource::Optional);
+
+    // Tiles missing from the archive are looked up in the database.
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    fs.put(cached, response);
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    req1 = fs.request(archived, [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Archived value", *res.data);
+
+        req2 = fs.request(cached, [&](Response res2) {
+            req2.reset();
+            EXPECT_EQ(nullptr, res2.error);
+            ASSERT_TRUE(res2.data.get());
+            EXPECT_EQ("Cached value", *res2.data);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
+
 // Test that we can make a request with etag data that doesn't first try to load
 // from cache like a regular request
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagNotModified)) {
@@ -52,3 +52,36 @@ TEST(OfflineTilePyramidRegionDefinition, TileCoverWrapped) {
     EXPECT_EQ((std::vector<CanonicalTileID>{ { 0, 0, 0 } }),
               region.tileCover(SourceType::Vector, 512, { 0, 22 }));
 }
+
+TEST(OfflineTilePyramidRegionDefinition, TileCount) {
+    OfflineTilePyramidRegionDefinition region("", sanFrancisco, 0, 16, 1.0);
+
+    EXPECT_EQ(region.tileCover(SourceType::Vector, 512, { 0, 22 }).size(),
+              region.tileCount(SourceType::Vector, 512, { 0, 22 }));
+    EXPECT_EQ(region.tileCover(SourceType::Raster, 256, { 4, 12 }).size(),
+              region.tileCount(SourceType::Raster, 256, { 4, 12 }));
+
+    OfflineTilePyramidRegionDefinition empty("", LatLngBounds::empty(), 0, 20, 1.0);
+    EXPECT_EQ(0u, empty.tileCount(SourceType::Vector, 512, { 0, 22 }));
+}
+
+TEST(OfflineRegionSizeEstimator, Estimate) {
+    OfflineTilePyramidRegionDefinition world("", LatLngBounds::world(), 0, 2, 1.0);
+
+    // Zoom levels 0, 1 and 2 have 1, 4 and 16 tiles. Zoom level 1 uses the average of zoom
+    // level 0, the nearest one, and zoom level 2 that of zoom level 3.
+    OfflineRegionSizeEstimator estimator({ { 0, 1000 }, { 3, 10 } });
+    OfflineRegionSizeEstimator::Estimate estimate =
+        estimator.estimate(world, SourceType::Vector, 512, { 0, 22 });
+    EXPECT_EQ(21u, estimate.tileCount);
+    EXPECT_EQ(1000u + 4 * 1000u + 16 * 10u, estimate.size);
+
+    estimate = estimator.estimate(world, SourceType::Vector, 512, { 1, 1 });
+    EXPECT_EQ(4u, estimate.tileCount);
+    EXPECT_EQ(4000u, estimate.size);
+
+    // Without averages, only tiles are counted.
+    estimate = OfflineRegionSizeEstimator({}).estimate(world, SourceType::Vector, 512, { 0, 22 });
+    EXPECT_EQ(21u, estimate.tileCount);
+    EXPECT_EQ(0u, estimate.size);
+}
@@ -586,19 +586,19 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
 
     // v2.db is a v2 database containing a single offline region with a small number of resources.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v2.db"));
+    deleteFile("test/fixtures/offline_database/v7.db");
+    writeFile("test/fixtures/offline_database/v7.db", util::read_file("test/fixtures/offline_database/v2.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v7.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
-    EXPECT_LT(databasePageCount("test/fixtures/offline_database/v5.db"),
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/v7.db"));
+    EXPECT_LT(databasePageCount("test/fixtures/offline_database/v7.db"),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 }
 
@@ -607,18 +607,18 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
 
     // v3.db is a v3 database, migrated from v2.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v3.db"));
+    deleteFile("test/fixtures/offline_database/v7.db");
+    writeFile("test/fixtures/offline_database/v7.db", util::read_file("test/fixtures/offline_database/v3.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v7.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/v7.db"));
 }
 
 TEST(OfflineDatabase, MigrateFromV4Schema) {
@@ -626,22 +626,518 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
 
     // v4.db is a v4 database, migrated from v2 & v3. This database used `journal_mode = WAL` and `synchronous = NORMAL`.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v4.db"));
+    deleteFile("test/fixtures/offline_database/v7.db");
+    writeFile("test/fixtures/offline_database/v7.db", util::read_file("test/fixtures/offline_database/v4.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v7.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/v7.db"));
 
-    // Journal mode should be DELETE after migration to v5.
-    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/v5.db"));
+    // Journal mode should be DELETE after migration to v7.
+    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/v7.db"));
 
-    // Synchronous setting should be FULL (2) after migration to v5.
-    EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v5.db"));
+    // Synchronous setting should be FULL (2) after migration to v7.
+    EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v7.db"));
+}
+
+TEST(OfflineDatabase, MigrateFromV5Schema) {
+    using namespace mbgl;
+
+    // v5.db is a v5 database, migrated from v2, v3 & v4.
+
+    deleteFile("test/fixtures/offline_database/v7.db");
+    writeFile("test/fixtures/offline_database/v7.db", util::read_file("test/fixtures/offline_database/v5.db"));
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/v7.db", 0);
+        auto regions = db.listRegions();
+        for (auto& region : regions) {
+            db.deleteRegion(std::move(region));
+        }
+    }
+
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/v7.db"));
+}
+
+TEST(OfflineDatabase, MigrateFromV6Schema) {
+    using namespace mbgl;
+
+    // v6.db is a v6 database, migrated from v5.
+
+    deleteFile("test/fixtures/offline_database/v7.db");
+    writeFile("test/fixtures/offline_database/v7.db", util::read_file("test/fixtures/offline_database/v6.db"));
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/v7.db", 0);
+        auto regions = db.listRegions();
+        ASSERT_EQ(1u, regions.size());
+        EXPECT_FALSE(bool(db.getRegionTileProgress(regions[0].getID(), "http://example.com/{z}/{x}/{y}")));
+    }
+
+    EXPECT_EQ(7, databaseUserVersion("test/fixtures/offline_database/v7.db"));
+}
+
+static int64_t databaseRegionTileCount(const std::string& path) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = db.prepare("SELECT COUNT(*) FROM region_tiles");
+    stmt.run();
+    return stmt.get<int64_t>(0);
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(BatchedWrites)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::world(), 0, 1, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+    db.setWriteBatching(3, Seconds(3600));
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    auto putTile = [&] (uint32_t x) {
+        db.putRegionResource(region.getID(), Resource::tile("http://example.com/", 1.0, x, 0, 1, Tileset::Scheme::XYZ), response);
+    };
+
+    // Batched writes are visible to the connection that made them, but not to others.
+    putTile(0);
+    putTile(1);
+    EXPECT_TRUE(db.hasUncommittedWrites());
+    EXPECT_EQ(2u, db.getRegionCompletedStatus(region.getID()).completedTileCount);
+    EXPECT_EQ(0, databaseRegionTileCount("test/fixtures/offline_database/offline.db"));
+
+    // The batch is committed once it is full.
+    putTile(2);
+    EXPECT_FALSE(db.hasUncommittedWrites());
+    EXPECT_EQ(3, databaseRegionTileCount("test/fixtures/offline_database/offline.db"));
+
+    // Or when asked to.
+    putTile(3);
+    db.commitWrites();
+    EXPECT_FALSE(db.hasUncommittedWrites());
+    EXPECT_EQ(4, databaseRegionTileCount("test/fixtures/offline_database/offline.db"));
+
+    // Or when it is older than the maximum delay.
+    db.setWriteBatching(3, Duration::zero());
+    putTile(0);
+    EXPECT_FALSE(db.hasUncommittedWrites());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLogging)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+
+    db.setWriteAheadLogging(true);
+    EXPECT_EQ("wal", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+
+    db.setWriteAheadLogging(false);
+    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+}
+
+static std::vector<int64_t> databaseCompressedValues(const std::string& path, const char* table) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = db.prepare(("SELECT compressed FROM "s + table + " ORDER BY id").c_str());
+    std::vector<int64_t> result;
+    while (stmt.run()) {
+        result.push_back(stmt.get<int64_t>(0));
+    }
+    return result;
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(Compression)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    Response response;
+    response.data = std::make_shared<std::string>(1024, 'a');
+
+    auto tile = [] (uint32_t x) {
+        return Resource::tile("http://example.com/", 1.0, x, 0, 1, Tileset::Scheme::XYZ);
+    };
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        EXPECT_EQ(util::Codec::Zlib, db.getCompression());
+        db.put(tile(0), response);
+
+        db.setCompression(util::Codec::None);
+        db.put(tile(1), response);
+
+        db.setCompression(util::Codec::Zstd);
+        EXPECT_EQ(util::isSupported(util::Codec::Zstd) ? util::Codec::Zstd : util::Codec::None, db.getCompression());
+        db.put(tile(2), response);
+    }
+
+    // Each tile is decompressed with the codec it was stored with, whatever the current one is.
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    for (uint32_t x = 0; x < 3; x++) {
+        auto result = db.get(tile(x));
+        ASSERT_TRUE(result && result->data);
+        EXPECT_EQ(*response.data, *result->data);
+    }
+
+    const std::vector<int64_t> expected = {
+        int64_t(util::Codec::Zlib),
+        int64_t(util::Codec::None),
+        int64_t(util::isSupported(util::Codec::Zstd) ? util::Codec::Zstd : util::Codec::None),
+    };
+    EXPECT_EQ(expected, databaseCompressedValues("test/fixtures/offline_database/offline.db", "tiles"));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CompressionDictionary)) {
+    using namespace mbgl;
+
+    if (!util::isSupported(util::Codec::Zstd)) {
+        return;
+    }
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    db.setCompression(util::Codec::Zstd);
+
+    auto tile = [] (uint32_t x) {
+        return Resource::tile("http://example.com/", 1.0, x, 0, 10, Tileset::Scheme::XYZ);
+    };
+
+    // Tiles that share most of their content, as vector tiles share layer and property names.
+    auto tileData = [] (uint32_t x) {
+        std::string data;
+        for (uint32_t i = 0; i < 32; i++) {
+            data += "layer=roads;class=street;name=" + util::toString((x * 31 + i * 17) % 1000) + ";";
+        }
+        return std::make_shared<std::string>(data);
+    };
+
+    Response response;
+    for (uint32_t x = 0; x < 500; x++) {
+        response.data = tileData(x);
+        db.put(tile(x), response);
+    }
+
+    EXPECT_TRUE(db.trainTileDictionary(500, 4096));
+    response.data = tileData(500);
+    db.put(tile(500), response);
+    db.put(Resource::style("http://example.com/style"), response);
+
+    auto result = db.get(tile(500));
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*tileData(500), *result->data);
+
+    result = db.get(Resource::style("http://example.com/style"));
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*tileData(500), *result->data);
+
+    // Tiles stored after training reference the dictionary; resources don't use it.
+    EXPECT_EQ(int64_t(util::Codec::Zstd) | (1 << 8),
+              databaseCompressedValues("test/fixtures/offline_database/offline.db", "tiles").back());
+    EXPECT_EQ(int64_t(util::Codec::Zstd),
+              databaseCompressedValues("test/fixtures/offline_database/offline.db", "resources").back());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(UnsupportedCodec)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+
+    Resource resource = Resource::style("http://example.com/style");
+    Response response;
+    response.data = std::make_shared<std::string>(1024, 'a');
+    db.put(resource, response);
+
+    {
+        // E.g. written by a newer version.
+        mapbox::sqlite::Database other("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadWrite);
+        other.exec("UPDATE resources SET compressed = 255");
+    }
+
+    // Data that can't be decompressed is treated as missing.
+    EXPECT_FALSE(bool(db.get(resource)));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(StoredSize)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    uint64_t storedSize;
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        EXPECT_EQ(0u, db.getStoredSize());
+
+        Response response;
+        response.data = randomString(1024);
+
+        const Resource style = Resource::style("http://example.com/style");
+        const uint64_t firstSize = db.put(style, response).second;
+        const uint64_t oneEntry = db.getStoredSize();
+        EXPECT_GT(oneEntry, firstSize);
+
+        // Replacing an entry counts the difference in size.
+        response.data = randomString(2048);
+        const uint64_t secondSize = db.put(style, response).second;
+        EXPECT_EQ(oneEntry + secondSize - firstSize, db.getStoredSize());
+
+        for (uint32_t i = 0; i < 10; i++) {
+            db.put(Resource::tile("http://example.com/", 1.0, i, 0, 4, Tileset::Scheme::XYZ), response);
+        }
+
+        storedSize = db.getStoredSize();
+    }
+
+    // The running total matches the size measured when the database is opened.
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    EXPECT_EQ(storedSize, db.getStoredSize());
+}
+
+TEST(OfflineDatabase, PutRecordsEvictionStats) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    const OfflineEvictionStats stats = db.getEvictionStats();
+    EXPECT_LT(0u, stats.evictingPuts);
+    EXPECT_LE(stats.maxPutEvictionTime, stats.putEvictionTime);
+    EXPECT_EQ(Duration::zero(), stats.incrementalEvictionTime);
+    EXPECT_LT(0u, stats.evictedEntries);
+    EXPECT_EQ(stats.evictedEntries * 1024, stats.evictedBytes);
+    EXPECT_LE(db.getStoredSize(), 1024u * 100);
+}
+
+TEST(OfflineDatabase, EvictIncrementally) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+    db.setIncrementalEviction(true);
+
+    Response response;
+    response.data = randomString(1024);
+
+    // Fills the cache beyond the target of incremental eviction, but not the maximum.
+    for (uint32_t i = 1; i <= 80; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+    EXPECT_EQ(0u, db.getEvictionStats().evictedEntries);
+
+    // A budget that has run out leaves the work for the next call.
+    EXPECT_TRUE(db.evictIncrementally(Duration::zero()));
+    EXPECT_EQ(0u, db.getEvictionStats().evictedEntries);
+
+    while (db.evictIncrementally(Milliseconds(10))) {
+    }
+
+    EXPECT_LE(db.getStoredSize(), 1024u * 100 - 1024 * 100 / 8);
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/80"))));
+
+    const OfflineEvictionStats stats = db.getEvictionStats();
+    EXPECT_EQ(0u, stats.evictingPuts);
+    EXPECT_LT(0u, stats.evictedEntries);
+    EXPECT_LT(Duration::zero(), stats.incrementalEvictionTime);
+}
+
+TEST(OfflineDatabase, EvictIncrementallyIgnoresRegions) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+    db.setIncrementalEviction(true);
+
+    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = randomString(1024);
+
+    // The region alone is beyond the target of incremental eviction.
+    for (uint32_t i = 1; i <= 85; i++) {
+        db.putRegionResource(region.getID(), Resource::style("http://example.com/region/"s + util::toString(i)), response);
+    }
+    for (uint32_t i = 1; i <= 3; i++) {
+        db.put(Resource::style("http://example.com/ambient/"s + util::toString(i)), response);
+    }
+
+    // The ambient cache is well within the target, so it is kept.
+    while (db.evictIncrementally(Milliseconds(10))) {
+    }
+
+    EXPECT_EQ(0u, db.getEvictionStats().evictedEntries);
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/ambient/1"))));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DeleteRegionEvictsIncrementally)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db", 0);
+    db.setIncrementalEviction(true);
+
+    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = randomString(1024);
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        db.putRegionResource(region.getID(), Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    const int pageCount = databasePageCount("test/fixtures/offline_database/offline.db");
+
+    // The resources the region used are left in place until the database is idle.
+    db.deleteRegion(std::move(region));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    while (db.evictIncrementally(Milliseconds(10))) {
+    }
+
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_EQ(0u, db.getStoredSize());
+    EXPECT_LT(databasePageCount("test/fixtures/offline_database/offline.db"), pageCount);
+}
+
+static int64_t databaseAccessed(const std::string& path, const char* table) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = db.prepare(("SELECT accessed FROM "s + table).c_str());
+    stmt.run();
+    return stmt.get<int64_t>(0);
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AccessBatching)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    db.setAccessBatching(Seconds(3600));
+
+    Resource resource = Resource::style("http://example.com/style");
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    db.put(resource, response);
+
+    auto resetAccessed = [] {
+        mapbox::sqlite::Database other("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadWrite);
+        other.exec("UPDATE resources SET accessed = 0");
+    };
+
+    // Misses aren't recorded.
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/missing"))));
+    EXPECT_FALSE(db.hasUnflushedAccesses());
+
+    // Hits are kept in memory.
+    resetAccessed();
+    EXPECT_TRUE(bool(db.get(resource)));
+    EXPECT_TRUE(db.hasUnflushedAccesses());
+    EXPECT_EQ(0, databaseAccessed("test/fixtures/offline_database/offline.db", "resources"));
+
+    // Until asked to write them.
+    db.flushAccesses();
+    EXPECT_FALSE(db.hasUnflushedAccesses());
+    EXPECT_LT(0, databaseAccessed("test/fixtures/offline_database/offline.db", "resources"));
+
+    // Or when they are older than the maximum delay.
+    resetAccessed();
+    EXPECT_TRUE(bool(db.get(resource)));
+    db.setAccessBatching(Duration::zero());
+    EXPECT_FALSE(db.hasUnflushedAccesses());
+    EXPECT_LT(0, databaseAccessed("test/fixtures/offline_database/offline.db", "resources"));
+
+    // Without batching, each hit is written at once.
+    resetAccessed();
+    EXPECT_TRUE(bool(db.get(resource)));
+    EXPECT_FALSE(db.hasUnflushedAccesses());
+    EXPECT_LT(0, databaseAccessed("test/fixtures/offline_database/offline.db", "resources"));
+}
+
+TEST(OfflineDatabase, RegionTileProgress) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "http://example.com/style", LatLngBounds::world(), 0, 1, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+    const int64_t regionID = region.getID();
+
+    EXPECT_FALSE(bool(db.getRegionTileProgress(regionID, "http://example.com/{z}/{x}/{y}")));
+
+    OfflineDatabase::TileProgress progress;
+    progress.tileCount = 5;
+    progress.completed = { 0x13 };
+    progress.completedSize = 1234;
+    db.putRegionTileProgress(regionID, "http://example.com/{z}/{x}/{y}", progress);
+
+    // Replaces the previous progress.
+    progress.completed = { 0x1F };
+    progress.completedSize = 2345;
+    db.putRegionTileProgress(regionID, "http://example.com/{z}/{x}/{y}", progress);
+
+    auto stored = db.getRegionTileProgress(regionID, "http://example.com/{z}/{x}/{y}");
+    ASSERT_TRUE(bool(stored));
+    EXPECT_EQ(5u, stored->tileCount);
+    EXPECT_EQ(std::vector<uint8_t>({ 0x1F }), stored->completed);
+    EXPECT_EQ(2345u, stored->completedSize);
+
+    EXPECT_FALSE(bool(db.getRegionTileProgress(regionID, "http://example.com/other/{z}/{x}/{y}")));
+
+    // Deleted along with the region.
+    db.deleteRegion(std::move(region));
+    EXPECT_FALSE(bool(db.getRegionTileProgress(regionID, "http://example.com/{z}/{x}/{y}")));
+}
+
+TEST(OfflineDatabase, AverageTileSizes) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    db.setCompression(util::Codec::None);
+    EXPECT_TRUE(db.getAverageTileSizes().empty());
+
+    auto putTile = [&] (int8_t z, int32_t x, optional<std::string> data) {
+        Resource resource = Resource::tile("http://example.com/{z}/{x}/{y}", 1, x, 0, z, Tileset::Scheme::XYZ);
+        Response response;
+        if (data) {
+            response.data = std::make_shared<std::string>(*data);
+        } else {
+            response.noContent = true;
+        }
+        db.put(resource, response);
+    };
+
+    putTile(0, 0, std::string(100, 'a'));
+    putTile(2, 0, std::string(300, 'a'));
+    putTile(2, 1, std::string(100, 'a'));
+    putTile(2, 2, {});
+
+    // Tiles without data count as empty.
+    EXPECT_EQ((std::map<uint8_t, uint64_t>{ { 0, 100 }, { 2, 133 } }), db.getAverageTileSizes());
 }
@@ -11,7 +11,10 @@
 #include <mbgl/util/string.hpp>
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
+#include <set>
+#include <tuple>
 
 using namespace mbgl;
 using namespace std::literals::string_literals;
@@ -616,3 +619,190 @@ TEST(OfflineDownload, Deactivate) {
 
     test.loop.run();
 }
+
+TEST(OfflineDownload, RequestsTilesByZoomThenHilbertOrder) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0),
+        test.db, fileSource);
+
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("inline_source.style.json"));
+    test.loop.runOnce();
+
+    std::vector<std::tuple<int, int, int>> tiles;
+    for (const auto& request : fileSource.requests) {
+        const Resource::TileData& tile = *request->resource.tileData;
+        tiles.emplace_back(tile.z, tile.x, tile.y);
+    }
+
+    EXPECT_EQ((std::vector<std::tuple<int, int, int>>{
+        std::make_tuple(0, 0, 0),
+        std::make_tuple(1, 0, 0),
+        std::make_tuple(1, 0, 1),
+        std::make_tuple(1, 1, 1),
+        std::make_tuple(1, 1, 0),
+    }), tiles);
+}
+
+TEST(OfflineDownload, LimitsRequestsPerHost) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0),
+        test.db, fileSource);
+    download.setConcurrency(4, 1);
+
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    Response styleResponse;
+    styleResponse.data = std::make_shared<std::string>(R"JSON({
+        "version": 8,
+        "sources": {
+            "a": { "type": "vector", "tiles": [ "http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf" ] },
+            "b": { "type": "vector", "tiles": [ "http://localhost:3000/{z}-{x}-{y}.vector.pbf" ] }
+        },
+        "layers": []
+    })JSON");
+    fileSource.respond(Resource::Kind::Style, styleResponse);
+    test.loop.runOnce();
+
+    auto hosts = [&] {
+        std::set<std::string> result;
+        for (const auto& request : fileSource.requests) {
+            result.insert(request->resource.url.substr(0, request->resource.url.find('/', 7)));
+        }
+        return result;
+    };
+
+    // One request to each host, although the window allows more.
+    EXPECT_EQ(2u, fileSource.requests.size());
+    EXPECT_EQ((std::set<std::string>{ "http://127.0.0.1:3000", "http://localhost:3000" }), hosts());
+
+    // A completed request makes room for the next one to the same host.
+    fileSource.respond(Resource::Kind::Tile, test.response("0-0-0.vector.pbf"));
+    test.loop.runOnce();
+
+    EXPECT_EQ(2u, fileSource.requests.size());
+    EXPECT_EQ((std::set<std::string>{ "http://127.0.0.1:3000", "http://localhost:3000" }), hosts());
+}
+
+TEST(OfflineDownload, SpreadsTilesOverAlternateHosts) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0),
+        test.db, fileSource);
+    download.setConcurrency(4, 1);
+
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    Response styleResponse;
+    styleResponse.data = std::make_shared<std::string>(R"JSON({
+        "version": 8,
+        "sources": {
+            "a": { "type": "vector", "tiles": [
+                "http://a.example.com/{z}-{x}-{y}.vector.pbf",
+                "http://b.example.com/{z}-{x}-{y}.vector.pbf"
+            ] }
+        },
+        "layers": []
+    })JSON");
+    fileSource.respond(Resource::Kind::Style, styleResponse);
+    test.loop.runOnce();
+
+    // One request to each host of the tileset, each for a tile keyed by the first template.
+    std::set<std::string> hosts;
+    for (const auto& request : fileSource.requests) {
+        hosts.insert(request->resource.url.substr(0, request->resource.url.find('/', 7)));
+        EXPECT_EQ("http://a.example.com/{z}-{x}-{y}.vector.pbf", request->resource.tileData->urlTemplate);
+    }
+    EXPECT_EQ(2u, fileSource.requests.size());
+    EXPECT_EQ((std::set<std::string>{ "http://a.example.com", "http://b.example.com" }), hosts);
+
+    // A tile fetched from the second host is found under the first template.
+    auto it = std::find_if(fileSource.requests.begin(), fileSource.requests.end(), [] (const auto& request) {
+        return request->resource.url.find("http://b.example.com/") == 0;
+    });
+    ASSERT_NE(fileSource.requests.end(), it);
+    const Resource::TileData tile = *(*it)->resource.tileData;
+    Response tileResponse = test.response("0-0-0.vector.pbf");
+    auto callback = (*it)->callback;
+    callback(tileResponse);
+
+    EXPECT_TRUE(bool(test.db.get(Resource::tile("http://a.example.com/{z}-{x}-{y}.vector.pbf", 1.0,
+                                                tile.x, tile.y, tile.z, Tileset::Scheme::XYZ))));
+}
+
+TEST(OfflineDownload, ResumeSkipsCompletedTiles) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineTilePyramidRegionDefinition definition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0);
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("inline_source.style.json");
+    };
+
+    std::size_t tileRequests = 0;
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        tileRequests++;
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    OfflineRegionStatus completed;
+
+    {
+        OfflineDownload download(region.getID(), OfflineTilePyramidRegionDefinition(definition), test.db, test.fileSource);
+
+        auto observer = std::make_unique<MockObserver>();
+        observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+            if (status.complete()) {
+                completed = status;
+                test.loop.stop();
+            }
+        };
+
+        download.setObserver(std::move(observer));
+        download.setState(OfflineRegionDownloadState::Active);
+        test.loop.run();
+        download.setState(OfflineRegionDownloadState::Inactive);
+    }
+
+    EXPECT_EQ(5u, tileRequests);
+    EXPECT_EQ(5u, completed.completedTileCount);
+
+    // Another download of the region neither requests nor looks up the tiles again.
+    tileRequests = 0;
+    test.fileSource.tileResponse = [&] (const Resource&) -> optional<Response> {
+        ADD_FAILURE() << "unexpected tile request";
+        return {};
+    };
+
+    OfflineDownload redownload(region.getID(), OfflineTilePyramidRegionDefinition(definition), test.db, test.fileSource);
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete()) {
+            EXPECT_EQ(completed.completedResourceCount, status.completedResourceCount);
+            EXPECT_EQ(completed.completedTileCount, status.completedTileCount);
+            EXPECT_EQ(completed.completedTileSize, status.completedTileSize);
+            EXPECT_EQ(completed.requiredResourceCount, status.requiredResourceCount);
+            test.loop.stop();
+        }
+    };
+
+    redownload.setObserver(std::move(observer));
+    redownload.setState(OfflineRegionDownloadState::Active);
+    test.loop.run();
+}
@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -413,4 +414,192 @@ TEST(OnlineFileSource, ChangeAPIBaseURL){
     const std::string customURL = "test.domain";
     fs.setAPIBaseURL(customURL);
     EXPECT_EQ(customURL, fs.getAPIBaseURL());
-}
\ No newline at end of file
+}
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Coalesce)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/delayed" };
+    int responses = 0;
+
+    std::unique_ptr<AsyncRequest> reqs[3];
+    for (auto& req : reqs) {
+        req = fs.request(resource, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ("Response", *res.data);
+            if (++responses == 3) {
+                loop.stop();
+            }
+        });
+    }
+
+    loop.run();
+
+    EXPECT_EQ(1u, fs.getRequestStats().networkRequests);
+    EXPECT_EQ(2u, fs.getRequestStats().coalescedRequests);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(CoalesceCancel)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/delayed" };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource, [&](Response) {
+        ADD_FAILURE() << "Callback should not be called";
+    });
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, [&](Response res) {
+        req2.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Response", *res.data);
+        loop.stop();
+    });
+
+    // Cancelling one of the requests while the response is on its way doesn't cancel the
+    // network request the other one waits for.
+    util::Timer timer;
+    timer.start(Milliseconds(50), Duration::zero(), [&] {
+        req1.reset();
+    });
+
+    loop.run();
+
+    EXPECT_EQ(1u, fs.getRequestStats().networkRequests);
+    EXPECT_EQ(1u, fs.getRequestStats().coalescedRequests);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(CoalesceOnlyIdenticalRequests)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // A request revalidating a prior response gets a different response.
+    Resource revalidation { Resource::Unknown, "http://127.0.0.1:3000/revalidate-etag" };
+    revalidation.priorEtag = std::string("snowfall");
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/revalidate-etag" };
+    int responses = 0;
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(revalidation, [&](Response) {
+        req1.reset();
+        if (++responses == 2) {
+            loop.stop();
+        }
+    });
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource, [&](Response) {
+        req2.reset();
+        if (++responses == 2) {
+            loop.stop();
+        }
+    });
+
+    loop.run();
+
+    EXPECT_EQ(2u, fs.getRequestStats().networkRequests);
+    EXPECT_EQ(0u, fs.getRequestStats().coalescedRequests);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Priorities)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // Take up all the room for network requests, with one request that completes quickly
+    // and others that take a while.
+    std::vector<std::unique_ptr<AsyncRequest>> fills;
+    fills.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/test" }, [&](Response) {}));
+    for (uint32_t i = 1; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        fills.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed?" + std::to_string(i) },
+                                   [&](Response) {}));
+    }
+
+    std::vector<std::string> responses;
+
+    // Queued first, but of low priority, so the glyphs queued after it take the first room.
+    Resource low { Resource::Tile, "http://127.0.0.1:3000/delayed?low" };
+    low.priority = Resource::Priority::Low;
+    std::unique_ptr<AsyncRequest> lowRequest = fs.request(low, [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        responses.push_back("low");
+        loop.stop();
+    });
+
+    std::unique_ptr<AsyncRequest> glyphsRequest =
+        fs.request({ Resource::Glyphs, "http://127.0.0.1:3000/test?glyphs" }, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            responses.push_back("glyphs");
+        });
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string>{ "glyphs", "low" }), responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(SetPriority)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    std::vector<std::unique_ptr<AsyncRequest>> fills;
+    fills.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/test" }, [&](Response) {}));
+    for (uint32_t i = 1; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        fills.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed?" + std::to_string(i) },
+                                   [&](Response) {}));
+    }
+
+    std::vector<std::string> responses;
+
+    // A prefetched tile becomes visible while it waits, and a visible tile goes out of view.
+    Resource prefetch { Resource::Tile, "http://127.0.0.1:3000/test?prefetch" };
+    prefetch.priority = Resource::Priority::Prefetch;
+    std::unique_ptr<AsyncRequest> prefetchRequest = fs.request(prefetch, [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        responses.push_back("prefetch");
+    });
+
+    std::unique_ptr<AsyncRequest> visibleRequest =
+        fs.request({ Resource::Tile, "http://127.0.0.1:3000/test?visible" }, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            responses.push_back("visible");
+            loop.stop();
+        });
+
+    fs.setPriority(*prefetchRequest, Resource::Priority::Regular);
+    fs.setPriority(*visibleRequest, Resource::Priority::Prefetch);
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string>{ "prefetch", "visible" }), responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(QueuedRequestsJoinIdenticalRequest)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    std::vector<std::unique_ptr<AsyncRequest>> fills;
+    for (uint32_t i = 0; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        fills.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed?" + std::to_string(i) },
+                                   [&](Response) {}));
+    }
+
+    int responses = 0;
+
+    // A queued low priority request is made along with an identical one of regular priority.
+    Resource low { Resource::Tile, "http://127.0.0.1:3000/test" };
+    low.priority = Resource::Priority::Low;
+    std::unique_ptr<AsyncRequest> lowRequest = fs.request(low, [&](Response) {
+        if (++responses == 2) {
+            loop.stop();
+        }
+    });
+
+    std::unique_ptr<AsyncRequest> regularRequest =
+        fs.request({ Resource::Tile, "http://127.0.0.1:3000/test" }, [&](Response) {
+            if (++responses == 2) {
+                loop.stop();
+            }
+        });
+
+    loop.run();
+
+    EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests() + 1, fs.getRequestStats().networkRequests);
+    EXPECT_EQ(1u, fs.getRequestStats().coalescedRequests);
+}
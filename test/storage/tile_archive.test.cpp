@@ -0,0 +1,95 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::string tileData(const TileArchive& archive, uint8_t z, uint32_t x, uint32_t y) {
+    auto data = archive.get(z, x, y);
+    return data ? std::string(data->data, data->size) : "<missing>";
+}
+
+} // namespace
+
+TEST(TileArchive, TEST_REQUIRES_WRITE(Write)) {
+    TileArchive::write("test/fixtures/tile_archive/written.archive", {
+        { 2, 3, 1, "two" },
+        { 0, 0, 0, "zero" },
+        { 2, 1, 3, util::compress("compressed") },
+        { 1, 0, 1, "" },
+    });
+
+    TileArchive archive("test/fixtures/tile_archive/written.archive");
+    EXPECT_EQ(4u, archive.tileCount());
+    EXPECT_EQ("zero", tileData(archive, 0, 0, 0));
+    EXPECT_EQ("two", tileData(archive, 2, 3, 1));
+    EXPECT_EQ("", tileData(archive, 1, 0, 1));
+
+    // Only gzip data is decompressed, as MBTiles stores vector tiles gzipped.
+    EXPECT_EQ(util::compress("compressed"), tileData(archive, 2, 1, 3));
+
+    EXPECT_EQ("<missing>", tileData(archive, 2, 1, 3 + 4));
+    EXPECT_EQ("<missing>", tileData(archive, 2, 3, 2));
+    EXPECT_EQ("<missing>", tileData(archive, 1, 0, 0));
+    EXPECT_EQ("<missing>", tileData(archive, 30, 0, 0));
+}
+
+TEST(TileArchive, TEST_REQUIRES_WRITE(ImportMBTiles)) {
+    // tiles.mbtiles holds a gzipped tile at z0, and two uncompressed ones at z1.
+    EXPECT_EQ(3u, TileArchive::importMBTiles("test/fixtures/tile_archive/tiles.mbtiles",
+                                             "test/fixtures/tile_archive/imported.archive"));
+
+    TileArchive archive("test/fixtures/tile_archive/imported.archive");
+    EXPECT_EQ(3u, archive.tileCount());
+    EXPECT_EQ("zero", tileData(archive, 0, 0, 0));
+
+    // MBTiles rows are flipped.
+    EXPECT_EQ("one-one-top", tileData(archive, 1, 1, 0));
+    EXPECT_EQ("one-one-bottom", tileData(archive, 1, 1, 1));
+}
+
+TEST(TileArchive, Invalid) {
+    EXPECT_THROW(TileArchive("test/fixtures/tile_archive/missing.archive"), util::IOException);
+    EXPECT_THROW(TileArchive("test/fixtures/tile_archive/tiles.mbtiles"), std::runtime_error);
+}
+
+TEST(TileArchiveFileSource, TEST_REQUIRES_WRITE(Request)) {
+    util::RunLoop loop;
+
+    TileArchive::write("test/fixtures/tile_archive/source.archive", {
+        { 0, 0, 0, "zero" },
+    });
+
+    TileArchiveFileSource fs;
+    fs.addArchive("http://example.com/{z}/{x}/{y}.pbf", "test/fixtures/tile_archive/source.archive");
+
+    const Resource archived = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Resource missing = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 1, 0, 1, Tileset::Scheme::XYZ);
+    EXPECT_TRUE(fs.accepts(archived));
+    EXPECT_FALSE(fs.accepts(Resource::tile("http://example.com/other/{z}/{x}/{y}.pbf", 1.0, 0, 0, 0, Tileset::Scheme::XYZ)));
+    EXPECT_FALSE(fs.accepts(Resource::style("http://example.com/{z}/{x}/{y}.pbf")));
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    req1 = fs.request(archived, [&](Response res) {
+        req1.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("zero", *res.data);
+
+        req2 = fs.request(missing, [&](Response res2) {
+            req2.reset();
+            ASSERT_TRUE(res2.error.get());
+            EXPECT_EQ(Response::Error::Reason::NotFound, res2.error->reason);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
@@ -0,0 +1,151 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+Filter parse(const char * expression) {
+    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
+    doc.Parse<0>(expression);
+    return *conversion::convert<Filter>(doc);
+}
+
+std::vector<Feature> features() {
+    const std::vector<PropertyMap> properties = {
+        {},
+        { { "foo", std::string("bar") } },
+        { { "foo", std::string("baz") } },
+        { { "foo", std::string("0") } },
+        { { "foo", int64_t(0) } },
+        { { "foo", int64_t(1) } },
+        { { "foo", int64_t(-3) } },
+        { { "foo", uint64_t(0) } },
+        { { "foo", uint64_t(5) } },
+        { { "foo", double(0) } },
+        { { "foo", double(1.5) } },
+        { { "foo", double(5) } },
+        { { "foo", false } },
+        { { "foo", true } },
+        { { "foo", nullptr } },
+        { { "foo", int64_t(1) }, { "bar", std::string("baz") } },
+        { { "foo", int64_t(4) }, { "bar", false } },
+    };
+
+    const std::vector<Geometry<double>> geometries = {
+        Point<double>(),
+        LineString<double>(),
+        Polygon<double>(),
+    };
+
+    const std::vector<optional<FeatureIdentifier>> identifiers = {
+        {},
+        FeatureIdentifier(uint64_t(1)),
+        FeatureIdentifier(std::string("one")),
+    };
+
+    std::vector<Feature> result;
+    for (const auto& properties_ : properties) {
+        for (const auto& geometry : geometries) {
+            for (const auto& identifier : identifiers) {
+                Feature feature { geometry };
+                feature.properties = properties_;
+                feature.id = identifier;
+                result.push_back(std::move(feature));
+            }
+        }
+    }
+    return result;
+}
+
+// Checks that the compiled filter agrees with `FilterEvaluator` on a variety of features.
+void expectSameResults(const char * expression) {
+    const Filter filter = parse(expression);
+    const CompiledFilter compiled(filter);
+
+    for (const auto& feature : features()) {
+        ASSERT_EQ(filter(feature), compiled(feature)) << expression;
+    }
+}
+
+} // namespace
+
+TEST(CompiledFilter, Equals) {
+    expectSameResults(R"(["==", "foo", "bar"])");
+    expectSameResults(R"(["==", "foo", 0])");
+    expectSameResults(R"(["==", "foo", 1.5])");
+    expectSameResults(R"(["==", "foo", true])");
+    expectSameResults(R"(["!=", "foo", "bar"])");
+    expectSameResults(R"(["!=", "foo", 0])");
+    expectSameResults(R"(["!=", "foo", false])");
+}
+
+TEST(CompiledFilter, Comparison) {
+    expectSameResults(R"(["<", "foo", 1])");
+    expectSameResults(R"(["<=", "foo", 0])");
+    expectSameResults(R"([">", "foo", -1])");
+    expectSameResults(R"([">=", "foo", 1.5])");
+    expectSameResults(R"(["<", "foo", "baz"])");
+    expectSameResults(R"([">=", "foo", "bar"])");
+    expectSameResults(R"(["<", "foo", true])");
+    expectSameResults(R"([">", "foo", false])");
+}
+
+TEST(CompiledFilter, NumberRange) {
+    expectSameResults(R"(["all", [">=", "foo", 0], ["<", "foo", 5]])");
+    expectSameResults(R"(["all", [">", "foo", 0], [">=", "foo", 0], ["<=", "foo", 5], ["<", "foo", 5]])");
+    expectSameResults(R"(["all", [">", "foo", 4], ["<", "foo", 1]])");
+    expectSameResults(R"(["all", [">", "foo", 0], ["==", "bar", "baz"], ["<", "bar", "z"]])");
+}
+
+TEST(CompiledFilter, In) {
+    expectSameResults(R"(["in", "foo", "bar", "baz"])");
+    expectSameResults(R"(["in", "foo", 0, 5, "bar"])");
+    expectSameResults(R"(["in", "foo", 1.5, true])");
+    expectSameResults(R"(["!in", "foo", "bar", 0])");
+    expectSameResults(R"(["!in", "foo", false])");
+    expectSameResults(R"(["in", "foo"])");
+    expectSameResults(R"(["!in", "foo"])");
+}
+
+TEST(CompiledFilter, Has) {
+    expectSameResults(R"(["has", "foo"])");
+    expectSameResults(R"(["!has", "foo"])");
+    expectSameResults(R"(["has", "$id"])");
+    expectSameResults(R"(["!has", "$type"])");
+}
+
+TEST(CompiledFilter, Type) {
+    expectSameResults(R"(["==", "$type", "LineString"])");
+    expectSameResults(R"(["!=", "$type", "Point"])");
+    expectSameResults(R"(["in", "$type", "LineString", "Polygon"])");
+    expectSameResults(R"(["!in", "$type", "Polygon"])");
+    expectSameResults(R"([">", "$type", "Point"])");
+}
+
+TEST(CompiledFilter, ID) {
+    expectSameResults(R"(["==", "$id", 1])");
+    expectSameResults(R"(["==", "$id", "one"])");
+    expectSameResults(R"(["in", "$id", 1, "two"])");
+    expectSameResults(R"(["<", "$id", 2])");
+}
+
+TEST(CompiledFilter, Compound) {
+    expectSameResults(R"(["any", ["==", "foo", "bar"], ["==", "$type", "Polygon"]])");
+    expectSameResults(R"(["none", ["has", "bar"], ["<", "foo", 1]])");
+    expectSameResults(R"(["all", ["any", ["==", "foo", 0], ["!has", "foo"]], ["!=", "$type", "Point"]])");
+    expectSameResults(R"(["any"])");
+    expectSameResults(R"(["all"])");
+    expectSameResults(R"(["none"])");
+}
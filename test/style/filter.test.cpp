@@ -123,3 +123,15 @@ TEST(Filter, ID) {
 
     ASSERT_FALSE(parse("[\"==\", \"$id\", 1234]")(feature2));
 }
+
+TEST(Filter, Equality) {
+    EXPECT_TRUE(parse(R"(["==", "foo", "bar"])") == parse(R"(["==", "foo", "bar"])"));
+    EXPECT_FALSE(parse(R"(["==", "foo", "bar"])") == parse(R"(["==", "foo", "baz"])"));
+    EXPECT_FALSE(parse(R"(["==", "foo", "bar"])") == parse(R"(["!=", "foo", "bar"])"));
+    EXPECT_TRUE(parse(R"(["in", "foo", 1, 2])") == parse(R"(["in", "foo", 1, 2])"));
+    EXPECT_FALSE(parse(R"(["in", "foo", 1, 2])") == parse(R"(["in", "foo", 1])"));
+    EXPECT_TRUE(parse(R"(["all", ["has", "foo"], ["<", "bar", 3]])") == parse(R"(["all", ["has", "foo"], ["<", "bar", 3]])"));
+    EXPECT_FALSE(parse(R"(["all", ["has", "foo"], ["<", "bar", 3]])") == parse(R"(["any", ["has", "foo"], ["<", "bar", 3]])"));
+    EXPECT_FALSE(parse(R"(["all", ["has", "foo"]])") == parse(R"(["all", ["!has", "foo"]])"));
+    EXPECT_TRUE(Filter() == Filter());
+}
@@ -0,0 +1,83 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/tile_layer_filter.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <rapidjson/document.h>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+Filter parse(const char * expression) {
+    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> doc;
+    doc.Parse<0>(expression);
+    return *conversion::convert<Filter>(doc);
+}
+
+// Checks that binding the filter to each layer of the fixture tile gives the same result
+// as evaluating it feature by feature.
+void expectSameResults(const char * expression) {
+    const Filter filter = parse(expression);
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf")));
+
+    for (const auto& name : { "admin", "water" }) {
+        const GeometryTileLayer* layer = data.getLayer(name);
+        ASSERT_TRUE(layer);
+
+        TileLayerFilter layerFilter(filter, *layer);
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            const bool expected = filter(feature->getType(), feature->getID(), [&] (const std::string& key) {
+                return feature->getValue(key);
+            });
+            ASSERT_EQ(expected, layerFilter(i, *feature)) << expression << " " << name << " " << i;
+        }
+    }
+}
+
+} // namespace
+
+TEST(TileLayerFilter, Comparison) {
+    expectSameResults(R"(["==", "admin_level", 2])");
+    expectSameResults(R"(["!=", "admin_level", 2])");
+    expectSameResults(R"(["<", "admin_level", 3])");
+    expectSameResults(R"(["<=", "admin_level", 2])");
+    expectSameResults(R"([">", "admin_level", 2])");
+    expectSameResults(R"([">=", "admin_level", 4.0])");
+    expectSameResults(R"(["==", "admin_level", "2"])");
+}
+
+TEST(TileLayerFilter, Membership) {
+    expectSameResults(R"(["in", "admin_level", 2, 4])");
+    expectSameResults(R"(["!in", "maritime", 1])");
+    expectSameResults(R"(["has", "osm_id"])");
+    expectSameResults(R"(["!has", "maritime"])");
+}
+
+TEST(TileLayerFilter, MissingKey) {
+    expectSameResults(R"(["==", "missing", "x"])");
+    expectSameResults(R"(["!=", "missing", "x"])");
+    expectSameResults(R"(["!in", "missing", "x"])");
+}
+
+TEST(TileLayerFilter, Feature) {
+    expectSameResults(R"(["==", "$type", "LineString"])");
+    expectSameResults(R"(["in", "$type", "Point", "Polygon"])");
+    expectSameResults(R"(["has", "$id"])");
+}
+
+TEST(TileLayerFilter, Compound) {
+    expectSameResults(R"(["all", ["==", "$type", "LineString"], ["!=", "disputed", 1]])");
+    expectSameResults(R"(["any", ["has", "osm_id"], ["==", "maritime", 1]])");
+    expectSameResults(R"(["none", [">", "admin_level", 2], ["==", "maritime", 1]])");
+    expectSameResults(R"(["all"])");
+    expectSameResults(R"(["any"])");
+}
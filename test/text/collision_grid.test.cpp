@@ -0,0 +1,69 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+typedef bgi::rtree<std::pair<Box, uint32_t>, bgi::linear<16, 4>> IndexTree;
+
+} // namespace
+
+// Placement now relies on the grid alone, so it must find exactly the boxes that the R-tree it
+// replaces finds, including boxes beyond the extent of the grid.
+TEST(CollisionGrid, MatchesRTree) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coord(-3.0f * util::EXTENT, 3.0f * util::EXTENT);
+    std::uniform_real_distribution<float> extent(0.0f, 512.0f);
+    std::uniform_real_distribution<float> largeExtent(0.0f, 8.0f * util::EXTENT);
+
+    auto randomBox = [&] (std::size_t i) {
+        const float minX = coord(random);
+        const float minY = coord(random);
+        // Every so often, a box spans many cells.
+        const float width = i % 50 == 0 ? largeExtent(random) : extent(random);
+        const float height = i % 50 == 0 ? largeExtent(random) : extent(random);
+        return Box { CollisionPoint { minX, minY }, CollisionPoint { minX + width, minY + height } };
+    };
+
+    CollisionGrid grid;
+    IndexTree tree;
+
+    const IndexedSubfeature feature { 0, "", "", 0 };
+    std::vector<uint32_t> gridResult;
+    std::vector<uint32_t> treeResult;
+
+    // Queries are interleaved with inserts, as during placement.
+    for (std::size_t i = 0; i < 2000; i++) {
+        const Box query = randomBox(i);
+
+        gridResult.clear();
+        grid.query(query.min_corner().get<0>(), query.min_corner().get<1>(),
+                   query.max_corner().get<0>(), query.max_corner().get<1>(), gridResult);
+
+        treeResult.clear();
+        for (auto it = tree.qbegin(bgi::intersects(query)); it != tree.qend(); ++it) {
+            treeResult.push_back(it->second);
+        }
+
+        std::sort(gridResult.begin(), gridResult.end());
+        std::sort(treeResult.begin(), treeResult.end());
+        ASSERT_EQ(treeResult, gridResult) << "query " << i;
+
+        const Box box = randomBox(i + 1);
+        const Point<float> anchor { box.min_corner().get<0>(), box.min_corner().get<1>() };
+        grid.insert(box.min_corner().get<0>(), box.min_corner().get<1>(),
+                    box.max_corner().get<0>(), box.max_corner().get<1>(),
+                    anchor, CollisionBox(anchor, 0, 0, 0, 0, 1), feature);
+        tree.insert(std::make_pair(box, static_cast<uint32_t>(i)));
+    }
+
+    EXPECT_EQ(tree.size(), grid.size());
+}
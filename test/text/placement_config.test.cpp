@@ -0,0 +1,24 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/placement_config.hpp>
+
+using namespace mbgl;
+
+TEST(PlacementConfig, Quantized) {
+    const float degree = M_PI / 180;
+
+    EXPECT_EQ(PlacementConfig(0, 0), PlacementConfig(0, 0).quantized());
+    EXPECT_EQ(PlacementConfig(0, 0), PlacementConfig(0.9 * degree, 0.4 * degree).quantized());
+    EXPECT_EQ(PlacementConfig(PlacementConfig::angleStep, PlacementConfig::pitchStep),
+              PlacementConfig(1.1 * degree, 0.6 * degree).quantized());
+
+    // Angles are normalized, so both directions of rotation quantize alike.
+    EXPECT_EQ(PlacementConfig(0, 0), PlacementConfig(-0.5 * degree, 0).quantized());
+    EXPECT_EQ(PlacementConfig(0, 0), PlacementConfig(2 * M_PI, 0).quantized());
+    EXPECT_EQ(PlacementConfig(-90 * degree, 0).quantized(), PlacementConfig(270 * degree, 0).quantized());
+
+    EXPECT_TRUE(PlacementConfig(0, 0, true).quantized().debug);
+
+    // Nearby configurations share a quantized configuration.
+    EXPECT_EQ(PlacementConfig(45.9 * degree, 30.1 * degree).quantized(),
+              PlacementConfig(46.1 * degree, 29.9 * degree).quantized());
+}
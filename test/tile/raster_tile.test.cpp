@@ -2,6 +2,7 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/renderer/raster_bucket.hpp>
 
 #include <mbgl/actor/thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -9,6 +10,10 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/util/image_pool.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 using namespace mbgl;
 
@@ -47,3 +52,38 @@ TEST(RasterTile, onError) {
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
+
+TEST(RasterBucket, PackOpaque) {
+    PremultipliedImage image { 2, 1 };
+    const uint8_t pixels[] = { 255, 0, 0, 255, 0, 128, 255, 255 };
+    std::copy(pixels, pixels + sizeof(pixels), image.data.get());
+
+    RasterBucket bucket(std::move(image), nullptr, gl::TextureFormat::RGB565);
+    EXPECT_EQ(gl::TextureFormat::RGB565, bucket.getFormat());
+    EXPECT_EQ(0u, bucket.getTextureByteSize());
+
+    uint16_t packed[2];
+    std::memcpy(packed, bucket.getImageData(), sizeof(packed));
+    EXPECT_EQ(0xF800, packed[0]);
+    EXPECT_EQ(0x041F, packed[1]);
+}
+
+TEST(RasterBucket, KeepTransparent) {
+    PremultipliedImage image { 2, 1 };
+    const uint8_t pixels[] = { 255, 0, 0, 255, 0, 64, 128, 128 };
+    std::copy(pixels, pixels + sizeof(pixels), image.data.get());
+
+    RasterBucket bucket(std::move(image), nullptr, gl::TextureFormat::RGB565);
+    EXPECT_EQ(gl::TextureFormat::RGBA, bucket.getFormat());
+    EXPECT_EQ(8u, bucket.getImageByteSize());
+}
+
+TEST(RasterBucket, ReleaseToPool) {
+    auto pool = std::make_shared<util::ImagePool>(1024);
+    {
+        RasterBucket bucket(pool->acquire(4, 4), pool);
+        EXPECT_EQ(64u, bucket.getImageByteSize());
+        EXPECT_EQ(0u, pool->getBytes());
+    }
+    EXPECT_EQ(64u, pool->getBytes());
+}
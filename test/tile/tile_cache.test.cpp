@@ -0,0 +1,110 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, std::size_t byteSize_)
+        : Tile(id_), byteSize(byteSize_) {
+        availableData = DataAvailability::All;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    Bucket* getBucket(const style::Layer&) override { return nullptr; }
+    std::size_t getByteSize() const override { return byteSize; }
+
+private:
+    const std::size_t byteSize;
+};
+
+std::unique_ptr<Tile> tile(uint8_t z, uint32_t x, std::size_t byteSize = 100) {
+    return std::make_unique<StubTile>(OverscaledTileID(z, x, 0), byteSize);
+}
+
+} // namespace
+
+TEST(TileCache, Size) {
+    TileCache cache;
+    cache.setSize("a", 2);
+
+    cache.add("a", OverscaledTileID(1, 0, 0), tile(1, 0));
+    cache.add("a", OverscaledTileID(1, 1, 0), tile(1, 1));
+    cache.add("a", OverscaledTileID(1, 0, 1), tile(1, 0));
+
+    EXPECT_FALSE(cache.has("a", OverscaledTileID(1, 0, 0)));
+    EXPECT_TRUE(cache.has("a", OverscaledTileID(1, 1, 0)));
+    EXPECT_TRUE(cache.has("a", OverscaledTileID(1, 0, 1)));
+    EXPECT_EQ(200u, cache.getBytes("a"));
+
+    // Sources without a size don't cache tiles.
+    cache.add("b", OverscaledTileID(1, 0, 0), tile(1, 0));
+    EXPECT_FALSE(cache.has("b", OverscaledTileID(1, 0, 0)));
+}
+
+TEST(TileCache, Get) {
+    TileCache cache;
+    cache.setSize("a", 2);
+
+    cache.add("a", OverscaledTileID(1, 0, 0), tile(1, 0));
+    EXPECT_EQ(nullptr, cache.get("b", OverscaledTileID(1, 0, 0)));
+    EXPECT_EQ(nullptr, cache.get("a", OverscaledTileID(1, 1, 0)));
+
+    auto result = cache.get("a", OverscaledTileID(1, 0, 0));
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(OverscaledTileID(1, 0, 0), result->id);
+    EXPECT_FALSE(cache.has("a", OverscaledTileID(1, 0, 0)));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, MemoryBudget) {
+    TileCache cache(250);
+    cache.setSize("a", 10);
+    cache.setSize("b", 10);
+
+    cache.add("a", OverscaledTileID(1, 0, 0), tile(1, 0, 100));
+    cache.add("b", OverscaledTileID(1, 0, 0), tile(1, 0, 100));
+    cache.get("a", OverscaledTileID(1, 0, 0));
+    cache.add("a", OverscaledTileID(1, 0, 0), tile(1, 0, 100));
+
+    // Exceeds the budget; the least recently used tile of any source is evicted.
+    cache.add("a", OverscaledTileID(1, 1, 0), tile(1, 1, 50));
+
+    EXPECT_FALSE(cache.has("b", OverscaledTileID(1, 0, 0)));
+    EXPECT_TRUE(cache.has("a", OverscaledTileID(1, 0, 0)));
+    EXPECT_TRUE(cache.has("a", OverscaledTileID(1, 1, 0)));
+    EXPECT_EQ(150u, cache.getBytes());
+
+    auto usage = cache.getBytesPerSource();
+    EXPECT_EQ(150u, usage["a"]);
+    EXPECT_EQ(0u, usage["b"]);
+
+    cache.setMaxBytes(60);
+    EXPECT_FALSE(cache.has("a", OverscaledTileID(1, 0, 0)));
+    EXPECT_TRUE(cache.has("a", OverscaledTileID(1, 1, 0)));
+    EXPECT_EQ(50u, cache.getBytes());
+}
+
+TEST(TileCache, Clear) {
+    TileCache cache;
+    cache.setSize("a", 2);
+    cache.setSize("b", 2);
+
+    cache.add("a", OverscaledTileID(1, 0, 0), tile(1, 0));
+    cache.add("b", OverscaledTileID(1, 0, 0), tile(1, 0));
+
+    cache.clear("a");
+    EXPECT_FALSE(cache.has("a", OverscaledTileID(1, 0, 0)));
+    EXPECT_TRUE(cache.has("b", OverscaledTileID(1, 0, 0)));
+    EXPECT_EQ(2u, cache.getSize("a"));
+
+    cache.setSize("b", 0);
+    EXPECT_FALSE(cache.has("b", OverscaledTileID(1, 0, 0)));
+    EXPECT_EQ(0u, cache.getBytes());
+    EXPECT_EQ(0u, cache.getBytesPerSource().count("b"));
+}
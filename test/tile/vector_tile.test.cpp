@@ -1,13 +1,20 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/tile_observer.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/text/collision_tile.hpp>
 
 #include <mbgl/actor/thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 
 using namespace mbgl;
@@ -47,3 +54,184 @@ TEST(VectorTile, onError) {
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
+
+TEST(VectorTile, Columns) {
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf")));
+
+    const GeometryTileLayer* layer = data.getLayer("admin");
+    ASSERT_TRUE(layer);
+
+    const GeometryTileColumns* columns = layer->getColumns();
+    ASSERT_TRUE(columns);
+    EXPECT_FALSE(columns->getKeyIndex("missing"));
+
+    optional<uint32_t> keyIndex = columns->getKeyIndex("admin_level");
+    ASSERT_TRUE(keyIndex);
+
+    const std::vector<uint32_t>& column = columns->getColumn(*keyIndex);
+    ASSERT_EQ(layer->featureCount(), column.size());
+
+    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+        optional<Value> value = layer->getFeature(i)->getValue("admin_level");
+        if (column[i] == GeometryTileColumns::noValue) {
+            EXPECT_FALSE(value);
+        } else {
+            ASSERT_TRUE(value);
+            EXPECT_EQ(*value, columns->getValues().at(column[i]));
+        }
+    }
+}
+
+TEST(VectorTile, RequestPriority) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    tile.setNecessity(Tile::Necessity::Required);
+    ASSERT_EQ(1u, test.fileSource.requests.size());
+    EXPECT_EQ(Resource::Priority::Regular, test.fileSource.requests.front()->resource.priority);
+
+    tile.setPriority(Tile::Priority::VisibleFallback);
+    EXPECT_EQ(Resource::Priority::Fallback, test.fileSource.requests.front()->resource.priority);
+
+    tile.setPriority(Tile::Priority::Prefetch);
+    EXPECT_EQ(Resource::Priority::Prefetch, test.fileSource.requests.front()->resource.priority);
+
+    // A tile that is no longer needed cancels its request.
+    tile.setNecessity(Tile::Necessity::Optional);
+    EXPECT_TRUE(test.fileSource.requests.empty());
+
+    // The next request is made with the current priority.
+    tile.setNecessity(Tile::Necessity::Required);
+    ASSERT_EQ(1u, test.fileSource.requests.size());
+    EXPECT_EQ(Resource::Priority::Prefetch, test.fileSource.requests.front()->resource.priority);
+}
+
+class VectorTileObserver : public TileObserver {
+public:
+    VectorTileObserver(std::function<void ()> changed_) : changed(std::move(changed_)) {}
+
+    void onTileChanged(Tile&) override {
+        changed();
+    }
+
+private:
+    std::function<void ()> changed;
+};
+
+TEST(VectorTile, LayoutReuse) {
+    using namespace style;
+
+    VectorTileTest test;
+
+    auto line = std::make_unique<LineLayer>("line", "source");
+    line->setSourceLayer("admin");
+    test.style.addLayer(std::move(line));
+
+    auto fill = std::make_unique<FillLayer>("fill", "source");
+    fill->setSourceLayer("water");
+    test.style.addLayer(std::move(fill));
+
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTileObserver observer([&] { test.loop.stop(); });
+    tile.setObserver(&observer);
+
+    tile.setData(std::make_unique<VectorTileData>(
+        std::make_shared<std::string>(util::read_file("test/fixtures/map/offline/0-0-0.vector.pbf"))));
+    test.loop.run();
+
+    EXPECT_EQ(2u, tile.getRebuiltLayoutCount());
+    EXPECT_EQ(0u, tile.getReusedLayoutCount());
+    Bucket* lineBucket = tile.getBucket(*test.style.getLayer("line"));
+    ASSERT_TRUE(lineBucket);
+
+    // Paint properties don't affect layout; the tile keeps its buckets.
+    test.style.getLayer("line")->as<LineLayer>()->setLineColor(Color::red());
+    tile.redoLayout();
+    test.loop.run();
+
+    EXPECT_EQ(0u, tile.getRebuiltLayoutCount());
+    EXPECT_EQ(2u, tile.getReusedLayoutCount());
+    EXPECT_EQ(lineBucket, tile.getBucket(*test.style.getLayer("line")));
+
+    // A filter change only affects the filtered layer.
+    test.style.getLayer("line")->as<LineLayer>()->setFilter(HasFilter { "admin_level" });
+    tile.redoLayout();
+    test.loop.run();
+
+    EXPECT_EQ(1u, tile.getRebuiltLayoutCount());
+    EXPECT_EQ(1u, tile.getReusedLayoutCount());
+    EXPECT_TRUE(tile.getBucket(*test.style.getLayer("line")));
+}
+
+TEST(VectorTile, PlacementReuse) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, 0, 0, 0 });
+
+    const PlacementConfig first(0, 0);
+    const PlacementConfig second(PlacementConfig::angleStep, 0);
+    const PlacementConfig third(2 * PlacementConfig::angleStep, 0);
+
+    tile.setPlacementConfig(first);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(first), first, 1 });
+    tile.setPlacementConfig(second);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(second), second, 2 });
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(second, *tile.getPlacedConfig());
+
+    // While a placement for the third config runs, the map turns back to the first one, whose
+    // placement is reused.
+    tile.setPlacementConfig(third);
+    tile.setPlacementConfig(first);
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(first, *tile.getPlacedConfig());
+    EXPECT_TRUE(tile.isComplete());
+
+    // The placement for the third config arrives late, and is ignored.
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(third), third, 3 });
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(first, *tile.getPlacedConfig());
+    EXPECT_TRUE(tile.isComplete());
+
+    // Placements requested afterwards are accepted.
+    tile.setPlacementConfig(third);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(third), third, 5 });
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(third, *tile.getPlacedConfig());
+}
+
+TEST(VectorTile, PlacementReuseDuringLayout) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, 0, 0, 0 });
+
+    const PlacementConfig first(0, 0);
+    const PlacementConfig second(PlacementConfig::angleStep, 0);
+
+    tile.setPlacementConfig(first);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(first), first, 1 });
+    tile.setPlacementConfig(second);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(second), second, 2 });
+
+    // While a relayout runs, the map turns back to the first config, whose placement is reused.
+    tile.redoLayout();
+    tile.setPlacementConfig(first);
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(first, *tile.getPlacedConfig());
+    EXPECT_FALSE(tile.isComplete());
+
+    // The relayout was placed for the second config, so its placement is dropped, and the tile
+    // asks for a placement of the first config again.
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, 0, 0, 3 });
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(second), second, 3 });
+    EXPECT_FALSE(tile.getPlacedConfig());
+    EXPECT_FALSE(tile.isComplete());
+
+    tile.setPlacementConfig(first);
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(first), first, 5 });
+    ASSERT_TRUE(tile.getPlacedConfig());
+    EXPECT_EQ(first, *tile.getPlacedConfig());
+    EXPECT_TRUE(tile.isComplete());
+}
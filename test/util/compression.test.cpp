@@ -0,0 +1,102 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+namespace {
+
+std::string sample(uint32_t seed) {
+    std::string data;
+    for (uint32_t i = 0; i < 64; i++) {
+        data += "water;landuse;road;label=" + toString((seed * 7919 + i * 104729) % 10007) + ";";
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(Compression, Zlib) {
+    const std::string raw = sample(0);
+    const std::string compressed = compress(raw, Codec::Zlib);
+    EXPECT_LT(compressed.size(), raw.size());
+    EXPECT_EQ(raw, decompress(compressed, Codec::Zlib));
+
+    // Same format as the codec-less functions.
+    EXPECT_EQ(raw, decompress(compress(raw)));
+    EXPECT_EQ(raw, decompress(compressed));
+
+    EXPECT_THROW(decompress("not zlib", Codec::Zlib), std::runtime_error);
+
+    // The context of a thread is reset after a failure.
+    EXPECT_EQ(raw, decompress(compressed, Codec::Zlib));
+}
+
+TEST(Compression, None) {
+    EXPECT_EQ("raw", compress("raw", Codec::None));
+    EXPECT_EQ("raw", decompress("raw", Codec::None));
+}
+
+TEST(Compression, Threads) {
+    // Each thread uses contexts of its own.
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (std::size_t t = 0; t < results.size(); t++) {
+        threads.emplace_back([&, t] {
+            bool ok = true;
+            for (uint32_t i = 0; i < 100; i++) {
+                const std::string raw = sample(uint32_t(t * 100 + i));
+                ok = ok && decompress(compress(raw, Codec::Zlib), Codec::Zlib) == raw;
+            }
+            results[t] = ok;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(std::vector<int>(results.size(), 1), results);
+}
+
+TEST(Compression, Zstd) {
+    const std::string raw = sample(0);
+
+    if (!isSupported(Codec::Zstd)) {
+        EXPECT_THROW(compress(raw, Codec::Zstd), std::runtime_error);
+        EXPECT_TRUE(CompressionDictionary::train({ raw }, 1024).empty());
+        return;
+    }
+
+    const std::string compressed = compress(raw, Codec::Zstd);
+    EXPECT_LT(compressed.size(), raw.size());
+    EXPECT_EQ(raw, decompress(compressed, Codec::Zstd));
+    EXPECT_THROW(decompress("not zstd", Codec::Zstd), std::runtime_error);
+}
+
+TEST(Compression, ZstdDictionary) {
+    if (!isSupported(Codec::Zstd)) {
+        return;
+    }
+
+    std::vector<std::string> samples;
+    for (uint32_t i = 1; i <= 500; i++) {
+        samples.push_back(sample(i));
+    }
+
+    const std::string trained = CompressionDictionary::train(samples, 4096);
+    ASSERT_FALSE(trained.empty());
+    EXPECT_LE(trained.size(), 4096u);
+
+    const CompressionDictionary dictionary(trained);
+    const std::string raw = sample(0);
+    const std::string compressed = compress(raw, Codec::Zstd, &dictionary);
+    EXPECT_LT(compressed.size(), compress(raw, Codec::Zstd).size());
+    EXPECT_EQ(raw, decompress(compressed, Codec::Zstd, &dictionary));
+
+    // Data compressed with a dictionary can't be decompressed without it.
+    EXPECT_THROW(decompress(compressed, Codec::Zstd), std::runtime_error);
+}
@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<InternedSubfeature>;
+
+std::vector<std::size_t> queryIndices(const Grid& grid, const Grid::BBox& bbox) {
+    std::vector<std::size_t> result;
+    grid.query(bbox, [&] (std::size_t uid) {
+        result.push_back(uid);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST(GridIndex, Query) {
+    Grid grid(100, 10, 0);
+    grid.insert({ 0, 0, 0 }, { { 5, 5 }, { 15, 15 } });    // spans four cells
+    grid.insert({ 1, 0, 0 }, { { 55, 55 }, { 56, 56 } });
+    grid.insert({ 2, 0, 0 }, { { 0, 0 }, { 99, 99 } });    // spans every cell
+    grid.insert({ 3, 0, 0 }, { { 90, 10 }, { 95, 15 } });
+
+    const std::vector<std::size_t> all = { 0, 1, 2, 3 };
+    const std::vector<std::size_t> corner = { 0, 2 };
+    const std::vector<std::size_t> none = {};
+
+    // Before `build()`, every element is tested; after it, only those in the queried cells.
+    for (bool built : { false, true }) {
+        if (built) {
+            grid.build();
+        }
+
+        EXPECT_EQ(all, queryIndices(grid, { { 0, 0 }, { 100, 100 } }));
+        EXPECT_EQ(corner, queryIndices(grid, { { 8, 8 }, { 12, 12 } }));
+        EXPECT_EQ(corner, queryIndices(grid, { { 15, 15 }, { 20, 20 } }));
+        EXPECT_EQ(none, queryIndices(grid, { { 200, 200 }, { 300, 300 } }));
+    }
+
+    auto elements = grid.query({ { 50, 50 }, { 60, 60 } });
+    ASSERT_EQ(2u, elements.size());
+    EXPECT_EQ(1u, elements[0].index);
+    EXPECT_EQ(2u, elements[1].index);
+}
+
+TEST(GridIndex, InsertAfterBuild) {
+    Grid grid(100, 10, 0);
+    grid.insert({ 0, 0, 0 }, { { 5, 5 }, { 15, 15 } });
+    grid.build();
+    grid.insert({ 1, 0, 0 }, { { 10, 10 }, { 20, 20 } });
+
+    const std::vector<std::size_t> expected = { 0, 1 };
+    EXPECT_EQ(expected, queryIndices(grid, { { 0, 0 }, { 50, 50 } }));
+
+    grid.build();
+    EXPECT_EQ(expected, queryIndices(grid, { { 0, 0 }, { 50, 50 } }));
+}
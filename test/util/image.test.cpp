@@ -4,6 +4,9 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <stdexcept>
+#include <vector>
+
 using namespace mbgl;
 
 TEST(Image, PNGRoundTrip) {
@@ -99,3 +102,45 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(127, image.data[2]);
     EXPECT_EQ(128, image.data[3]);
 }
+
+TEST(Image, PremultiplyPixels) {
+    // Every color and alpha value, and a count that isn't a multiple of any vector width.
+    std::vector<uint8_t> pixels;
+    for (int a = 0; a < 256; a++) {
+        for (int c = 0; c < 256; c++) {
+            pixels.insert(pixels.end(), { uint8_t(c), uint8_t(255 - c), uint8_t(c * 7), uint8_t(a) });
+        }
+    }
+    pixels.insert(pixels.end(), { 200, 100, 50, 99 });
+    const std::size_t count = pixels.size() / 4;
+
+    std::vector<uint8_t> premultiplied = pixels;
+    util::premultiply(premultiplied.data(), count);
+
+    std::vector<uint8_t> unpremultiplied = pixels;
+    util::unpremultiply(unpremultiplied.data(), count);
+
+    for (std::size_t i = 0; i < pixels.size(); i++) {
+        const uint8_t a = pixels[i | 3];
+        const uint8_t c = pixels[i];
+        if ((i & 3) == 3) {
+            ASSERT_EQ(a, premultiplied[i]);
+            ASSERT_EQ(a, unpremultiplied[i]);
+        } else {
+            ASSERT_EQ(uint8_t((c * a + 127) / 255), premultiplied[i]) << "c=" << int(c) << " a=" << int(a);
+            ASSERT_EQ(a ? uint8_t((255 * c + (a / 2)) / a) : c, unpremultiplied[i]) << "c=" << int(c) << " a=" << int(a);
+        }
+    }
+}
+
+TEST(Image, PNGRoundTripTile) {
+    PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/tile.png"));
+    EXPECT_EQ(image, decodeImage(encodePNG(image)));
+}
+
+TEST(Image, JPEGTruncated) {
+    // Fails rather than reading past the end of the data.
+    std::string data = util::read_file("test/fixtures/image/tile.jpeg");
+    data.resize(data.size() / 2);
+    EXPECT_THROW(decodeImage(data), std::runtime_error);
+}
@@ -0,0 +1,56 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/image_pool.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(ImagePool, Reuse) {
+    util::ImagePool pool(1024 * 1024);
+
+    PremultipliedImage image = pool.acquire(256, 256);
+    ASSERT_TRUE(image.data);
+    const uint8_t* data = image.data.get();
+
+    pool.release(std::move(image));
+    EXPECT_FALSE(image.data);
+    EXPECT_EQ(256u * 256 * 4, pool.getBytes());
+
+    // Only images of the same dimensions reuse the buffer.
+    PremultipliedImage other = pool.acquire(256, 128);
+    EXPECT_NE(data, other.data.get());
+    EXPECT_EQ(256u * 256 * 4, pool.getBytes());
+
+    PremultipliedImage reused = pool.acquire(256, 256);
+    EXPECT_EQ(data, reused.data.get());
+    EXPECT_EQ(256u, reused.width);
+    EXPECT_EQ(256u, reused.height);
+    EXPECT_EQ(0u, pool.getBytes());
+}
+
+TEST(ImagePool, MaxBytes) {
+    util::ImagePool pool(256 * 256 * 4);
+
+    PremultipliedImage first = pool.acquire(256, 256);
+    PremultipliedImage second = pool.acquire(256, 256);
+    pool.release(std::move(first));
+    pool.release(std::move(second));
+    EXPECT_FALSE(second.data);
+    EXPECT_EQ(256u * 256 * 4, pool.getBytes());
+
+    pool.clear();
+    EXPECT_EQ(0u, pool.getBytes());
+}
+
+TEST(ImagePool, Decode) {
+    util::ImagePool pool(1024 * 1024);
+    const std::string png = util::read_file("test/fixtures/image/tile.png");
+
+    PremultipliedImage first = decodeImage(png, pool);
+    const uint8_t* data = first.data.get();
+    pool.release(std::move(first));
+
+    PremultipliedImage second = decodeImage(png, pool);
+    EXPECT_EQ(data, second.data.get());
+    EXPECT_TRUE(second == decodeImage(png));
+}
@@ -81,3 +81,30 @@ TEST(TileCover, SanFranciscoZ0Wrapped) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{ { 0, 1, 0 } }),
               util::tileCover(sanFranciscoWrapped, 0));
 }
+
+TEST(TileCover, TileCount) {
+    EXPECT_EQ(0u, util::tileCount(LatLngBounds::empty(), 0));
+    EXPECT_EQ(0u, util::tileCount(LatLngBounds::singleton({ 0, 0 }), 1));
+    EXPECT_EQ(0u, util::tileCount(LatLngBounds::hull({ 86, -180 }, { 90, 180 }), 0));
+    EXPECT_EQ(4u, util::tileCount(sanFrancisco, 10));
+    EXPECT_EQ(uint64_t(1) << 40, util::tileCount(LatLngBounds::world(), 20));
+
+    // The same as the size of the cover, including for bounds on tile boundaries and
+    // wrapped bounds.
+    const std::vector<LatLngBounds> bounds = {
+        LatLngBounds::world(),
+        sanFrancisco,
+        sanFranciscoWrapped,
+        LatLngBounds::hull({ -90, -180 }, { 0, 0 }),
+        LatLngBounds::hull({ 10, -90 }, { 45, 90 }),
+        LatLngBounds::hull({ -33.3, 151.1 }, { -33.1, 187.5 }),
+        LatLngBounds::hull({ 51.28, -0.51 }, { 51.69, 0.33 }),
+        LatLngBounds::hull({ 0, 0 }, { 0, 10 }),
+        LatLngBounds::hull({ -10, 5 }, { 10, 5 }),
+    };
+    for (const auto& bound : bounds) {
+        for (int32_t z = 0; z <= 8; z++) {
+            EXPECT_EQ(util::tileCover(bound, z).size(), util::tileCount(bound, z)) << z;
+        }
+    }
+}